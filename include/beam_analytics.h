@@ -0,0 +1,80 @@
+#ifndef BEAM_ANALYTICS_H
+#define BEAM_ANALYTICS_H
+
+#include <stdint.h>
+
+// Streaming beam-event analytics.
+// Consumes filtered beam transitions and keeps only fixed-size summaries:
+// a log2-bucketed dwell-time histogram, pass counts per class and per hour
+// of uptime, and the longest obstruction. Every update is O(1) and no raw
+// event list is kept in RAM.
+
+#define BEAM_DWELL_BUCKETS 24    // Bucket i holds dwells in [2^(i-1), 2^i) ms; last is open-ended
+#define BEAM_HOURLY_SLOTS 24     // Rolling window of per-hour counts
+
+// Pass classes from obstruction length (thresholds in config.h)
+enum BeamPassClass {
+    BEAM_PASS_GLITCH,    // Shorter than BEAM_CLASS_GLITCH_MAX_MS
+    BEAM_PASS_PERSON,    // Up to BEAM_CLASS_PERSON_MAX_MS
+    BEAM_PASS_CAR,       // Up to BEAM_CLASS_CAR_MAX_MS
+    BEAM_PASS_DOOR,      // Longer: door panel lowered across the beam
+    BEAM_PASS_CLASS_COUNT
+};
+
+struct BeamClassThresholds {
+    uint32_t glitchMaxMs;
+    uint32_t personMaxMs;
+    uint32_t carMaxMs;
+};
+
+class BeamAnalytics {
+public:
+    explicit BeamAnalytics(const BeamClassThresholds& thresholds);
+
+    // Feed a filtered transition (timestamp in millis())
+    void recordTransition(bool beamBroken, uint32_t timestampMs);
+
+    // Dwell histogram
+    uint32_t getDwellBucket(int bucket) const { return dwellHistogram[bucket]; }
+    static uint32_t dwellBucketUpperMs(int bucket);   // Exclusive bound, 0 = open-ended
+    static int dwellBucketFor(uint32_t dwellMs);
+
+    // Pass classification
+    uint32_t getClassCount(BeamPassClass passClass) const { return classCounts[passClass]; }
+    BeamPassClass classify(uint32_t dwellMs) const;
+    static const char* className(BeamPassClass passClass);
+
+    // Passes completed during the hour 'hoursAgo' hours before nowMs (0 = current hour)
+    uint32_t getHourlyCount(uint32_t nowMs, int hoursAgo) const;
+
+    uint32_t getPassCount() const { return passCount; }
+    uint32_t getLongestDwellMs() const { return longestDwellMs; }
+    uint32_t getLongestDwellEndMs() const { return longestDwellEndMs; }
+    uint64_t getTotalDwellMs() const { return totalDwellMs; }
+
+    // Current obstruction, if any
+    bool isObstructed() const { return obstructed; }
+    uint32_t getObstructionStartMs() const { return obstructionStartMs; }
+
+    void reset();
+
+private:
+    BeamClassThresholds thresholds;
+
+    uint32_t dwellHistogram[BEAM_DWELL_BUCKETS];
+    uint32_t classCounts[BEAM_PASS_CLASS_COUNT];
+    uint32_t hourlyCounts[BEAM_HOURLY_SLOTS];
+    uint32_t hourlyStamp[BEAM_HOURLY_SLOTS];   // Uptime hour each slot belongs to
+
+    uint32_t passCount;
+    uint32_t longestDwellMs;
+    uint32_t longestDwellEndMs;
+    uint64_t totalDwellMs;
+
+    bool obstructed;
+    uint32_t obstructionStartMs;
+};
+
+extern BeamAnalytics beamAnalytics;
+
+#endif // BEAM_ANALYTICS_H
@@ -0,0 +1,82 @@
+#ifndef BEAM_EDGE_QUEUE_H
+#define BEAM_EDGE_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// One transition seen on the E3JK-RR11 input
+struct BeamEdge {
+  uint32_t timestampUs;   // micros() when the interrupt fired
+  bool beamBroken;        // Beam state after the edge (true = broken)
+};
+
+// Fixed-size single-producer/single-consumer ring buffer for beam edges.
+// The E3JK-RR11 interrupt is the only producer and the main loop the only
+// consumer, so head and tail are each written by one side only and no lock
+// is needed. Capacity must be a power of two so indices can wrap freely.
+template <size_t Capacity>
+class BeamEdgeQueue {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "BeamEdgeQueue capacity must be a power of two");
+
+public:
+  // Producer side (ISR). Returns false and counts an overflow when full.
+  inline bool push(uint32_t timestampUs, bool beamBroken) {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    uint32_t tail = tail_.load(std::memory_order_acquire);
+    uint32_t used = head - tail;
+
+    if (used >= Capacity) {
+      overflowCount_.store(overflowCount_.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+      return false;
+    }
+
+    BeamEdge& slot = buffer_[head & (Capacity - 1)];
+    slot.timestampUs = timestampUs;
+    slot.beamBroken = beamBroken;
+    head_.store(head + 1, std::memory_order_release);
+
+    pushCount_.store(pushCount_.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
+    if (used + 1 > highWater_.load(std::memory_order_relaxed)) {
+      highWater_.store(used + 1, std::memory_order_relaxed);
+    }
+    return true;
+  }
+
+  // Consumer side (main loop). Returns false when the queue is empty.
+  bool pop(BeamEdge& edge) {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    uint32_t head = head_.load(std::memory_order_acquire);
+    if (tail == head) {
+      return false;
+    }
+
+    edge = buffer_[tail & (Capacity - 1)];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t size() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+
+  static size_t capacity() { return Capacity; }
+
+  // Statistics (monotonic since boot)
+  uint32_t pushCount() const { return pushCount_.load(std::memory_order_relaxed); }
+  uint32_t overflowCount() const { return overflowCount_.load(std::memory_order_relaxed); }
+  uint32_t highWater() const { return highWater_.load(std::memory_order_relaxed); }
+
+private:
+  BeamEdge buffer_[Capacity];
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};
+  std::atomic<uint32_t> pushCount_{0};
+  std::atomic<uint32_t> overflowCount_{0};
+  std::atomic<uint32_t> highWater_{0};
+};
+
+#endif // BEAM_EDGE_QUEUE_H
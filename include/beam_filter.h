@@ -0,0 +1,107 @@
+#ifndef BEAM_FILTER_H
+#define BEAM_FILTER_H
+
+#include <stdint.h>
+
+// Glitch filter between raw E3JK-RR11 edges and the reported beam state.
+// Raw edges (with ISR timestamps) go in through processEdge(), time moves
+// forward through advance(), and every filtered state change is reported
+// through the callback with the timestamp of the raw edge that started the
+// new level, so filter delay does not skew event times. All decisions are
+// made on the edge timestamps, so results do not depend on how often the
+// main loop drains the queue. No hardware dependencies.
+//
+// Modes:
+//   LOCKOUT     Accept a change immediately, then ignore further changes for
+//               lockoutUs. If the raw level still differs when the lockout
+//               ends, that level is applied, so the edge that ends a glitch
+//               is never lost.
+//   INTEGRATOR  A counter moves up while the beam is broken and down while it
+//               is clear, clamped to [0, integrateUs]. The output switches at
+//               either limit.
+//   MAJORITY    The raw level is sampled every sampleUs. The output switches
+//               when at least majorityN of the last majorityM samples agree.
+
+enum BeamFilterMode {
+    BEAM_FILTER_LOCKOUT,
+    BEAM_FILTER_INTEGRATOR,
+    BEAM_FILTER_MAJORITY
+};
+
+#define BEAM_FILTER_MAX_WINDOW 32   // Largest majorityM
+
+// Upper limits for the time parameters accepted from the API
+#define BEAM_FILTER_MAX_LOCKOUT_US 10000000UL   // 10 s
+#define BEAM_FILTER_MAX_INTEGRATE_US 10000000UL // 10 s
+#define BEAM_FILTER_MAX_SAMPLE_US 1000000UL     // 1 s
+
+struct BeamFilterConfig {
+    BeamFilterMode mode;
+    uint32_t lockoutUs;     // LOCKOUT hold-off after an accepted change
+    uint32_t integrateUs;   // INTEGRATOR full-scale time
+    uint32_t sampleUs;      // MAJORITY sample period
+    uint8_t majorityN;      // MAJORITY agreeing samples required
+    uint8_t majorityM;      // MAJORITY window length (1..32)
+};
+
+struct BeamFilterStats {
+    uint32_t rawEdges;          // Raw level changes seen
+    uint32_t acceptedChanges;   // Filtered state changes reported
+    uint32_t rejectedGlitches;  // Raw excursions that reverted without a state change
+};
+
+typedef void (*BeamFilterCallback)(bool beamBroken, uint32_t timestampUs);
+
+class BeamFilter {
+public:
+    explicit BeamFilter(BeamFilterCallback callback) : callback(callback) {}
+
+    // Apply a configuration and restart from a known state. Parameters are
+    // clamped to usable values; the applied configuration is returned.
+    BeamFilterConfig configure(const BeamFilterConfig& config, bool beamBroken, uint32_t nowUs);
+
+    // Feed one raw edge (the raw level after the edge)
+    void processEdge(uint32_t timestampUs, bool rawBroken);
+
+    // Settle time-based decisions up to nowUs
+    void advance(uint32_t nowUs);
+
+    bool getState() const { return output; }
+    bool getRawState() const { return raw; }
+    const BeamFilterConfig& getConfig() const { return config; }
+    const BeamFilterStats& getStats() const { return stats; }
+    void resetStats();
+
+    static const char* modeName(BeamFilterMode mode);
+    static bool parseMode(const char* name, BeamFilterMode& mode);
+
+private:
+    BeamFilterCallback callback;
+    BeamFilterConfig config = {BEAM_FILTER_LOCKOUT, 50000, 20000, 5000, 4, 5};
+    BeamFilterStats stats = {0, 0, 0};
+
+    bool output = false;        // Filtered state
+    bool raw = false;           // Latest raw level
+    bool deviating = false;     // Raw has differed from output since the last change
+    uint32_t lastTimeUs = 0;    // Time the filter has been advanced to
+    uint32_t lastRawEdgeUs = 0;
+
+    // LOCKOUT
+    uint32_t lockoutUntilUs = 0;
+    bool lockoutActive = false;
+
+    // INTEGRATOR
+    uint32_t integrator = 0;
+
+    // MAJORITY
+    uint32_t window = 0;        // One bit per sample, bit 0 = newest
+    uint8_t windowFill = 0;
+    uint32_t nextSampleUs = 0;
+
+    void setOutput(bool state, uint32_t timestampUs);
+    void advanceLockout(uint32_t nowUs);
+    void advanceIntegrator(uint32_t nowUs);
+    void advanceMajority(uint32_t nowUs);
+};
+
+#endif // BEAM_FILTER_H
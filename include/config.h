@@ -18,8 +18,16 @@
 // #define ENABLE_SIMULATION_MODE    // Enable for testing without hardware (DISABLED)
 #define SIMULATION_BEAM_INTERVAL 10000  // Simulate beam break every 10 seconds
 
-// Sensor Configuration
-#define SENSOR_READ_INTERVAL 200  // Read sensors every 200ms for faster LED response
+// Scheduler Configuration (see scheduler.h)
+#define BEAM_DRAIN_INTERVAL_US 1000      // Drain the E3JK-RR11 edge queue every 1ms
+#define ENV_SENSOR_READ_INTERVAL 2000    // DHT22/BMP280/analog every 2s (DHT22 minimum)
+#define DHT22_POLL_INTERVAL_US 1000      // Step the non-blocking DHT22 state machine every 1ms
+#define WIFI_POLL_INTERVAL 100           // Step the non-blocking WiFi state machine every 100ms
+#define HISTORY_SAMPLE_INTERVAL 10000    // Append temperature/humidity to history every 10s (history.sample_interval_ms)
+
+// Environment history buffer (see environment_history.h)
+#define HISTORY_BUFFER_BYTES 98304       // PSRAM: <= 1.22 bytes/sample measured, 9+ days at 10s
+#define HISTORY_FALLBACK_BYTES 8192      // Internal RAM when no PSRAM is found
 
 // GPIO Pin Definitions for ESP32 S3 Nano
 #define E3JK_RR11_PIN 4            // E3JK-RR11 photoelectric sensor digital output - GPIO 4
@@ -36,15 +44,32 @@
 // #define ENABLE_ANALOG_SENSOR   // Uncomment for additional analog input
 
 // E3JK-RR11 Configuration
-#define E3JK_DEBOUNCE_TIME 50     // Debounce time in milliseconds
+// Glitch filter defaults (see beam_filter.h); set at runtime via /api/beam/filter
+// or the "beam.*" keys of /api/config, and kept in NVS
+#define E3JK_FILTER_MODE BEAM_FILTER_LOCKOUT  // LOCKOUT, INTEGRATOR or MAJORITY
+#define E3JK_DEBOUNCE_TIME 50     // LOCKOUT hold-off in milliseconds
+#define E3JK_INTEGRATE_US 20000   // INTEGRATOR full-scale time in microseconds
+#define E3JK_MAJORITY_SAMPLE_US 5000  // MAJORITY sample period in microseconds
+#define E3JK_MAJORITY_N 4         // MAJORITY: N of the last M samples must agree
+#define E3JK_MAJORITY_M 5
+#define E3JK_EDGE_QUEUE_SIZE 64   // ISR edge ring buffer slots (power of two)
 #define E3JK_BEAM_BROKEN LOW      // LOW = beam broken (object detected), HIGH = beam clear
 #define E3JK_BEAM_CLEAR HIGH      // HIGH = beam clear (no object), LOW = beam broken
 
+// Beam pass classification by obstruction length (see beam_analytics.h)
+#define BEAM_CLASS_GLITCH_MAX_MS 50       // Shorter obstructions are glitches
+#define BEAM_CLASS_PERSON_MAX_MS 1500     // Person walking through the beam
+#define BEAM_CLASS_CAR_MAX_MS 30000       // Car driving through; longer = door panel
+
 // LED Control for beam status
 #define LED_ON_BEAM_BROKEN true   // Turn LED ON when beam is broken
 #define LED_OFF_BEAM_CLEAR true   // Turn LED OFF when beam is clear
 
-// Debugging
-#define DEBUG_SENSORS true
+// Logging (see system_log.h)
+// Call sites below this level are removed at compile time;
+// LOG_LEVEL_DEBUG includes a line per sensor reading
+#define LOG_COMPILE_LEVEL LOG_LEVEL_DEBUG
+#define LOG_QUEUE_SIZE 64                // Deferred entries waiting to be formatted
+#define LOG_FLUSH_INTERVAL_MS 20         // Background log task wake-up period
 
 #endif // CONFIG_H
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// Runtime settings kept in NVS, with the compile-time macros from config.h,
+// wifi_config.h and ota_config.h as defaults. Values live in a RAM cache,
+// so reads never touch flash. set() only marks a key dirty when its value
+// changes; commit() writes the dirty keys in one batch and skips any whose
+// NVS value already matches, so unchanged settings cost no flash wear.
+// Keys keep the NVS namespace and name their module used before, so
+// existing saved values (e.g. WiFi credentials) carry over.
+//
+// Safe to use from any task. getGeneration() changes whenever a value
+// does, so modules can re-read their settings cheaply.
+
+enum ConfigType {
+    CONFIG_UINT,
+    CONFIG_BOOL,
+    CONFIG_STRING
+};
+
+enum ConfigKey {
+    CONFIG_WIFI_SSID,
+    CONFIG_WIFI_PASSWORD,
+    CONFIG_WIFI_CONNECT_TIMEOUT,
+    CONFIG_WIFI_BACKOFF_MIN,
+    CONFIG_WIFI_BACKOFF_MAX,
+    CONFIG_WIFI_FAST_RECONNECT,
+    CONFIG_OTA_CHECK_INTERVAL,
+    CONFIG_OTA_BACKOFF_MAX,
+    CONFIG_OTA_RESUME_ATTEMPTS,
+    CONFIG_BEAM_FILTER_MODE,
+    CONFIG_BEAM_LOCKOUT_US,
+    CONFIG_BEAM_INTEGRATE_US,
+    CONFIG_BEAM_SAMPLE_US,
+    CONFIG_BEAM_MAJORITY_N,
+    CONFIG_BEAM_MAJORITY_M,
+    CONFIG_HISTORY_SAMPLE_INTERVAL,
+    CONFIG_KEY_COUNT
+};
+
+struct ConfigEntry {
+    const char* name;           // API name, e.g. "ota.check_interval_ms"
+    const char* nvsNamespace;
+    const char* nvsKey;         // At most 15 characters
+    ConfigType type;
+    uint32_t defaultValue;      // CONFIG_UINT and CONFIG_BOOL
+    const char* defaultString;  // CONFIG_STRING
+    uint32_t min;               // Value range, or string length range
+    uint32_t max;
+    bool secret;                // Never reported back by the API
+};
+
+struct ConfigStoreStats {
+    uint32_t setRequests;       // set() calls, including rejected values
+    uint32_t changes;           // set() calls that changed a value
+    uint32_t commits;           // commit() calls with dirty keys
+    uint32_t nvsWrites;         // Keys actually written to NVS
+    uint32_t nvsSkipped;        // Dirty keys already equal in NVS
+};
+
+class ConfigStore {
+public:
+    // Load every key from NVS, falling back to its default
+    void begin();
+
+    static const ConfigEntry& entry(ConfigKey key);
+    // CONFIG_KEY_COUNT if there is no key with that API name
+    static ConfigKey find(const char* name);
+    // Would set() take this value? (type, range or length)
+    static bool accepts(ConfigKey key, uint32_t value);
+    static bool accepts(ConfigKey key, const String& value);
+
+    uint32_t getUInt(ConfigKey key);
+    bool getBool(ConfigKey key) { return getUInt(key) != 0; }
+    String getString(ConfigKey key);
+
+    // False if the key has another type or the value is out of range
+    bool set(ConfigKey key, uint32_t value);
+    bool set(ConfigKey key, const String& value);
+    // Write dirty keys to NVS; returns the number actually written
+    uint32_t commit();
+
+    bool isDirty() const { return dirty != 0; }
+    uint32_t getGeneration() const { return generation; }
+    ConfigStoreStats getStats();
+
+private:
+    void lock();
+    void unlock();
+
+    SemaphoreHandle_t mutex = nullptr;
+    uint32_t values[CONFIG_KEY_COUNT] = {};
+    String strings[CONFIG_KEY_COUNT];
+    uint32_t dirty = 0;         // Bit per ConfigKey
+    volatile uint32_t generation = 0;
+    ConfigStoreStats stats = {};
+};
+
+extern ConfigStore configStore;
+
+#endif // CONFIG_STORE_H
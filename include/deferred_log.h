@@ -0,0 +1,81 @@
+#ifndef DEFERRED_LOG_H
+#define DEFERRED_LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "log_ring.h"
+
+// Binary log entries for deferred formatting.
+// A call site records the address of its format string (a literal, so the
+// pointer doubles as the message ID) and its raw arguments; the text is
+// only produced later by formatDeferredLog(), off the hot path. Arguments
+// are captured by value, so only scalars and strings with static lifetime
+// (literals, name tables) may be passed. Anything transient, such as a
+// String's c_str(), must go through addLogEntryf() instead. No hardware
+// dependencies.
+
+#define DEFERRED_LOG_MAX_ARGS 6
+
+enum DeferredLogArgType {
+    LOG_ARG_INT,
+    LOG_ARG_UINT,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_STRING
+};
+
+union DeferredLogArg {
+    int64_t i;
+    uint64_t u;
+    double d;
+    const char* s;
+};
+
+struct DeferredLogEntry {
+    const char* format;
+    uint64_t timestampUs;
+    uint8_t level;
+    uint8_t argCount;
+    uint8_t types[DEFERRED_LOG_MAX_ARGS];
+    DeferredLogArg args[DEFERRED_LOG_MAX_ARGS];
+};
+
+// Argument capture: one overload per fundamental type, so the fixed-width
+// typedefs of any toolchain resolve without ambiguity
+inline void setLogArgInt(DeferredLogEntry& entry, long long value) {
+    entry.types[entry.argCount] = LOG_ARG_INT;
+    entry.args[entry.argCount++].i = value;
+}
+inline void setLogArgUint(DeferredLogEntry& entry, unsigned long long value) {
+    entry.types[entry.argCount] = LOG_ARG_UINT;
+    entry.args[entry.argCount++].u = value;
+}
+inline void setLogArg(DeferredLogEntry& entry, int value) { setLogArgInt(entry, value); }
+inline void setLogArg(DeferredLogEntry& entry, long value) { setLogArgInt(entry, value); }
+inline void setLogArg(DeferredLogEntry& entry, long long value) { setLogArgInt(entry, value); }
+inline void setLogArg(DeferredLogEntry& entry, bool value) { setLogArgInt(entry, value); }
+inline void setLogArg(DeferredLogEntry& entry, unsigned value) { setLogArgUint(entry, value); }
+inline void setLogArg(DeferredLogEntry& entry, unsigned long value) { setLogArgUint(entry, value); }
+inline void setLogArg(DeferredLogEntry& entry, unsigned long long value) { setLogArgUint(entry, value); }
+inline void setLogArg(DeferredLogEntry& entry, double value) {
+    entry.types[entry.argCount] = LOG_ARG_DOUBLE;
+    entry.args[entry.argCount++].d = value;
+}
+inline void setLogArg(DeferredLogEntry& entry, float value) { setLogArg(entry, (double)value); }
+inline void setLogArg(DeferredLogEntry& entry, const char* value) {
+    entry.types[entry.argCount] = LOG_ARG_STRING;
+    entry.args[entry.argCount++].s = value;
+}
+
+inline void packLogArgs(DeferredLogEntry&) {}
+
+template <typename First, typename... Rest>
+inline void packLogArgs(DeferredLogEntry& entry, First first, Rest... rest) {
+    setLogArg(entry, first);
+    packLogArgs(entry, rest...);
+}
+
+// Produce the text for an entry (printf conversions; '*' widths are not
+// supported). Returns the length written, truncated to size - 1.
+size_t formatDeferredLog(const DeferredLogEntry& entry, char* buffer, size_t size);
+
+#endif // DEFERRED_LOG_H
@@ -0,0 +1,45 @@
+#ifndef DHT22_DECODER_H
+#define DHT22_DECODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// DHT22 40-bit frame decoder working on captured edge timestamps.
+// It has no hardware dependencies so recorded pulse trains can be decoded
+// on a host as well as on the ESP32.
+//
+// Frame after the host start pulse:
+//   response  ~80us low, ~80us high
+//   40 bits   ~50us low, then ~26us high (0) or ~70us high (1)
+//   trailer   ~50us low, then the line is released high
+// Only high-pulse widths are used, so the start-pulse release edge and ISR
+// latency on the low phases do not matter.
+
+#define DHT22_FRAME_BITS 40
+#define DHT22_BIT_THRESHOLD_US 48     // High pulse longer than this is a '1'
+#define DHT22_MAX_HIGH_PULSE_US 110   // Anything longer is not a valid bit
+#define DHT22_MAX_EDGES 96            // Capture buffer size (a frame has ~84)
+
+enum Dht22DecodeResult {
+    DHT22_DECODE_OK,
+    DHT22_DECODE_TOO_FEW_EDGES,
+    DHT22_DECODE_BAD_PULSE,
+    DHT22_DECODE_CHECKSUM
+};
+
+struct Dht22Reading {
+    float temperature;   // Degrees C
+    float humidity;      // Percent RH
+};
+
+// Decode a frame from edge timestamps (microseconds) and the line level
+// after each edge (true = high). Edges must be in capture order.
+Dht22DecodeResult dht22DecodeEdges(const uint32_t* edgeTimesUs, const bool* edgeLevels,
+                                   size_t edgeCount, Dht22Reading& reading);
+
+// Convert the five raw frame bytes; returns false on checksum mismatch
+bool dht22DecodeBytes(const uint8_t bytes[5], Dht22Reading& reading);
+
+const char* dht22DecodeResultString(Dht22DecodeResult result);
+
+#endif // DHT22_DECODER_H
@@ -0,0 +1,73 @@
+#ifndef DHT22_DRIVER_H
+#define DHT22_DRIVER_H
+
+#include <Arduino.h>
+#include "dht22_decoder.h"
+
+// Non-blocking DHT22 driver.
+// Instead of bit-banging the 40-bit frame with interrupts disabled (as the
+// Adafruit library does), poll() steps a small state machine: drive the
+// start pulse, then capture every line edge with a GPIO interrupt and
+// decode the timestamps once the frame window has passed. No step blocks
+// for more than a few microseconds, and the beam ISR keeps running.
+// Between physical reads the last good reading is cached together with the
+// time it was taken.
+
+#define DHT22_SAMPLE_INTERVAL 2000    // Minimum time between reads (ms)
+#define DHT22_STARTUP_DELAY 2000      // Sensor settling time after power-up (ms)
+#define DHT22_START_PULSE_US 1100     // Host start pulse (datasheet: >= 1ms)
+#define DHT22_CAPTURE_WINDOW_US 6000  // Full frame takes ~4.5ms
+#define DHT22_STALE_AFTER 10000       // Cached reading considered stale (ms)
+
+enum DHT22DriverState {
+    DHT22_STATE_IDLE,
+    DHT22_STATE_START_PULSE,
+    DHT22_STATE_CAPTURING
+};
+
+class DHT22Driver {
+public:
+    explicit DHT22Driver(uint8_t pin) : pin(pin) {}
+
+    void begin();
+
+    // Advance the state machine; call at least every millisecond
+    void poll();
+
+    // Cached result of the last successful read
+    bool hasReading() const { return readingCount > 0; }
+    const Dht22Reading& getReading() const { return lastReading; }
+    unsigned long getReadingTime() const { return lastReadingTime; }   // millis()
+    unsigned long getReadingAge() const { return millis() - lastReadingTime; }
+    bool isStale() const { return !hasReading() || getReadingAge() > DHT22_STALE_AFTER; }
+
+    // Statistics
+    uint32_t getReadingCount() const { return readingCount; }
+    uint32_t getErrorCount() const { return errorCount; }
+    Dht22DecodeResult getLastResult() const { return lastResult; }
+
+    // Edge capture (called from the GPIO interrupt)
+    void IRAM_ATTR captureEdge();
+
+private:
+    uint8_t pin;
+    DHT22DriverState state = DHT22_STATE_IDLE;
+    unsigned long lastStartTime = 0;    // millis() of the last read attempt
+    uint32_t phaseStartUs = 0;
+
+    volatile uint32_t edgeTimes[DHT22_MAX_EDGES];
+    volatile bool edgeLevels[DHT22_MAX_EDGES];
+    volatile uint8_t edgeCount = 0;
+
+    Dht22Reading lastReading = {0, 0};
+    unsigned long lastReadingTime = 0;
+    uint32_t readingCount = 0;
+    uint32_t errorCount = 0;
+    Dht22DecodeResult lastResult = DHT22_DECODE_OK;
+
+    void finishCapture();
+};
+
+extern DHT22Driver dht22Driver;
+
+#endif // DHT22_DRIVER_H
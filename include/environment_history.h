@@ -0,0 +1,45 @@
+#ifndef ENVIRONMENT_HISTORY_H
+#define ENVIRONMENT_HISTORY_H
+
+#include <Arduino.h>
+#include "timeseries_store.h"
+#include "rollup_engine.h"
+
+// Temperature/humidity history kept on the device in a compressed
+// time-series store (see timeseries_store.h), plus minute/hour/day rollups
+// of every environmental reading (see rollup_engine.h) for charting long
+// ranges. Buffers are taken from PSRAM when the board has it; timestamps
+// are seconds of uptime.
+//
+// Readings are recorded on the sensor loop and read by the web server task,
+// so other tasks go through the query functions below, which hold the
+// history lock while the visitor runs. Visitors should only copy data out.
+
+#define HISTORY_SERIES_TEMPERATURE 0
+#define HISTORY_SERIES_HUMIDITY 1
+
+// Seconds since boot, the timebase of every history timestamp. Taken from
+// the 64-bit esp_timer: millis() / 1000 wraps after ~49.7 days, and the
+// store refuses timestamps that go backwards.
+uint32_t environmentHistoryTime();
+
+// Allocate the store and rollups; returns false if no memory could be allocated
+bool initEnvironmentHistory();
+
+// Scheduler job: append the current reading if it is valid and fresh
+void recordEnvironmentHistory();
+
+// Fold a new sensor reading into the rollups (called as readings arrive)
+void recordEnvironmentRollup(RollupSeries series, float value);
+
+// Locked access for other tasks
+uint32_t queryEnvironmentHistory(uint32_t from, uint32_t to, TimeSeriesVisitor visitor, void* context);
+TimeSeriesStats getEnvironmentHistoryStats();
+uint32_t queryEnvironmentRollups(RollupResolution resolution, uint32_t from, uint32_t to,
+                                 RollupVisitor visitor, void* context);
+RollupResolution selectEnvironmentRollupResolution(uint32_t from, uint32_t to, uint32_t points);
+
+extern TimeSeriesStore environmentHistory;
+extern RollupEngine environmentRollups;
+
+#endif // ENVIRONMENT_HISTORY_H
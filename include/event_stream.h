@@ -0,0 +1,52 @@
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Server-Sent Events push channel (GET /api/events).
+// Each subscriber owns a fixed-size output buffer. Publishing formats the
+// event once, appends it to every buffer and pushes what the socket will
+// take right away with non-blocking sends, so a publish never waits on the
+// network. A client whose buffer cannot take a new event, or that makes no
+// progress for SSE_STALL_TIMEOUT_MS, is disconnected rather than allowed to
+// hold anything up.
+//
+// Event types:
+//   beam         {"broken":true,"time_ms":123456}
+//   environment  {"temperature":21.5,"humidity":48.0,"time_ms":123456}
+//   ota          {"status":0,"update_available":false,"latest":"...","message":"..."}
+
+#define SSE_MAX_CLIENTS 4
+#define SSE_CLIENT_BUFFER_BYTES 1024
+#define SSE_STALL_TIMEOUT_MS 5000     // Evict a client whose socket accepts nothing for this long
+#define SSE_KEEPALIVE_MS 15000        // Comment line to keep proxies open and detect dead peers
+
+struct EventStreamStats {
+    uint8_t clients;
+    uint32_t connected;             // Subscriptions accepted since boot
+    uint32_t rejected;              // Refused because all slots were in use
+    uint32_t evicted;               // Dropped for overflow or stalling
+    uint32_t published;
+};
+
+#ifdef ENABLE_WIFI
+// Create the lock shared by publishers and the HTTP task; call before the
+// web server starts
+void initEventStream();
+
+// Take over the current HTTP connection as a subscriber (route handler)
+void acceptEventStreamClient();
+
+// HTTP task: flush buffers, evict stalled clients, send keepalives
+void serviceEventStream();
+
+EventStreamStats getEventStreamStats();
+#endif
+
+// Publishers (no-ops when WiFi is disabled)
+void publishBeamEvent(bool beamBroken, uint32_t timestampMs);
+void publishEnvironmentEvent(float temperature, float humidity, uint32_t timestampMs);
+void publishOTAEvent();
+
+#endif // EVENT_STREAM_H
@@ -0,0 +1,98 @@
+#ifndef HISTORY_BATCHES_H
+#define HISTORY_BATCHES_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "timeseries_store.h"
+#include "rollup_engine.h"
+
+// Paging over history and rollup queries with a fixed-size batch.
+// Each query fills at most HISTORY_BATCH_ITEMS entries (copied out under
+// the history lock, formatted after it is released), and the next one
+// resumes at the first time that can hold an entry not yet seen: one
+// second after the last raw sample, or one bucket width after the last
+// bucket start (a rollup query rounds 'from' down to its bucket, so
+// resuming one second later would return the last bucket again).
+// No hardware dependencies.
+
+#define HISTORY_BATCH_ITEMS 32
+
+template <typename Item>
+struct HistoryBatch {
+    Item items[HISTORY_BATCH_ITEMS];
+    size_t count;
+};
+
+template <typename Item>
+bool collectHistoryItem(const Item& item, void* context) {
+    HistoryBatch<Item>& batch = *static_cast<HistoryBatch<Item>*>(context);
+    batch.items[batch.count++] = item;
+    return batch.count < HISTORY_BATCH_ITEMS;  // Stop the scan when full
+}
+
+inline uint32_t historyItemTime(const TimeSeriesSample& sample) { return sample.timestamp; }
+inline uint32_t historyItemTime(const RollupBucket& bucket) { return bucket.start; }
+
+// Position in a paged query, so a streamed response can take one entry
+// at a time as the client reads. 'step' is the spacing of entry times:
+// 1 for raw samples, RollupEngine::widthSeconds() for buckets.
+template <typename Item>
+struct HistoryCursor {
+    HistoryBatch<Item> batch;
+    size_t next;                // Next entry of the batch to hand out
+    uint32_t from;              // Where the next query starts
+    uint32_t step;
+    bool more;                  // Another query may find entries
+};
+
+template <typename Item>
+void beginHistoryCursor(HistoryCursor<Item>& cursor, uint32_t from, uint32_t step) {
+    cursor.batch.count = 0;
+    cursor.next = 0;
+    cursor.from = from;
+    cursor.step = step;
+    cursor.more = true;
+}
+
+// Hand out the next entry, running 'query(from, visitor, batch)' when the
+// batch is used up; null once there are no more
+template <typename Item, typename Query>
+const Item* nextHistoryItem(HistoryCursor<Item>& cursor, Query query) {
+    if (cursor.next == cursor.batch.count) {
+        if (!cursor.more) {
+            return nullptr;
+        }
+        cursor.batch.count = 0;
+        cursor.next = 0;
+        query(cursor.from, collectHistoryItem<Item>, &cursor.batch);
+        cursor.more = cursor.batch.count == HISTORY_BATCH_ITEMS;
+        if (cursor.more) {
+            uint32_t last = historyItemTime(cursor.batch.items[cursor.batch.count - 1]);
+            cursor.more = last <= UINT32_MAX - cursor.step;  // Nothing can follow the end of time
+            cursor.from = last + cursor.step;
+        }
+        if (cursor.batch.count == 0) {
+            return nullptr;
+        }
+    }
+    return &cursor.batch.items[cursor.next++];
+}
+
+// Page through the whole range, handing every entry to 'append'. Returns
+// the number of entries.
+template <typename Item, typename Query>
+uint32_t forEachHistoryBatch(uint32_t from, uint32_t step, Query query,
+                             bool (*append)(const Item&, void*), void* context) {
+    HistoryCursor<Item>* cursor = new HistoryCursor<Item>();
+    beginHistoryCursor(*cursor, from, step);
+    uint32_t total = 0;
+    const Item* item;
+    while ((item = nextHistoryItem(*cursor, query)) != nullptr) {
+        append(*item, context);
+        total++;
+    }
+    delete cursor;
+    return total;
+}
+
+#endif // HISTORY_BATCHES_H
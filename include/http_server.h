@@ -0,0 +1,211 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <Arduino.h>
+#include "metrics.h"
+
+// Multi-connection HTTP/1.1 server on lwIP sockets.
+// poll() runs one select() round over the listening socket and every open
+// connection: it accepts new clients, reads whatever has arrived,
+// dispatches complete requests and sends pending response bytes, so
+// several clients are serviced side by side. Connections are kept alive
+// between requests and closed after HTTP_KEEPALIVE_TIMEOUT_MS idle, or
+// with 408 when a started request is not complete within
+// HTTP_REQUEST_TIMEOUT_MS. It is meant to be driven from its own task.
+//
+// Nothing ever waits on a socket. A handler's output is queued on its
+// connection (HTTP_OUTPUT_BUFFER_BYTES, then heap for the rare larger
+// body) and send_P() bodies are sent in place from flash; poll() pushes
+// what each socket will take with non-blocking sends, as event_stream.cpp
+// does. Long bodies use sendStream(): poll() calls the fill function
+// whenever the client has taken enough to make room, so a response of any
+// size needs no more than the output buffer. A client that takes nothing
+// for HTTP_STALL_TIMEOUT_MS is disconnected; until then it only delays
+// its own response. The next request on a connection is read once the
+// previous response has been sent.
+//
+// The request/response calls mirror the subset of the Arduino WebServer
+// API the firmware uses (on/arg/header/send/sendHeader/sendContent), and
+// are valid inside a handler (or fill function) only. Handlers run one at
+// a time. Handler time per route is recorded in the
+// garage_http_request_duration_seconds histogram (see metrics.h).
+
+#define HTTP_MAX_CONNECTIONS 6          // Leaves lwIP sockets for SSE, OTA and DNS
+#define HTTP_MAX_ROUTES 24
+#define HTTP_MAX_ARGS 12
+#define HTTP_MAX_COLLECTED_HEADERS 4
+#define HTTP_REQUEST_BUFFER_BYTES 1536  // Request line, headers and body
+#define HTTP_RESPONSE_HEADER_BYTES 384  // Extra headers added with sendHeader()
+#define HTTP_REQUEST_TIMEOUT_MS 3000
+#define HTTP_KEEPALIVE_TIMEOUT_MS 5000
+#define HTTP_MAX_KEEPALIVE_REQUESTS 100
+#define HTTP_OUTPUT_BUFFER_BYTES 2048   // Queued response bytes per connection
+#define HTTP_STREAM_STEP_BYTES 1280     // Free output space before a fill is called
+#define HTTP_MAX_FILLS_PER_POLL 4       // Fill calls per connection per poll()
+#define HTTP_STALL_TIMEOUT_MS 5000      // Drop a client that takes no response bytes for this long
+
+#ifndef CONTENT_LENGTH_UNKNOWN
+#define CONTENT_LENGTH_UNKNOWN ((size_t) -1)
+#endif
+
+enum HttpMethod {
+    HTTP_ANY,
+    HTTP_GET,
+    HTTP_POST,
+    HTTP_PATCH                      // Body is not parsed into args; see body()
+};
+
+typedef void (*HttpHandler)();
+
+// Produces the next part of a streamed body with sendContent(), about
+// HTTP_STREAM_STEP_BYTES at a time (see HttpServer::outputSpace()), and
+// returns false once it has written the last part
+typedef bool (*HttpStreamFill)(void* context);
+// Frees a stream's context when the response ends or the client goes away
+typedef void (*HttpStreamRelease)(void* context);
+
+struct HttpServerStats {
+    uint32_t accepted;              // Connections accepted
+    uint32_t requests;              // Requests dispatched
+    uint32_t reused;                // Requests served on an already-used connection
+    uint32_t timeouts;              // Connections closed by request or idle timeouts
+    uint32_t stalled;               // Connections closed for not reading their response
+    uint32_t rejected;              // Malformed or oversized requests
+    uint8_t open;                   // Connections currently open
+};
+
+class HttpServer {
+public:
+    explicit HttpServer(uint16_t port) : port(port) {}
+
+    void on(const char* path, HttpMethod method, HttpHandler handler);
+    void collectHeaders(const char** names, size_t count);
+
+    bool begin();
+    void stop();
+
+    // One round of accept/read/dispatch/expire, waiting up to timeoutMs
+    void poll(uint32_t timeoutMs);
+
+    // Request (inside a handler)
+    HttpMethod method() const { return requestMethod; }
+    const char* uri() const { return requestPath; }
+    bool hasArg(const char* name) const;
+    String arg(const char* name) const;
+    bool hasHeader(const char* name) const;
+    String header(const char* name) const;
+    // Body of a PATCH request, null-terminated (POST bodies become args)
+    const char* body() const { return requestBody; }
+
+    // Take the connection's socket out of the server (for SSE); the caller
+    // then owns it and the server sends nothing more on it
+    int detachClient();
+
+    // Response (inside a handler)
+    void sendHeader(const String& name, const String& value, bool first = false);
+    void setContentLength(size_t length) { responseLength = length; contentLengthSet = true; }
+    void send(int code, const char* contentType = nullptr, const String& content = String());
+    void send(int code, const char* contentType, const char* content);
+    void send_P(int code, const char* contentType, const char* content, size_t length);
+    void sendContent(const String& content);
+    void sendContent(const char* content, size_t length);
+    void sendContent(const char* content);
+    // Start a response whose body is produced by 'fill' from poll(); the
+    // handler may still queue a first part with sendContent()
+    void sendStream(int code, const char* contentType, HttpStreamFill fill, void* context,
+                    HttpStreamRelease release);
+    // Bytes that can be queued without going to the heap
+    size_t outputSpace() const;
+
+    HttpServerStats getStats() const { return stats; }
+
+private:
+    struct Route {
+        const char* path;
+        HttpMethod method;
+        HttpHandler handler;
+        MetricHistogram* latency;   // Shared by routes with the same path
+    };
+
+    struct Arg {
+        const char* name;
+        const char* value;
+    };
+
+    struct Connection {
+        int fd;
+        size_t length;              // Bytes buffered
+        uint32_t lastActivityMs;
+        uint32_t requestStartMs;    // First byte of the pending (partial) request
+        uint16_t requests;
+        char buffer[HTTP_REQUEST_BUFFER_BYTES + 1];
+
+        // Response being sent: output[outputStart, outputEnd), then the
+        // spill, then the in-place body, then whatever 'fill' produces
+        bool responding;
+        bool closeAfter;            // No keep-alive: close once it is sent
+        bool chunked;               // Streamed body still needs its last chunk
+        uint32_t lastProgressMs;    // Socket last took bytes
+        size_t outputStart;
+        size_t outputEnd;
+        char* spill;                // Heap, only when output was full
+        size_t spillLength;
+        size_t spillSent;
+        const char* body;           // send_P() content, not copied
+        size_t bodyLength;
+        HttpStreamFill fill;
+        HttpStreamRelease release;
+        void* fillContext;
+        char output[HTTP_OUTPUT_BUFFER_BYTES];
+    };
+
+    uint16_t port;
+    int listenFd = -1;
+    Route routes[HTTP_MAX_ROUTES];
+    size_t routeCount = 0;
+    MetricHistogram routeLatency[HTTP_MAX_ROUTES];
+    size_t latencyCount = 0;
+    const char* collected[HTTP_MAX_COLLECTED_HEADERS];
+    size_t collectedCount = 0;
+    Connection connections[HTTP_MAX_CONNECTIONS];
+    HttpServerStats stats = {0, 0, 0, 0, 0, 0, 0};
+
+    // Current request
+    Connection* current = nullptr;
+    HttpMethod requestMethod = HTTP_GET;
+    const char* requestPath = "";
+    const char* requestBody = "";
+    Arg args[HTTP_MAX_ARGS];
+    size_t argCount = 0;
+    const char* collectedValues[HTTP_MAX_COLLECTED_HEADERS];
+    bool http10 = false;
+    bool keepAlive = false;
+    bool detached = false;
+
+    // Current response
+    char responseHeaders[HTTP_RESPONSE_HEADER_BYTES];
+    size_t responseHeadersLength = 0;
+    size_t responseLength = 0;
+    bool contentLengthSet = false;
+    bool responseStarted = false;
+    bool chunked = false;           // Until the terminating chunk is sent
+    bool sendFailed = false;
+
+    void acceptConnection();
+    void readConnection(Connection& connection);
+    void serveRequests(Connection& connection);
+    bool processRequest(Connection& connection);
+    const Route* dispatch();
+    void serviceResponse(Connection& connection, uint32_t now);
+    bool flushOutput(Connection& connection, uint32_t now);
+    bool runFill(Connection& connection);
+    void endResponse(Connection& connection);
+    void closeConnection(Connection& connection);
+    void parseArgs(char* query);
+    void sendStatus(Connection& connection, int code);
+    void sendBody(int code, const char* contentType, const char* content, size_t length);
+    void writeHead(int code, const char* contentType, size_t contentLength);
+    bool writeAll(const char* data, size_t length);
+};
+
+#endif // HTTP_SERVER_H
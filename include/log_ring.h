@@ -0,0 +1,67 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+
+// Fixed-capacity ring of log records.
+// Records are preallocated with an inline message buffer, so writing a log
+// entry never touches the heap; when the ring is full the oldest record is
+// overwritten. Every record gets a sequence number (starting at 1) so a
+// reader can ask for "everything after N" and tell when it fell behind.
+// Not synchronised: callers serialise access (see system_log.cpp). No
+// hardware dependencies.
+
+#define LOG_RING_CAPACITY 100
+#define LOG_MESSAGE_LENGTH 112      // Including the terminator; longer messages are truncated
+
+// Numeric levels for preprocessor tests (LOG_COMPILE_LEVEL in config.h)
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_ERROR 3
+
+enum LogLevel {
+    LOG_DEBUG = LOG_LEVEL_DEBUG,
+    LOG_INFO = LOG_LEVEL_INFO,
+    LOG_WARN = LOG_LEVEL_WARN,
+    LOG_ERROR = LOG_LEVEL_ERROR
+};
+
+struct LogRecord {
+    uint64_t timestampUs;           // Monotonic time since boot
+    uint32_t sequence;
+    LogLevel level;
+    char message[LOG_MESSAGE_LENGTH];
+};
+
+// Return false to stop the scan
+typedef bool (*LogVisitor)(const LogRecord& record, void* context);
+
+class LogRing {
+public:
+    // Store a message; returns the stored (possibly truncated) record
+    const LogRecord& add(LogLevel level, uint64_t timestampUs, const char* message);
+    const LogRecord& addFormatted(LogLevel level, uint64_t timestampUs, const char* format, va_list args);
+
+    // Visit records with sequence > after, oldest first, up to 'limit'
+    // records. Returns the number of records visited.
+    size_t readAfter(uint32_t after, size_t limit, LogVisitor visitor, void* context) const;
+
+    uint32_t getLastSequence() const { return nextSequence - 1; }
+    uint32_t getOldestSequence() const;     // 0 when empty
+    size_t size() const { return count; }
+
+    static const char* levelName(LogLevel level);
+
+private:
+    LogRecord records[LOG_RING_CAPACITY];
+    size_t head = 0;                // Next slot to write
+    size_t count = 0;
+    uint32_t nextSequence = 1;
+
+    LogRecord& claim(LogLevel level, uint64_t timestampUs);
+};
+
+#endif // LOG_RING_H
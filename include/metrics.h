@@ -0,0 +1,119 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Counters, gauges and histograms exposed in Prometheus text format
+// (GET /metrics).
+// Metrics are static objects in the module that owns them and link
+// themselves into a global list when constructed, so nothing is allocated.
+// Updates are relaxed atomic adds, safe from any task without locks.
+// Counters and gauges can also read an existing value through a source
+// function at scrape time, which costs the measured code nothing.
+//
+// Histograms take microseconds and are exposed in seconds with cumulative
+// buckets. Metrics sharing a name form one family and must differ in their
+// label. Register everything before the web server starts (static objects
+// or setup()).
+
+#define METRICS_MAX_BUCKETS 12
+
+enum MetricType {
+    METRIC_COUNTER,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM
+};
+
+typedef uint32_t (*MetricSource)();
+typedef void (*MetricsWriter)(const char* text, size_t length, void* context);
+
+class Metric;
+
+// Position of renderNextMetric() in the list; zero-initialize to start
+struct MetricsCursor {
+    const Metric* family;       // First member of the family being rendered
+    const Metric* member;       // Next member to render, null between families
+    bool started;
+};
+
+class Metric {
+public:
+    const char* getName() const { return name; }
+    bool isRegistered() const { return name != nullptr; }
+
+protected:
+    void registerMetric(const char* name, const char* help, MetricType type,
+                        const char* labelName, const char* labelValue);
+
+private:
+    friend bool renderNextMetric(MetricsCursor& cursor, MetricsWriter write, void* context);
+
+    const char* name = nullptr;
+    const char* help = nullptr;
+    const char* labelName = nullptr;    // Optional single label
+    const char* labelValue = nullptr;
+    MetricType type = METRIC_COUNTER;
+    Metric* next = nullptr;
+};
+
+class MetricCounter : public Metric {
+public:
+    MetricCounter(const char* name, const char* help, MetricSource source = nullptr);
+
+    void increment(uint32_t amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+    uint32_t get() const { return source ? source() : value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t> value;
+    MetricSource source;
+};
+
+class MetricGauge : public Metric {
+public:
+    MetricGauge(const char* name, const char* help, MetricSource source = nullptr);
+
+    void set(uint32_t newValue) { value.store(newValue, std::memory_order_relaxed); }
+    uint32_t get() const { return source ? source() : value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t> value;
+    MetricSource source;
+};
+
+class MetricHistogram : public Metric {
+public:
+    // Unregistered until init(), for histograms created at runtime
+    MetricHistogram() {}
+    // boundsUs: ascending upper bounds; an open-ended bucket is added
+    MetricHistogram(const char* name, const char* help, const uint32_t* boundsUs, uint8_t boundCount);
+
+    void init(const char* name, const char* help, const uint32_t* boundsUs, uint8_t boundCount,
+              const char* labelName = nullptr, const char* labelValue = nullptr);
+    void observe(uint32_t us);
+
+    uint8_t getBoundCount() const { return boundCount; }
+    uint32_t getBoundUs(uint8_t index) const { return bounds[index]; }
+    uint32_t getBucket(uint8_t index) const { return buckets[index].load(std::memory_order_relaxed); }
+    uint64_t getSumUs() const;
+
+private:
+    const uint32_t* bounds = nullptr;
+    uint8_t boundCount = 0;
+    std::atomic<uint32_t> buckets[METRICS_MAX_BUCKETS + 1];  // Per bucket, last is open-ended
+    // 64-bit sum as two words: 64-bit atomics are not lock-free on the ESP32
+    std::atomic<uint32_t> sumLow;
+    std::atomic<uint32_t> sumHigh;
+};
+
+// Render every registered metric, handing the text to 'write' a line at a
+// time (no allocation; lines are formatted on the stack)
+void renderMetrics(MetricsWriter write, void* context);
+
+// Render one metric (after its family's HELP/TYPE lines when it is the
+// first member), so a streamed response can produce the text as the
+// client takes it. Returns false once everything has been rendered.
+bool renderNextMetric(MetricsCursor& cursor, MetricsWriter write, void* context);
+
+#endif // METRICS_H
@@ -0,0 +1,82 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Bounded multi-producer/single-consumer queue (Vyukov's sequenced ring).
+// Every cell carries a sequence number: a producer claims a cell by
+// advancing head with a compare-and-swap, fills it and then publishes it
+// by bumping the cell's sequence, so producers never wait for each other
+// or for the consumer. Any task can push without taking a lock; a full
+// queue fails the push instead of blocking. Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class MpscQueue {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "MpscQueue capacity must be a power of two");
+
+public:
+  MpscQueue() {
+    for (size_t i = 0; i < Capacity; i++) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Producer side (any task). Returns false when full.
+  bool push(const T& value) {
+    uint32_t position = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = cells_[position & (Capacity - 1)];
+      uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+      int32_t difference = (int32_t)(sequence - position);
+
+      if (difference == 0) {
+        // Cell is free for this position: try to claim it
+        if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          cell.value = value;
+          cell.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false;  // Consumer has not freed this cell yet: full
+      } else {
+        position = head_.load(std::memory_order_relaxed);  // Another producer won
+      }
+    }
+  }
+
+  // Consumer side (one task only). Returns false when empty.
+  bool pop(T& value) {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    Cell& cell = cells_[tail & (Capacity - 1)];
+    uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if ((int32_t)(sequence - (tail + 1)) < 0) {
+      return false;  // Not published yet
+    }
+
+    value = cell.value;
+    cell.sequence.store(tail + Capacity, std::memory_order_release);
+    tail_.store(tail + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Approximate while producers are active
+  size_t size() const {
+    return head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed);
+  }
+
+  static size_t capacity() { return Capacity; }
+
+private:
+  struct Cell {
+    std::atomic<uint32_t> sequence;
+    T value;
+  };
+
+  Cell cells_[Capacity];
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};   // Written by the consumer only
+};
+
+#endif // MPSC_QUEUE_H
@@ -11,8 +11,37 @@
 #define FIRMWARE_NAME "ESP32-GarageDoor"
 
 // OTA Update URLs (GitHub releases API)
+// Override with -DOTA_UPDATE_URL=... to test against tools/ota_release_fixture.py
+#ifndef OTA_UPDATE_URL
 #define OTA_UPDATE_URL "https://api.github.com/repos/NZCypher819/esp32-garage-door-sensor/releases/latest"
+#endif
+// Defaults for ota.check_interval_ms, ota.backoff_max_ms and
+// ota.resume_attempts, which can be changed at runtime (see config_store.h)
 #define OTA_CHECK_INTERVAL 60000  // Check for updates every 60 seconds
+#define OTA_BACKOFF_MAX_MS 3600000  // Longest wait after failed or rate-limited checks
+#define OTA_CHECK_JITTER_DIVISOR 4  // Add up to 1/4 of the wait as random jitter
+
+// Release checks and ArduinoOTA run on their own task, so a slow TLS
+// handshake never holds up the web server
+#define OTA_CHECK_TASK_STACK 8192
+#define OTA_CHECK_POLL_MS 50      // ArduinoOTA.handle() and check-due test period
+
+// Background install task (see OTAManager::installLatestRelease)
+#define OTA_TASK_STACK 8192
+#define OTA_TASK_CORE 0           // With the network; sensors keep core 1
+#define OTA_FLASH_TASK_CORE 1     // Decompresses and writes flash while core 0 receives
+#ifndef OTA_PIPELINE_BUFFERS
+#define OTA_PIPELINE_BUFFERS 4    // 1 makes download and flash writes take turns
+#endif
+#ifndef OTA_PIPELINE_BUFFER_SIZE
+#define OTA_PIPELINE_BUFFER_SIZE 4096
+#endif
+#define OTA_PIPELINE_ERASE_AHEAD 4  // Sectors the flash task erases ahead while idle
+#define OTA_DOWNLOAD_TIMEOUT_MS 15000  // Treat the connection as dropped after this long without data
+#define OTA_RESUME_ATTEMPTS 8          // Retries in a row without progress before giving up
+#define OTA_RESUME_DELAY_MS 2000       // Times the retry count before each retry
+#define OTA_RESUME_WIFI_WAIT_MS 30000  // Wait this long for WiFi before a retry
+#define OTA_RESUME_COMMIT_BYTES 65536  // Save download progress to NVS this often
 
 // GitHub API Authentication (required for private repositories)
 // Generate a Personal Access Token with 'public_repo' scope at:
@@ -0,0 +1,46 @@
+#ifndef OTA_FLASH_H
+#define OTA_FLASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <esp_partition.h>
+
+// Writes an update image into the inactive OTA partition a flash sector at
+// a time. Everything before getFlushedBytes() is in flash, so an
+// interrupted download can restart at that offset, even after a reboot
+// (begin() with the offset). The partition only becomes bootable through
+// commit(), which verifies the image first.
+
+#define OTA_FLASH_SECTOR 4096
+
+class OTAFlashWriter {
+public:
+    ~OTAFlashWriter() { end(); }
+
+    // Start writing at offset, a multiple of OTA_FLASH_SECTOR. False if
+    // the offset is out of range or the sector buffer cannot be allocated.
+    bool begin(const esp_partition_t* partition, uint32_t offset = 0);
+    // False on a flash error or when the image outgrows the partition
+    bool write(const uint8_t* data, size_t length);
+    // Erase the next sector not yet erased, up to 'sectors' ahead of the
+    // write position. False when there is nothing to do (or on an error,
+    // which write() then reports).
+    bool eraseAhead(uint8_t sectors);
+    // Flush the last partial sector, verify the image and boot it next
+    bool commit();
+    void end();
+
+    uint32_t getFlushedBytes() const { return sectorStart; }
+    const esp_partition_t* getPartition() const { return partition; }
+
+private:
+    bool writeSector(size_t length);
+
+    const esp_partition_t* partition = nullptr;
+    uint8_t* sector = nullptr;
+    uint32_t sectorStart = 0;   // Partition offset of the buffered sector
+    size_t sectorFill = 0;
+    uint32_t erasedEnd = 0;     // Sectors before this are erased
+};
+
+#endif // OTA_FLASH_H
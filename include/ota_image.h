@@ -0,0 +1,97 @@
+#ifndef OTA_IMAGE_H
+#define OTA_IMAGE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <mbedtls/sha256.h>
+
+// Decodes a downloaded firmware image as it arrives, a buffer at a time,
+// and hands the result to a sink (the inactive OTA partition on the device).
+// Plain images pass straight through. Gzip images (.bin.gz) are inflated
+// with the ROM inflater through a fixed OTA_INFLATE_WINDOW byte window,
+// so an image of any size needs the same memory. A SHA-256 is kept over
+// the decoded image so it can be checked before the update is committed.
+//
+// Only the deflate stream is checked for gzip; the trailer's CRC-32 and
+// size are ignored in favour of the SHA-256.
+//
+// Delta images (.patch.gz) are a gzip-compressed patch against the
+// running firmware, generated by tools/ota_delta.py. The patch is a
+// header, then bsdiff-style records applied as they stream in:
+//
+//   header   "GDPATCH1", source size (u32), source SHA-256, target size (u32)
+//   record   diff length (u32), extra length (u32), seek (i32),
+//            diff bytes: added to source bytes at the source position,
+//            extra bytes: copied as they are,
+//            then the source position moves by seek
+//
+// Integers are little-endian. The source is read through a reader function
+// (the running partition on the device) and must match the header's
+// SHA-256 before any output is produced.
+
+#define OTA_INFLATE_WINDOW 32768    // Deflate's largest window; must be a power of two
+#define OTA_SHA256_SIZE 32
+
+#define OTA_PATCH_MAGIC "GDPATCH1"
+#define OTA_PATCH_HEADER_SIZE 48
+#define OTA_PATCH_RECORD_SIZE 12
+
+enum OTAImageFormat {
+    OTA_IMAGE_PLAIN,
+    OTA_IMAGE_GZIP,
+    OTA_IMAGE_DELTA
+};
+
+// Returns false to abort the image
+typedef bool (*OTAImageSink)(const uint8_t* data, size_t length, void* context);
+// Reads the patch source; returns false if out of range or on error
+typedef bool (*OTAImageSource)(uint32_t offset, uint8_t* data, size_t length, void* context);
+
+struct OTAInflateState;
+struct OTAPatchState;
+
+class OTAImageWriter {
+public:
+    ~OTAImageWriter() { end(); }
+
+    // False if the buffers could not be allocated. Delta images need a source.
+    bool begin(OTAImageFormat format, OTAImageSink sink, void* context, OTAImageSource source = nullptr);
+    // Plain images only: carry on after 'length' bytes written by an earlier
+    // attempt, reading them back through 'written' for the SHA-256
+    bool resumeFrom(uint32_t length, OTAImageSource written, void* writtenContext);
+    // Feed downloaded bytes; false on a decode or sink error
+    bool write(const uint8_t* data, size_t length);
+    // After the last write: false if the image is incomplete. The digest is
+    // over the decoded image.
+    bool finish(uint8_t digest[OTA_SHA256_SIZE]);
+    // Free the buffers (also done by the destructor)
+    void end();
+
+    uint32_t getImageBytes() const { return imageBytes; }
+    const char* getError() const { return error; }
+
+    static OTAImageFormat formatForName(const char* name);
+
+private:
+    bool emit(const uint8_t* data, size_t length);
+    bool decoded(const uint8_t* data, size_t length);
+    size_t parseGzipHeader(const uint8_t* data, size_t length);
+    bool inflate(const uint8_t* data, size_t length);
+    bool applyPatch(const uint8_t* data, size_t length);
+    bool checkPatchSource();
+    void nextPatchRecord();
+    bool fail(const char* message);
+
+    OTAImageFormat format = OTA_IMAGE_PLAIN;
+    OTAImageSink sink = nullptr;
+    void* context = nullptr;
+    OTAImageSource source = nullptr;
+    OTAInflateState* inflateState = nullptr;    // Gzip and delta
+    OTAPatchState* patchState = nullptr;        // Delta only
+    mbedtls_sha256_context sha;
+    bool hashing = false;
+    uint32_t imageBytes = 0;
+    const char* error = nullptr;
+};
+
+#endif // OTA_IMAGE_H
@@ -7,35 +7,102 @@
 #include <ArduinoJson.h>
 #include <ArduinoOTA.h>
 #include <ESPmDNS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include "ota_config.h"
+#include "ota_pipeline.h"
 
+// Progress of a firmware install, for /api/ota/status
+struct OTAProgress {
+    OTAUpdateStatus phase;
+    uint32_t bytesWritten;        // Downloaded so far
+    uint32_t totalBytes;          // Download size, 0 until it has started
+    uint32_t imageBytes;          // Written to flash (after decompression)
+    uint32_t elapsedMs;           // Since the download started
+    OTAPipelineStats pipeline;    // Download and flash task timings
+};
+
+// Release check counters, to verify conditional requests and backoff
+struct OTACheckStats {
+    uint32_t requests;            // Requests sent to the update server
+    uint32_t notModified;         // Answered 304, release unchanged
+    uint32_t rateLimited;         // Refused by the rate limit
+    uint8_t failures;             // Consecutive failed checks (backoff level)
+    uint32_t nextCheckMs;         // Time until the next check
+};
+
+// Release checks and ArduinoOTA run on the "ota-check" task started by
+// init(), so a slow update server never holds up the web server. An install
+// runs on its own "ota" task, so the web server stays responsive and beam
+// sensing continues until the final restart. Status strings are shared
+// between those tasks and the web server and are only accessed under
+// stateMutex.
 class OTAManager {
 private:
     unsigned long lastUpdateCheck = 0;
-    OTAUpdateStatus currentStatus = OTA_UPDATE_IDLE;
+    volatile uint32_t nextCheckDelayMs = 0;  // First check as soon as WiFi is up; cleared by triggerUpdateCheck()
+    uint8_t checkFailures = 0;
+    bool backingOff = false;
+    bool resumeChecked = false;       // Interrupted download looked at since boot
+    volatile OTAUpdateStatus currentStatus = OTA_UPDATE_IDLE;
     String statusMessage = "";
     String currentVersion = FIRMWARE_VERSION;
     String latestVersion = "";
     String latestReleaseUrl = "";
+    String latestPatchUrl = "";       // Delta image from the running version, if published
+    String installUrl = "";           // Owned by the install task while it runs
+    String installPatchUrl = "";
+    String installFallbackUrl = "";   // Compressed image, if resuming with the plain one fails
     bool updateAvailable = false;
+    SemaphoreHandle_t stateMutex = nullptr;
+    uint32_t downloadStartMs = 0;
+    uint32_t downloadEndMs = 0;
+    uint32_t bytesWritten = 0;
+    uint32_t totalBytes = 0;
+    uint32_t imageBytes = 0;
+    OTAPipelineStats pipelineStats = {};
+    
+    // Last release seen, with its validators for conditional requests
+    // (mirrored in NVS, only used by the checking task)
+    String releaseETag = "";
+    String releaseLastModified = "";
+    String releaseTag = "";
+    String releaseAssetUrl = "";
+    String releasePatchUrl = "";
+    
+    void lockState();
+    void unlockState();
+    void setStatus(OTAUpdateStatus status, const String& message);
+    bool isBusy() const;
+    void applyRelease(const String& tagName, const String& downloadUrl, const String& patchUrl);
+    void scheduleNextCheck(bool succeeded, uint32_t retryAfterMs);
+    static void checkTask(void* parameter);
+    static void installTask(void* parameter);
     
 public:
+    // Start ArduinoOTA and the check task; call once WiFi is up
     void init();
+    // One round of ArduinoOTA and, when due, a release check (check task)
     void loop();
     bool checkForUpdate();
     bool performUpdate(String firmwareUrl);
+    // Start installing the latest release in the background; false if there
+    // is nothing to install or an update is already running
     bool installLatestRelease();
     void enableWebOTA();
     
-    // Status getters
+    // Status getters (safe from any task)
     OTAUpdateStatus getStatus() { return currentStatus; }
-    String getStatusMessage() { return statusMessage; }
+    String getStatusMessage();
     String getCurrentVersion() { return currentVersion; }
-    String getLatestVersion() { return latestVersion; }
+    String getLatestVersion();
     bool isUpdateAvailable() { return updateAvailable; }
+    OTAProgress getProgress();
+    OTACheckStats getCheckStats();
+    static const char* statusName(OTAUpdateStatus status);
     
-    // Manual update trigger
-    void triggerUpdateCheck() { lastUpdateCheck = 0; }
+    // Manual update trigger; waits out a rate-limit backoff
+    void triggerUpdateCheck();
 };
 
 extern OTAManager otaManager;
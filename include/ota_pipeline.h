@@ -0,0 +1,81 @@
+#ifndef OTA_PIPELINE_H
+#define OTA_PIPELINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include "ota_image.h"
+#include "ota_flash.h"
+
+// Runs an OTAImageWriter on its own task (OTA_FLASH_TASK_CORE), so the
+// download task keeps receiving while the writer inflates, erases and
+// writes flash. OTA_PIPELINE_BUFFERS buffers cycle between the two:
+//
+//   download task   acquire() a free buffer, fill it from the socket, push()
+//   flash task      write it through the image writer, hand it back
+//
+// While it has nothing to write, the flash task erases up to
+// OTA_PIPELINE_ERASE_AHEAD sectors ahead, taking erases off the write path.
+// With one buffer the two stages simply alternate, as a single task would.
+
+struct OTAPipelineStats {
+    uint32_t bytes;                 // Pushed by the download task
+    uint32_t networkStallMs;        // Download task waiting for a free buffer
+    uint32_t flashBusyMs;           // Flash task writing or erasing
+    uint32_t flashStallMs;          // Flash task waiting for data
+    uint32_t erasedAhead;           // Sectors erased while waiting
+};
+
+class OTAPipeline {
+public:
+    ~OTAPipeline() { end(); }
+
+    // Allocates the buffers and starts the flash task. Until end(), the
+    // writers belong to the flash task.
+    bool begin(OTAImageWriter* writer, OTAFlashWriter* flash);
+    // Next free buffer of OTA_PIPELINE_BUFFER_SIZE bytes; blocks while all
+    // are in use. Null if the pipeline has not started.
+    uint8_t* acquire();
+    // Queue an acquired buffer for writing. False once the writer failed.
+    bool push(uint8_t* buffer, size_t length);
+    // Write everything pushed so far, then stop the flash task and free
+    // the buffers
+    void end();
+
+    bool failed() const { return writeFailed; }
+    uint32_t getImageBytes() const { return imageBytes; }
+    uint32_t getFlushedBytes() const { return flushedBytes; }
+    OTAPipelineStats getStats() const;
+
+private:
+    struct Chunk {
+        uint8_t* buffer;            // Null stops the flash task
+        size_t length;
+    };
+
+    static void flashTask(void* parameter);
+    void runFlash();
+
+    OTAImageWriter* writer = nullptr;
+    OTAFlashWriter* flash = nullptr;
+    uint8_t* buffers = nullptr;
+    QueueHandle_t freeQueue = nullptr;
+    QueueHandle_t fullQueue = nullptr;
+    TaskHandle_t owner = nullptr;   // Notified when the flash task exits
+    bool running = false;
+
+    // Written by the flash task, read by the download task
+    volatile bool writeFailed = false;
+    volatile uint32_t imageBytes = 0;
+    volatile uint32_t flushedBytes = 0;
+    volatile uint32_t flashBusyUs = 0;
+    volatile uint32_t flashStallUs = 0;
+    volatile uint32_t erasedAhead = 0;
+
+    uint32_t pushedBytes = 0;
+    uint32_t networkStallUs = 0;
+};
+
+#endif // OTA_PIPELINE_H
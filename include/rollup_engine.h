@@ -0,0 +1,93 @@
+#ifndef ROLLUP_ENGINE_H
+#define ROLLUP_ENGINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Multi-resolution rollups of environmental readings.
+// Every sample updates one min/max/sum/count bucket per resolution, so an
+// update is O(1) regardless of how much history is kept. Each resolution
+// is a fixed ring of buckets indexed by (start / width) % slots; a bucket
+// whose start does not match the period being written is simply reset,
+// which evicts the oldest period without any bookkeeping. Long ranges can
+// then be charted from a few hundred pre-aggregated buckets instead of
+// decoding every raw sample. No hardware dependencies; the caller supplies
+// the memory (see requiredBytes()).
+
+#define ROLLUP_MINUTE_SLOTS 1440   // 24 hours of 1-minute buckets
+#define ROLLUP_HOUR_SLOTS 720      // 30 days of 1-hour buckets
+#define ROLLUP_DAY_SLOTS 365       // 1 year of 1-day buckets
+
+enum RollupSeries {
+    ROLLUP_TEMPERATURE,
+    ROLLUP_HUMIDITY,
+    ROLLUP_PRESSURE,
+    ROLLUP_SERIES_COUNT
+};
+
+enum RollupResolution {
+    ROLLUP_MINUTE,
+    ROLLUP_HOUR,
+    ROLLUP_DAY,
+    ROLLUP_RESOLUTION_COUNT
+};
+
+struct RollupAggregate {
+    float min;
+    float max;
+    float sum;
+    uint32_t count;             // 0 = no samples for this series in the bucket
+
+    float mean() const { return count ? sum / count : 0.0f; }
+};
+
+struct RollupBucket {
+    uint32_t start;             // Period start, seconds (uptime)
+    RollupAggregate series[ROLLUP_SERIES_COUNT];
+};
+
+// Return false to stop the scan
+typedef bool (*RollupVisitor)(const RollupBucket& bucket, void* context);
+
+class RollupEngine {
+public:
+    // Memory needed by begin() for all resolutions
+    static size_t requiredBytes();
+
+    // Use caller-owned memory; returns false if it is smaller than requiredBytes()
+    bool begin(uint8_t* memory, size_t bytes);
+    bool isReady() const { return levels[0] != nullptr; }
+
+    // Fold one reading into the current bucket of every resolution.
+    // Timestamps older than the retained period of a resolution are ignored there.
+    void addSample(RollupSeries series, uint32_t timestamp, float value);
+
+    // Pick the coarsest resolution that still yields at least 'points'
+    // buckets over [from, to] and still retains 'from'. Falls back to the
+    // finest resolution that retains 'from', then to the coarsest.
+    RollupResolution selectResolution(uint32_t from, uint32_t to, uint32_t points) const;
+
+    // Visit buckets with samples whose period overlaps [from, to], oldest
+    // first: 'from' is rounded down to its bucket start. Returns the number
+    // of buckets visited.
+    uint32_t query(RollupResolution resolution, uint32_t from, uint32_t to,
+                   RollupVisitor visitor, void* context) const;
+
+    uint32_t getSampleCount() const { return samplesAdded; }
+    uint32_t getNewestTimestamp() const { return newestTimestamp; }
+
+    static uint32_t widthSeconds(RollupResolution resolution);
+    static uint32_t slotCount(RollupResolution resolution);
+    static const char* resolutionName(RollupResolution resolution);
+    static bool parseResolution(const char* name, RollupResolution& resolution);
+    static const char* seriesName(RollupSeries series);
+
+private:
+    RollupBucket* levels[ROLLUP_RESOLUTION_COUNT] = {};
+    uint32_t samplesAdded = 0;
+    uint32_t newestTimestamp = 0;
+
+    bool retains(RollupResolution resolution, uint32_t timestamp) const;
+};
+
+#endif // ROLLUP_ENGINE_H
@@ -0,0 +1,74 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+
+// Cooperative deadline scheduler for the main loop.
+// Each job has its own period; runOnce() runs every job whose deadline has
+// passed and then sleeps until the earliest upcoming deadline. Time comes
+// from injected clock/sleep functions so the same code can run against
+// micros() on the ESP32 or a virtual clock on a Linux host.
+
+#define SCHEDULER_MAX_JOBS 12
+
+typedef uint32_t (*SchedulerClockFn)();          // Current time in microseconds
+typedef void (*SchedulerSleepFn)(uint32_t us);   // Block for up to 'us' microseconds
+typedef void (*SchedulerJobFn)();
+
+struct SchedulerJobStats {
+    uint32_t runs;           // Number of times the job ran
+    uint32_t overruns;       // Deadlines missed by a full period or more
+    uint32_t lastJitterUs;   // Start time minus deadline on the last run
+    uint32_t maxJitterUs;
+    uint64_t totalJitterUs;  // For the mean (totalJitterUs / runs)
+    uint32_t lastRunUs;      // Execution time of the last run
+    uint32_t maxRunUs;
+};
+
+struct SchedulerJob {
+    const char* name;
+    SchedulerJobFn fn;
+    uint32_t periodUs;       // 0 = run on every pass
+    uint32_t nextDueUs;
+    SchedulerJobStats stats;
+};
+
+class Scheduler {
+public:
+    Scheduler(SchedulerClockFn clock, SchedulerSleepFn sleep);
+
+    // Register a job; returns its index or -1 if the table is full.
+    // Periodic jobs first run one period after registration.
+    int addJob(const char* name, SchedulerJobFn fn, uint32_t periodUs);
+
+    // Run all due jobs once, then sleep until the next deadline
+    void runOnce();
+
+    // Microseconds until the earliest periodic deadline (0 if one is due)
+    uint32_t timeUntilNextDeadline() const;
+
+    int getJobCount() const { return jobCount; }
+    const SchedulerJob* getJob(int index) const;
+    void resetStats();
+
+    // Whole-pass statistics
+    uint32_t getPassCount() const { return passCount; }
+    uint64_t getTotalSleepUs() const { return totalSleepUs; }
+    uint32_t getLastPassUs() const { return lastPassUs; }   // Time spent in jobs, excluding sleep
+
+private:
+    SchedulerClockFn clockFn;
+    SchedulerSleepFn sleepFn;
+    SchedulerJob jobs[SCHEDULER_MAX_JOBS];
+    int jobCount = 0;
+    uint32_t passCount = 0;
+    uint64_t totalSleepUs = 0;
+    uint32_t lastPassUs = 0;
+
+    void runJob(SchedulerJob& job, uint32_t startUs);
+};
+
+// Main-loop scheduler instance (defined in main.cpp)
+extern Scheduler taskScheduler;
+
+#endif // SCHEDULER_H
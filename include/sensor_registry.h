@@ -0,0 +1,67 @@
+#ifndef SENSOR_REGISTRY_H
+#define SENSOR_REGISTRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "scheduler.h"
+
+// Compile-time sensor registry.
+// A sensor is a type with static members only:
+//
+//   struct MySensor {
+//     static const char* name();
+//     static constexpr uint32_t periodUs();   // Sampling period
+//     static void init();
+//     static void sample();
+//   };
+//
+// The enabled set is a type list, SensorRegistry<A, B, C>. Every operation
+// is expanded by template recursion at compile time, so there is no virtual
+// dispatch and no table of disabled sensors at runtime. A sensor that is
+// compiled out is replaced by DisabledSensor, which the registry drops from
+// the list. Mock sensor types with the same shape can be listed instead for
+// a native build.
+
+// Placeholder for a sensor disabled in config.h
+struct DisabledSensor {};
+
+template <typename... Sensors>
+struct SensorRegistry;
+
+template <>
+struct SensorRegistry<> {
+    static constexpr size_t count() { return 0; }
+    static void initAll() {}
+    static void sampleAll() {}
+    static void registerJobs(Scheduler&) {}
+};
+
+// Disabled entries are skipped without generating any code
+template <typename... Rest>
+struct SensorRegistry<DisabledSensor, Rest...> : SensorRegistry<Rest...> {};
+
+template <typename First, typename... Rest>
+struct SensorRegistry<First, Rest...> {
+    typedef SensorRegistry<Rest...> Tail;
+
+    static constexpr size_t count() { return 1 + Tail::count(); }
+
+    static void initAll() {
+        First::init();
+        Tail::initAll();
+    }
+
+    // Sample every sensor once, in list order
+    static void sampleAll() {
+        First::sample();
+        Tail::sampleAll();
+    }
+
+    // Give each sensor its own scheduler job at its own period
+    static void registerJobs(Scheduler& scheduler) {
+        scheduler.addJob(First::name(), &First::sample, First::periodUs());
+        Tail::registerJobs(scheduler);
+    }
+};
+
+#endif // SENSOR_REGISTRY_H
@@ -2,31 +2,52 @@
 #define SENSORS_H
 
 #include <Arduino.h>
+#include "beam_filter.h"
+
+class Scheduler;
+class BeamAnalytics;
+struct SensorData;
 
 // Function declarations
+// The enabled sensors form a compile-time registry (sensor_registry.h) built
+// from the ENABLE_* flags in config.h
 void initializeSensors();
-void readAllSensors();
-void readE3JKRR11();
-void readDHT22();
-void readBMP280();
-void readAnalogSensor();
+void readAllSensors();                        // Sample every enabled sensor once
+void registerSensorJobs(Scheduler& scheduler); // One scheduler job per sensor at its own period
+bool isEnvironmentDataStale();  // True when the cached temperature/humidity is too old
+
+// Consistent copies for readers on other tasks (web server, event stream);
+// the sensor jobs update both under one lock
+SensorData getSensorDataSnapshot();
+BeamAnalytics getBeamAnalyticsSnapshot();
 
 // E3JK-RR11 specific functions
+void readE3JKRR11();
 bool isBeamBroken();
 bool isBeamClear();
 void updateBeamStatusLED();
 void setupE3JKRR11Interrupt();
 void IRAM_ATTR e3jkInterruptHandler();
+uint32_t getBeamEdgeCount();        // Edges captured by the ISR since boot
+uint32_t getBeamEdgeOverflowCount(); // Edges dropped because the queue was full
+uint32_t getBeamEdgeQueueHighWater(); // Deepest queue fill level seen
+
+// E3JK-RR11 glitch filter (applied on the next queue drain)
+void setBeamFilterConfig(const BeamFilterConfig& config);
+BeamFilterConfig getBeamFilterConfig();
+BeamFilterStats getBeamFilterStats();
 
 // Sensor data structures
 struct SensorData {
   bool beamBroken;              // E3JK-RR11 beam status (true = broken, false = clear)
   unsigned long lastStateChangeTime; // Last state change timestamp
+  uint32_t lastStateChangeMicros;    // Same edge in micros() from the ISR
   float temperature;
   float humidity;
   float pressure;
   float altitude;
   int analogValue;
+  unsigned long environmentTimestamp; // millis() of the last good DHT22 reading
   bool dataValid;
 };
 
@@ -0,0 +1,76 @@
+#ifndef SYSTEM_LOG_H
+#define SYSTEM_LOG_H
+
+#include "config.h"
+#include "log_ring.h"
+#include "deferred_log.h"
+
+// Device event log.
+// Entries are kept in a fixed ring (see log_ring.h) that the web server
+// exposes at /api/logs, and a low-priority background task echoes them to
+// Serial, so logging never waits on the UART.
+//
+// Two ways in:
+//   LOGD/LOGI/LOGW/LOGE(format, args...)
+//       Deferred: the format pointer and raw arguments are pushed to a
+//       lock-free queue and formatted later by the background task. Cheapest
+//       on the hot path; arguments must be scalars or static strings (see
+//       deferred_log.h). Levels below LOG_COMPILE_LEVEL compile to nothing,
+//       arguments included. If the queue is full the entry is dropped and
+//       counted.
+//   addLogEntry(message, level) / addLogEntryf(level, format, ...)
+//       Formatted immediately into the ring; use for transient strings.
+
+void initSystemLog();   // Start the background task (call once from setup)
+
+void addLogEntry(const char* message, LogLevel level = LOG_INFO);
+void addLogEntryf(LogLevel level, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+// Copy-out read of the ring, safe against concurrent writers
+size_t readLogEntries(uint32_t after, size_t limit, LogVisitor visitor, void* context);
+uint32_t getLogOldestSequence();
+uint32_t getLogLastSequence();
+
+struct SystemLogStats {
+    uint32_t enqueued;          // Deferred entries accepted
+    uint32_t dropped;           // Deferred entries lost to a full queue
+    uint32_t queueHighWater;
+    uint32_t enqueueCyclesMax;  // CPU cycles spent in one deferred call site
+    uint64_t enqueueCyclesTotal;
+};
+SystemLogStats getSystemLogStats();
+
+bool enqueueLogEntry(DeferredLogEntry& entry);
+
+template <typename... Args>
+inline void logDeferred(LogLevel level, const char* format, Args... args) {
+    static_assert(sizeof...(Args) <= DEFERRED_LOG_MAX_ARGS, "Too many log arguments");
+    DeferredLogEntry entry;
+    entry.format = format;
+    entry.level = level;
+    entry.argCount = 0;
+    packLogArgs(entry, args...);
+    enqueueLogEntry(entry);
+}
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_DEBUG
+#define LOGD(...) logDeferred(LOG_DEBUG, __VA_ARGS__)
+#else
+#define LOGD(...) do {} while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_INFO
+#define LOGI(...) logDeferred(LOG_INFO, __VA_ARGS__)
+#else
+#define LOGI(...) do {} while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_WARN
+#define LOGW(...) logDeferred(LOG_WARN, __VA_ARGS__)
+#else
+#define LOGW(...) do {} while (0)
+#endif
+
+#define LOGE(...) logDeferred(LOG_ERROR, __VA_ARGS__)
+
+#endif // SYSTEM_LOG_H
@@ -0,0 +1,93 @@
+#ifndef TIMESERIES_STORE_H
+#define TIMESERIES_STORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Fixed-memory compressed time-series store (Gorilla-style).
+// Memory is split into fixed-size blocks used as a ring: when the newest
+// block is full the oldest one is overwritten. Inside a block:
+//   - the first sample is stored raw
+//   - timestamps are delta-of-delta encoded (a steady 10s cadence costs 1 bit)
+//   - each value is stored as its change from the previous one, zigzag
+//     coded so small steps either way are small numbers, and only the
+//     significant bits are written, reusing the previous bit width when it
+//     fits (an unchanged value costs 1 bit, a 0.1 step 4 bits)
+// Values are stored as integers in the sensor's resolution (0.1 units).
+// Decimal steps of an IEEE float flip most mantissa bits, and even as
+// integers an XOR of neighbouring values (0111 ^ 1000) can span many bits,
+// where their difference is always small.
+// The caller supplies the memory (PSRAM on the ESP32, any buffer on a host).
+
+#define TS_SERIES_COUNT 2          // Temperature, humidity
+#define TS_BLOCK_BYTES 512
+#define TS_VALUE_SCALE 10.0f       // Stored resolution: 0.1 units
+
+struct TimeSeriesSample {
+    uint32_t timestamp;                 // Seconds (uptime)
+    float values[TS_SERIES_COUNT];
+};
+
+struct TimeSeriesStats {
+    uint32_t blockCount;
+    uint32_t blocksInUse;
+    uint32_t sampleCount;               // Samples currently retained
+    uint32_t samplesWritten;            // Since begin()
+    uint32_t blocksEvicted;
+    uint32_t bytesUsed;                 // Encoded payload bytes currently retained
+    uint32_t oldestTimestamp;
+    uint32_t newestTimestamp;
+};
+
+// Return false to stop the scan
+typedef bool (*TimeSeriesVisitor)(const TimeSeriesSample& sample, void* context);
+
+class TimeSeriesStore {
+public:
+    // Use 'bytes' of caller-owned memory; returns false if too small for two blocks
+    bool begin(uint8_t* memory, size_t bytes);
+    bool isReady() const { return blocks != nullptr; }
+
+    // Append a sample; timestamps must not go backwards
+    bool append(const TimeSeriesSample& sample);
+
+    // Decode samples with from <= timestamp <= to, oldest first, streaming
+    // one block at a time. Returns the number of samples visited.
+    uint32_t query(uint32_t from, uint32_t to, TimeSeriesVisitor visitor, void* context) const;
+
+    TimeSeriesStats getStats() const;
+
+private:
+    struct BlockHeader {
+        uint32_t firstTimestamp;
+        uint32_t lastTimestamp;
+        uint16_t sampleCount;
+        uint16_t bitCount;
+    };
+
+    struct SeriesState {
+        int32_t previous;
+        uint8_t width;              // Significant bits of the last full header
+        bool hasWindow;
+    };
+
+    uint8_t* blocks = nullptr;
+    uint32_t blockCount = 0;
+    uint32_t headBlock = 0;             // Block currently being written
+    uint32_t blocksInUse = 0;
+    uint32_t samplesWritten = 0;
+    uint32_t blocksEvicted = 0;
+
+    // Encoder state for the head block
+    uint32_t previousTimestamp = 0;
+    int32_t previousDelta = 0;
+    SeriesState series[TS_SERIES_COUNT];
+
+    BlockHeader* header(uint32_t index) const;
+    uint8_t* payload(uint32_t index) const;
+    void startBlock(uint32_t index, const TimeSeriesSample& sample, const int32_t* quantized);
+    uint32_t decodeBlock(uint32_t index, uint32_t from, uint32_t to,
+                         TimeSeriesVisitor visitor, void* context, bool& stop) const;
+};
+
+#endif // TIMESERIES_STORE_H
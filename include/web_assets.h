@@ -0,0 +1,180 @@
+// Generated by tools/embed_web_assets.py from web/ - do not edit
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <Arduino.h>
+
+// web/dashboard.html: 9424 bytes, 2664 gzipped
+#define DASHBOARD_HTML_ETAG "\"2bfa336f8fbe6ef6\""
+#define DASHBOARD_HTML_GZ_LENGTH 2664
+static const uint8_t DASHBOARD_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xbd, 0x5a, 0xcb, 0x6e, 0xe3, 0xc8,
+    0x15, 0xdd, 0xf7, 0x57, 0x94, 0xd5, 0x98, 0xa1, 0x84, 0x91, 0xa8, 0x87, 0x25, 0xdb, 0x63, 0x4b,
+    0x1a, 0xb8, 0xfd, 0x48, 0x3a, 0xd3, 0xd3, 0x6e, 0xb4, 0xed, 0x01, 0xb2, 0x32, 0x4a, 0x64, 0xd1,
+    0xac, 0x31, 0xc5, 0x22, 0xaa, 0x48, 0xcb, 0x4e, 0x8f, 0x81, 0x2c, 0x02, 0x04, 0x08, 0x10, 0x64,
+    0x91, 0xac, 0xb2, 0x99, 0x1f, 0xc8, 0x22, 0xcb, 0xac, 0xf3, 0x29, 0xf9, 0x81, 0xcc, 0x27, 0xe4,
+    0xd6, 0x83, 0x54, 0x89, 0x22, 0xe5, 0xc7, 0x34, 0x62, 0x01, 0xdd, 0x62, 0xb1, 0xee, 0xb9, 0x8f,
+    0xba, 0xf7, 0xd6, 0xa9, 0xb2, 0xc7, 0x5b, 0xc7, 0x67, 0x47, 0x17, 0xbf, 0xfd, 0x70, 0x82, 0xc2,
+    0x74, 0x1e, 0x4d, 0x5f, 0x8d, 0xf3, 0xff, 0x08, 0xf6, 0xa7, 0xaf, 0x10, 0xfc, 0x8c, 0xe7, 0x24,
+    0xc5, 0xc8, 0x0b, 0x31, 0x17, 0x24, 0x9d, 0x34, 0x2e, 0x2f, 0x4e, 0x3b, 0x7b, 0x0d, 0xfb, 0x55,
+    0x8c, 0xe7, 0x64, 0xd2, 0xb8, 0xa5, 0x64, 0x91, 0x30, 0x9e, 0x36, 0x90, 0xc7, 0xe2, 0x94, 0xc4,
+    0x30, 0x75, 0x41, 0xfd, 0x34, 0x9c, 0xf8, 0xe4, 0x96, 0x7a, 0xa4, 0xa3, 0x1e, 0xda, 0x88, 0xc6,
+    0x34, 0xa5, 0x38, 0xea, 0x08, 0x0f, 0x47, 0x64, 0xd2, 0x77, 0x7b, 0x39, 0x54, 0x4a, 0xd3, 0x88,
+    0x4c, 0x4f, 0xce, 0x3f, 0x6c, 0x0f, 0xd0, 0xaf, 0x30, 0xc7, 0xd7, 0x04, 0x1d, 0x33, 0xc6, 0xd1,
+    0x39, 0x89, 0x05, 0xe3, 0xe3, 0xae, 0x7e, 0xaf, 0xe7, 0x8a, 0xf4, 0x3e, 0xff, 0x2e, 0x7f, 0x66,
+    0xcc, 0xbf, 0x47, 0x9f, 0x50, 0x00, 0x7a, 0x3b, 0x01, 0x9e, 0xd3, 0xe8, 0x7e, 0x1f, 0x1d, 0x72,
+    0xd0, 0xd2, 0x46, 0x02, 0xc7, 0xa2, 0x23, 0x08, 0xa7, 0xc1, 0x01, 0x9a, 0xe3, 0x3b, 0x6d, 0xc5,
+    0x3e, 0xda, 0xeb, 0xf5, 0x92, 0x3b, 0x39, 0xc2, 0xaf, 0x69, 0xbc, 0x8f, 0x7a, 0x08, 0x67, 0x29,
+    0x3b, 0x40, 0x09, 0xf6, 0x7d, 0x1a, 0x5f, 0xef, 0xa3, 0x81, 0x7a, 0x3d, 0xc3, 0xde, 0xcd, 0x35,
+    0x67, 0x59, 0xec, 0xef, 0xa3, 0xd7, 0xc1, 0x48, 0x7e, 0x0e, 0xd0, 0x43, 0xa1, 0xd6, 0x95, 0x8e,
+    0x62, 0x1a, 0x13, 0x0e, 0xca, 0xed, 0xb9, 0x8b, 0x90, 0xa6, 0x04, 0xc4, 0x19, 0xf7, 0x09, 0xef,
+    0x70, 0xec, 0xd3, 0x4c, 0x80, 0x4e, 0x09, 0x59, 0xd6, 0xc0, 0xee, 0x3a, 0x22, 0xc4, 0x3e, 0x5b,
+    0x48, 0x23, 0x06, 0xc9, 0x1d, 0xea, 0xc3, 0x38, 0xe2, 0xd7, 0x33, 0xdc, 0xec, 0xb5, 0xd5, 0xc7,
+    0xed, 0xb7, 0x72, 0x43, 0x3b, 0x33, 0x96, 0xa6, 0x6c, 0x9e, 0x0b, 0x2f, 0x2d, 0x09, 0xfb, 0x60,
+    0x81, 0xc7, 0x22, 0xc6, 0xc1, 0xd0, 0xed, 0xed, 0xed, 0x03, 0x94, 0x92, 0xbb, 0xb4, 0x83, 0x23,
+    0x7a, 0x0d, 0xde, 0x79, 0xb0, 0x18, 0x84, 0xaf, 0x81, 0x6c, 0x97, 0x40, 0x5c, 0x91, 0xe2, 0x34,
+    0x13, 0x9d, 0x6b, 0x4e, 0x7d, 0x80, 0xf3, 0xa9, 0x48, 0x22, 0x0c, 0x91, 0x94, 0xcf, 0x07, 0xea,
+    0xdf, 0x4e, 0x4a, 0xe6, 0x30, 0x96, 0x92, 0x0e, 0xe8, 0xca, 0xe6, 0x31, 0x38, 0xc5, 0x49, 0x42,
+    0x70, 0xda, 0x94, 0xe1, 0xeb, 0x04, 0x34, 0x6d, 0xa3, 0x39, 0x8d, 0x21, 0xce, 0xcd, 0x81, 0x0c,
+    0x70, 0x1b, 0xf5, 0x03, 0xde, 0x02, 0xf3, 0xaf, 0x71, 0x92, 0x1b, 0xfd, 0x44, 0x23, 0x3c, 0xcc,
+    0xfd, 0x52, 0x54, 0x5f, 0x07, 0x7b, 0xc1, 0xd7, 0x01, 0x5e, 0x8b, 0xeb, 0xce, 0x4a, 0x5c, 0xfb,
+    0x23, 0xf9, 0x58, 0xe5, 0xbe, 0x11, 0x8b, 0x48, 0x90, 0xee, 0xa3, 0x21, 0x44, 0x59, 0xb0, 0x08,
+    0x3c, 0x7d, 0xdd, 0xeb, 0xed, 0xce, 0x82, 0xa0, 0xce, 0x08, 0x77, 0x16, 0x31, 0xef, 0x86, 0x28,
+    0x63, 0x96, 0x00, 0x9d, 0x3c, 0xd8, 0xbe, 0xb7, 0x3d, 0x1a, 0x8e, 0xca, 0xa9, 0xb2, 0xe7, 0xef,
+    0xfa, 0xb8, 0x16, 0xd1, 0x8b, 0x08, 0xe6, 0x35, 0x78, 0x83, 0x3d, 0xbc, 0xbb, 0x86, 0xe7, 0x0f,
+    0x89, 0xbf, 0x01, 0x8f, 0xc5, 0x35, 0x60, 0x41, 0xe0, 0xf5, 0x7b, 0xbb, 0x65, 0xe3, 0x82, 0x60,
+    0xdb, 0xf3, 0x6b, 0xc1, 0xe4, 0x12, 0x77, 0x62, 0xc6, 0xe7, 0x38, 0xaa, 0x41, 0xed, 0xef, 0xe2,
+    0xc1, 0x6c, 0xaf, 0x6c, 0x62, 0x9f, 0x78, 0x41, 0xbf, 0x16, 0x35, 0xcc, 0xe6, 0xd4, 0xa7, 0xe9,
+    0xfd, 0x66, 0xe4, 0x9d, 0x60, 0x38, 0xf0, 0xfa, 0x25, 0x64, 0x32, 0xf0, 0xbf, 0x0e, 0xb6, 0x57,
+    0x90, 0xb3, 0xc4, 0x97, 0x49, 0x88, 0x6f, 0x31, 0x8d, 0xf0, 0x2c, 0x22, 0x56, 0xf2, 0xef, 0x8d,
+    0x76, 0x86, 0xbd, 0x61, 0x8d, 0xcb, 0x45, 0x92, 0x8c, 0x4c, 0xa1, 0xad, 0xe5, 0xd2, 0x50, 0x8e,
+    0xa9, 0x3e, 0xb2, 0x20, 0xf4, 0x3a, 0x84, 0x44, 0x99, 0xb1, 0xc8, 0xaf, 0x52, 0xee, 0x65, 0x9c,
+    0x43, 0x62, 0x59, 0xaa, 0xfb, 0xa3, 0xd1, 0xee, 0x60, 0x58, 0xb3, 0x74, 0x9f, 0x45, 0xb5, 0x89,
+    0xe8, 0x2d, 0x8e, 0x32, 0x92, 0xf7, 0x3b, 0x41, 0x7f, 0x47, 0xa0, 0xb6, 0xea, 0xa4, 0x4b, 0xe5,
+    0x36, 0xaa, 0xae, 0x36, 0x88, 0x22, 0x89, 0x2c, 0x57, 0x76, 0x76, 0x76, 0x0e, 0x6c, 0xf8, 0xfe,
+    0xb0, 0x24, 0x37, 0xcb, 0x00, 0x2f, 0x2e, 0x17, 0x68, 0x5e, 0x49, 0x06, 0x66, 0xa5, 0x0d, 0xee,
+    0xa3, 0x98, 0xc5, 0xc4, 0x2e, 0x54, 0xd9, 0xed, 0xb4, 0xdd, 0x55, 0x91, 0x80, 0xf8, 0x0a, 0x09,
+    0x92, 0x30, 0xaa, 0xcb, 0xd7, 0x36, 0x67, 0xc7, 0x6e, 0xde, 0xcb, 0x82, 0xf7, 0x89, 0xc7, 0x38,
+    0x4e, 0x29, 0x8b, 0x73, 0x6d, 0x45, 0x13, 0xa3, 0x71, 0x04, 0x8d, 0xba, 0xa3, 0x8a, 0xb9, 0xc2,
+    0x93, 0xfd, 0x90, 0xdd, 0xae, 0xb5, 0x71, 0xf0, 0x67, 0xb4, 0x33, 0xdb, 0xae, 0x98, 0xee, 0x8a,
+    0xcc, 0xf3, 0x88, 0x10, 0x65, 0x81, 0xbc, 0x7a, 0xd7, 0xd3, 0x45, 0x10, 0x4f, 0xda, 0x05, 0x02,
+    0x55, 0xad, 0xc9, 0x9a, 0xcf, 0x49, 0xc0, 0x89, 0x08, 0xa1, 0x50, 0x52, 0xb2, 0x69, 0x45, 0x06,
+    0x56, 0x33, 0x4d, 0x19, 0xb4, 0xd7, 0x7e, 0xb9, 0x93, 0xd2, 0x18, 0x56, 0x37, 0x8a, 0x60, 0xed,
+    0xef, 0x00, 0x28, 0x8f, 0x96, 0xec, 0xc2, 0xa8, 0xb7, 0x79, 0xab, 0x23, 0x7b, 0xc1, 0x88, 0xec,
+    0x55, 0x6f, 0x60, 0xf9, 0x6a, 0x0e, 0x96, 0x0d, 0xb4, 0xc2, 0x6b, 0x5b, 0x77, 0x38, 0xb4, 0xd4,
+    0xf7, 0xe0, 0xd3, 0x37, 0x26, 0x94, 0x0b, 0xa7, 0x46, 0x3e, 0x29, 0x8b, 0x8f, 0x9e, 0x25, 0xbe,
+    0xcc, 0x55, 0x3b, 0x7c, 0x7b, 0x6b, 0x9b, 0x86, 0xd9, 0x8a, 0x36, 0x57, 0xe0, 0x0a, 0xb0, 0x59,
+    0xa2, 0xf5, 0x45, 0x58, 0x5b, 0xa7, 0x95, 0x55, 0xd4, 0x70, 0xe3, 0xae, 0x21, 0x31, 0xe3, 0xae,
+    0xa6, 0x5a, 0x63, 0xc9, 0x62, 0x0c, 0xbf, 0xf1, 0xe9, 0x2d, 0xf2, 0x22, 0x2c, 0xc4, 0xa4, 0x51,
+    0x70, 0x8c, 0xc6, 0x92, 0xef, 0x8c, 0xc3, 0xfe, 0x06, 0xa2, 0x04, 0x2f, 0x97, 0x33, 0x2d, 0x24,
+    0x6b, 0x7b, 0xb7, 0xb0, 0x6a, 0x66, 0xc9, 0xae, 0xdd, 0x40, 0xd4, 0x9f, 0x34, 0x66, 0x04, 0xcf,
+    0xf5, 0xe3, 0xaa, 0x50, 0x8d, 0xa0, 0x6a, 0x4e, 0x4b, 0xc9, 0xc6, 0xb4, 0xd3, 0x19, 0x77, 0x61,
+    0xda, 0x93, 0x84, 0x55, 0x1f, 0x6a, 0x4c, 0xdf, 0x80, 0x60, 0xe1, 0xce, 0x9a, 0x6c, 0xd5, 0xd0,
+    0x26, 0x07, 0x22, 0xe2, 0xbf, 0xcc, 0x7e, 0x10, 0x7c, 0x91, 0xf9, 0xe7, 0xea, 0x09, 0xbd, 0x3b,
+    0x39, 0xfe, 0x0c, 0xd6, 0xcb, 0xfd, 0x98, 0x40, 0x53, 0xcb, 0x38, 0x79, 0x99, 0x17, 0x16, 0xc0,
+    0x8b, 0xbc, 0xb9, 0x58, 0xca, 0x7f, 0x06, 0x77, 0x0a, 0x22, 0xf0, 0x22, 0x5f, 0x72, 0xe9, 0x17,
+    0x39, 0xf2, 0x6b, 0x23, 0xfc, 0xcb, 0xbc, 0x78, 0xae, 0xc9, 0x59, 0x92, 0xd2, 0xf9, 0xcb, 0x22,
+    0x7f, 0xa9, 0x44, 0xff, 0xbf, 0xe6, 0xce, 0xc9, 0x9c, 0xf1, 0x97, 0xc5, 0xf7, 0x94, 0x13, 0x82,
+    0xbe, 0x53, 0xf2, 0x8f, 0xdb, 0x5c, 0x7e, 0xb4, 0x50, 0x57, 0x77, 0xcc, 0x72, 0xab, 0x0a, 0xb7,
+    0xa7, 0xa7, 0x94, 0xcf, 0x17, 0x98, 0x13, 0x74, 0xa9, 0x66, 0x0a, 0x68, 0x79, 0xdb, 0xa5, 0x59,
+    0xc9, 0xf4, 0xc8, 0xf0, 0xb3, 0xef, 0x09, 0x17, 0x8a, 0x10, 0x8c, 0x45, 0x82, 0x63, 0xe5, 0xe3,
+    0xad, 0x1e, 0xd2, 0x4e, 0xca, 0xd1, 0xe9, 0xb8, 0x9b, 0xac, 0x01, 0xbc, 0x93, 0xd0, 0x29, 0x3a,
+    0xcc, 0x49, 0xa6, 0x8d, 0x10, 0xa9, 0x77, 0x16, 0x80, 0xf5, 0x2e, 0x37, 0x5f, 0xc5, 0xa6, 0x31,
+    0xad, 0xd5, 0x60, 0x79, 0x6c, 0xed, 0x2a, 0x55, 0x0b, 0x16, 0x0e, 0xa7, 0x3f, 0xff, 0xf4, 0xf7,
+    0xdf, 0xa3, 0xb7, 0x7a, 0x1a, 0x32, 0x96, 0x69, 0xef, 0xc1, 0xf9, 0x61, 0x85, 0x0c, 0x04, 0x20,
+    0xa2, 0xde, 0x0d, 0x4a, 0x43, 0x82, 0xcc, 0x06, 0x08, 0x8b, 0xc4, 0x16, 0x28, 0x65, 0xc8, 0xa8,
+    0x53, 0xef, 0xb4, 0x27, 0x28, 0xc8, 0x43, 0x6a, 0x62, 0xe3, 0xae, 0xd9, 0xab, 0x50, 0x0d, 0x92,
+    0x31, 0xdb, 0x3c, 0x19, 0x2e, 0xd4, 0x40, 0x2c, 0xf6, 0xa4, 0xce, 0xc2, 0x9f, 0x66, 0xab, 0x31,
+    0xfd, 0xcf, 0x3f, 0xfe, 0xf8, 0xdf, 0x7f, 0xfd, 0xa5, 0x30, 0x5d, 0xdb, 0x8c, 0xde, 0xb3, 0xc5,
+    0xb8, 0xab, 0xc5, 0xab, 0x6c, 0xcf, 0x15, 0xc8, 0x0d, 0x56, 0xa7, 0x25, 0x4b, 0x71, 0x27, 0xe1,
+    0xec, 0x9a, 0x4b, 0x45, 0xd3, 0x63, 0x75, 0xa3, 0x80, 0x16, 0x14, 0x10, 0x61, 0x24, 0xc5, 0x3c,
+    0x55, 0x07, 0xf8, 0x39, 0x70, 0x3f, 0x0f, 0xd4, 0xdc, 0x23, 0x1c, 0x00, 0xaf, 0x42, 0x99, 0x89,
+    0x50, 0xf2, 0x78, 0xf9, 0x24, 0xd3, 0x4a, 0xe7, 0x2c, 0xa7, 0x0c, 0x31, 0x93, 0x4e, 0xfd, 0xfc,
+    0xd3, 0xdf, 0xfe, 0x80, 0x3e, 0xea, 0x67, 0xa4, 0xbb, 0x7d, 0xe1, 0x4e, 0x55, 0x2a, 0xad, 0xbb,
+    0x18, 0xc0, 0x31, 0x08, 0xcd, 0x49, 0x1a, 0x32, 0x70, 0xee, 0xc3, 0xd9, 0xf9, 0x45, 0x03, 0x61,
+    0x95, 0xee, 0x93, 0x46, 0x17, 0x27, 0xb4, 0x0b, 0xfe, 0x76, 0xbd, 0x90, 0x78, 0x37, 0x0d, 0xa4,
+    0x68, 0xc2, 0xa4, 0x51, 0x62, 0xb2, 0xab, 0xf4, 0xb7, 0x22, 0x6b, 0xec, 0xf5, 0x4a, 0xef, 0x13,
+    0x40, 0x10, 0xd9, 0x6c, 0x4e, 0xe5, 0xf5, 0xcc, 0xaa, 0x83, 0x06, 0x7f, 0x85, 0x00, 0x9a, 0x23,
+    0x9e, 0xf2, 0xf4, 0xcf, 0xe8, 0x48, 0x1a, 0x02, 0xa4, 0x86, 0x2f, 0x0b, 0xae, 0x76, 0xed, 0xba,
+    0xd2, 0xb3, 0x72, 0xb8, 0xd7, 0x23, 0x32, 0xc6, 0x28, 0x84, 0x80, 0x1a, 0x6f, 0x4d, 0xad, 0x94,
+    0x2c, 0x03, 0xe5, 0x7f, 0xfd, 0x13, 0xfa, 0x9e, 0x92, 0x85, 0x89, 0x31, 0xfa, 0xcd, 0xf9, 0xd9,
+    0xfb, 0x71, 0x17, 0x4f, 0x1f, 0x47, 0x94, 0xf1, 0xab, 0x45, 0x2d, 0x5c, 0x32, 0xee, 0x6c, 0xc0,
+    0xb5, 0x8a, 0xd4, 0x26, 0xe6, 0x86, 0xa2, 0xe0, 0xd8, 0x47, 0x24, 0xbe, 0xa5, 0x9c, 0xc5, 0x73,
+    0xd9, 0x6b, 0xbc, 0x10, 0xc7, 0xd7, 0x80, 0xa7, 0xf3, 0x0e, 0x45, 0xf4, 0x96, 0xd4, 0xb7, 0x3d,
+    0xfb, 0xab, 0xf0, 0x38, 0x4d, 0xd2, 0xe5, 0xb4, 0x6e, 0x17, 0x5d, 0x40, 0x71, 0x26, 0x92, 0xdb,
+    0x51, 0x81, 0xa4, 0x27, 0xd4, 0x53, 0xea, 0x3c, 0x0c, 0x69, 0x01, 0x9c, 0x54, 0x62, 0x23, 0xd5,
+    0xb7, 0x05, 0xb0, 0xcb, 0x39, 0x41, 0x01, 0x67, 0x73, 0x55, 0xd1, 0xd2, 0x19, 0x74, 0xf8, 0xe1,
+    0xad, 0x28, 0xd0, 0x82, 0x2c, 0xd6, 0x87, 0x0f, 0x11, 0xb2, 0x45, 0x93, 0xfa, 0x6d, 0x75, 0x06,
+    0x69, 0x23, 0xb9, 0x41, 0x1c, 0x49, 0xe7, 0x5a, 0xe8, 0xd3, 0x8a, 0xdb, 0x3e, 0xf3, 0x32, 0xe9,
+    0x90, 0x7b, 0x4d, 0xd2, 0x93, 0x88, 0xc8, 0xaf, 0x6f, 0xee, 0xdf, 0xfa, 0x20, 0xda, 0x72, 0xa5,
+    0xe8, 0x91, 0xbe, 0xe0, 0x43, 0x13, 0x05, 0x74, 0xb0, 0x22, 0x4b, 0x03, 0xd4, 0x2c, 0x80, 0xd1,
+    0xd6, 0x64, 0x82, 0x20, 0xa5, 0x48, 0x00, 0x29, 0xeb, 0x97, 0xd5, 0x6c, 0x56, 0x85, 0xbe, 0x42,
+    0x8e, 0xda, 0xc3, 0x9c, 0x96, 0xab, 0x96, 0xe0, 0x3d, 0x06, 0x37, 0x27, 0xc8, 0xb1, 0x6f, 0x88,
+    0x1c, 0x98, 0x55, 0x68, 0x5b, 0x35, 0x64, 0xc9, 0xda, 0x1f, 0x5e, 0x55, 0x87, 0xe2, 0x23, 0xf0,
+    0x6e, 0xa0, 0xff, 0x2a, 0x22, 0x5c, 0x7f, 0x6f, 0x83, 0xb5, 0x74, 0x53, 0x68, 0xa4, 0x7b, 0x5b,
+    0x66, 0x72, 0x95, 0x3f, 0x45, 0x88, 0x9d, 0x63, 0x2a, 0xe4, 0xb6, 0xe1, 0x3b, 0xf0, 0xdd, 0x69,
+    0x95, 0x6c, 0x43, 0x24, 0x12, 0x44, 0x81, 0xc9, 0xda, 0x64, 0x41, 0xae, 0xdf, 0xd5, 0x67, 0xfb,
+    0x09, 0x84, 0xcd, 0x89, 0xb3, 0xf9, 0x8c, 0x70, 0x67, 0xa3, 0x96, 0x15, 0x31, 0x37, 0x65, 0xa7,
+    0xf4, 0x8e, 0xf8, 0xcd, 0x7e, 0x0b, 0xc2, 0x52, 0x76, 0xa4, 0xd2, 0x82, 0x4d, 0x0e, 0xbc, 0xef,
+    0x1e, 0x56, 0xda, 0xbe, 0x31, 0xae, 0x45, 0x97, 0x2c, 0x41, 0x07, 0x24, 0xf5, 0xc2, 0xa6, 0x63,
+    0x95, 0x3b, 0x2c, 0x2b, 0xa4, 0x6b, 0xdc, 0xe4, 0x68, 0x32, 0x45, 0xdc, 0xfd, 0x41, 0xb0, 0xb8,
+    0xd9, 0x32, 0x63, 0x42, 0x8e, 0xad, 0xdb, 0x06, 0x67, 0x21, 0xd8, 0xab, 0xf2, 0x0b, 0xb9, 0x09,
+    0x12, 0xae, 0x50, 0x87, 0x04, 0xe1, 0xca, 0xa3, 0x86, 0xb9, 0xcc, 0xd0, 0xc1, 0x7b, 0xf3, 0xee,
+    0xec, 0xe8, 0xdb, 0x93, 0x63, 0xe7, 0xa0, 0xda, 0x41, 0x47, 0x0a, 0x80, 0x77, 0x95, 0x08, 0xed,
+    0x42, 0xc5, 0x37, 0xc8, 0x31, 0x5f, 0x1d, 0xb4, 0x8f, 0x1c, 0x75, 0x71, 0x57, 0x8e, 0xc7, 0x12,
+    0x53, 0x2f, 0xf6, 0x12, 0x12, 0x9e, 0x0b, 0xc4, 0xaa, 0x51, 0x6d, 0xe9, 0xd9, 0x7b, 0x47, 0xea,
+    0x61, 0xb1, 0x52, 0x51, 0x87, 0x9e, 0xe7, 0xaa, 0x63, 0xd1, 0xf9, 0x15, 0x65, 0xd6, 0x38, 0x2c,
+    0xda, 0xbf, 0xff, 0x79, 0x24, 0xd7, 0xce, 0xba, 0xcc, 0x7b, 0x14, 0x38, 0xe7, 0xd6, 0x2b, 0xa8,
+    0xf9, 0x20, 0x60, 0x7d, 0x21, 0x01, 0x4b, 0xf7, 0x78, 0xf5, 0xb1, 0x30, 0x3c, 0x42, 0x81, 0xe9,
+    0x5f, 0x00, 0xb8, 0x66, 0xa8, 0x9c, 0x4e, 0x50, 0xdd, 0x58, 0xe6, 0x06, 0xa4, 0x8c, 0x5c, 0xf4,
+    0x87, 0xd2, 0x7b, 0x68, 0x85, 0x97, 0x71, 0xde, 0xf5, 0xac, 0xf4, 0x81, 0x4c, 0x83, 0xa4, 0xa7,
+    0xba, 0x81, 0xcb, 0xce, 0x08, 0x7d, 0x32, 0x13, 0x99, 0xde, 0xfd, 0xe1, 0x2c, 0x3f, 0xac, 0x4f,
+    0xbf, 0x7b, 0x01, 0x71, 0xd9, 0x94, 0x7e, 0x7e, 0x75, 0xfa, 0x69, 0xcf, 0x34, 0xa1, 0x07, 0xc7,
+    0xbe, 0xc3, 0x69, 0xe8, 0x06, 0x11, 0x1c, 0xbd, 0x9b, 0xbe, 0xab, 0x47, 0x51, 0x17, 0xf5, 0x7b,
+    0xbd, 0x9e, 0x2c, 0x3f, 0x47, 0xd4, 0x07, 0x47, 0x93, 0xec, 0x32, 0x04, 0x14, 0x0e, 0xb9, 0x0a,
+    0x09, 0x4e, 0x14, 0xca, 0x60, 0xa8, 0x50, 0xd0, 0xb7, 0x6f, 0x9c, 0x67, 0x46, 0xcc, 0xf6, 0x75,
+    0xb9, 0x0f, 0x6e, 0xf2, 0x97, 0x6d, 0xf2, 0x57, 0x33, 0x44, 0x30, 0x96, 0xb9, 0xfa, 0xeb, 0x95,
+    0x59, 0x48, 0xf4, 0xe3, 0x8f, 0xc8, 0xb9, 0x8c, 0x6f, 0x62, 0xb6, 0x88, 0xab, 0x7c, 0xd5, 0xd5,
+    0x9a, 0xa7, 0x7a, 0x6d, 0xa7, 0x77, 0x56, 0x08, 0x73, 0x65, 0xd0, 0xd4, 0x9b, 0xd2, 0xce, 0xc3,
+    0xcc, 0xcd, 0xda, 0xd5, 0xf2, 0x16, 0x18, 0xaa, 0xc8, 0xf0, 0xcb, 0x62, 0x6c, 0x4b, 0x15, 0xd5,
+    0x65, 0x22, 0x69, 0xaf, 0x7c, 0xe3, 0xd4, 0xa2, 0xdb, 0x5b, 0x4c, 0x35, 0x76, 0xf9, 0xd6, 0x59,
+    0x41, 0xaf, 0xde, 0x06, 0xd7, 0xb4, 0x9b, 0x0f, 0x86, 0xb9, 0x36, 0xd9, 0x33, 0x96, 0xd2, 0xea,
+    0xae, 0x86, 0x0e, 0xe4, 0xbc, 0x9d, 0x67, 0xb1, 0x80, 0x07, 0xcd, 0xed, 0x0b, 0xda, 0x86, 0x98,
+    0x1e, 0xd1, 0xd5, 0x76, 0x80, 0x12, 0x06, 0x53, 0x69, 0x2a, 0x6c, 0x94, 0x9c, 0x42, 0x23, 0x02,
+    0x6b, 0x78, 0x8f, 0xe0, 0x88, 0xc5, 0x40, 0x30, 0x8b, 0x53, 0x2a, 0xa7, 0xe6, 0x5c, 0x5a, 0x20,
+    0xa0, 0x7a, 0x01, 0x78, 0xb9, 0x94, 0x8d, 0x48, 0x5a, 0x08, 0x5f, 0x40, 0xa2, 0x43, 0x16, 0xa1,
+    0x38, 0x8b, 0xa2, 0x83, 0x9a, 0xad, 0xd5, 0xf2, 0xb8, 0x94, 0x58, 0x3a, 0x2b, 0x8c, 0x2b, 0xd0,
+    0x78, 0x54, 0xb8, 0x93, 0x10, 0x0b, 0xb3, 0xeb, 0xf9, 0x90, 0x4d, 0x11, 0x53, 0x3d, 0xc9, 0x91,
+    0x19, 0xb6, 0xf2, 0x72, 0x29, 0xe6, 0xac, 0xb3, 0x0e, 0x0b, 0xf3, 0xcb, 0x2f, 0xa5, 0x9c, 0xb1,
+    0xa1, 0x55, 0xbb, 0x93, 0x24, 0x5a, 0xb9, 0x99, 0xb7, 0xbe, 0x76, 0xd2, 0x6b, 0x99, 0x75, 0x92,
+    0x75, 0xbc, 0x5d, 0xa2, 0x4b, 0xd2, 0x91, 0xb8, 0xd0, 0x6d, 0xe5, 0xf5, 0xad, 0x2c, 0xd2, 0x2f,
+    0x50, 0x53, 0x8e, 0x35, 0x13, 0x77, 0x76, 0x0f, 0x15, 0x72, 0x05, 0xaf, 0xae, 0x44, 0x5e, 0xc5,
+    0xab, 0xbb, 0xb2, 0x2c, 0xe8, 0xae, 0xa8, 0xc8, 0x13, 0xa5, 0xe7, 0xab, 0x09, 0x00, 0x93, 0x14,
+    0x5f, 0x95, 0x98, 0x93, 0x4c, 0xbf, 0x36, 0x3a, 0xb9, 0x38, 0x34, 0xba, 0xf5, 0x14, 0xd9, 0x64,
+    0x5a, 0x2a, 0x0b, 0x5b, 0x15, 0x80, 0xb5, 0xf5, 0x66, 0x9f, 0xa5, 0x9c, 0xc7, 0x09, 0x9d, 0xc5,
+    0x55, 0xac, 0x08, 0x97, 0x57, 0xc6, 0x1c, 0x02, 0xd7, 0x97, 0x8c, 0x70, 0xce, 0xaa, 0x49, 0xcc,
+    0xcb, 0x0c, 0x64, 0xee, 0x1c, 0x86, 0x81, 0x18, 0xd7, 0xb1, 0x92, 0xea, 0x74, 0x28, 0x25, 0xef,
+    0x44, 0xa7, 0x6f, 0x95, 0x59, 0xe5, 0x34, 0x17, 0x24, 0x7d, 0x2b, 0x6f, 0xe9, 0x61, 0xb7, 0x69,
+    0x1a, 0x76, 0xd3, 0xd6, 0x5d, 0xbe, 0x36, 0x4e, 0x5b, 0x9b, 0x74, 0x6f, 0x6d, 0xd0, 0xad, 0x08,
+    0x46, 0xa1, 0x6d, 0x45, 0xae, 0xa2, 0x2f, 0x56, 0x17, 0xe4, 0xd3, 0xb9, 0x5a, 0x71, 0x4c, 0xdf,
+    0xc0, 0xd5, 0xe4, 0x06, 0x62, 0xe6, 0x41, 0x06, 0x7e, 0xd2, 0x47, 0x56, 0xc8, 0x38, 0x79, 0x66,
+    0x75, 0x1e, 0x9e, 0xbf, 0xa7, 0x7c, 0xd6, 0x45, 0x97, 0x3f, 0x05, 0xe1, 0x7c, 0x69, 0x67, 0x95,
+    0x27, 0xb9, 0xf6, 0xca, 0x31, 0x4e, 0xb2, 0x89, 0x33, 0xa8, 0xb5, 0xfc, 0x38, 0x27, 0xef, 0x45,
+    0x92, 0x4c, 0x00, 0x03, 0x41, 0x58, 0xc8, 0x1e, 0x7b, 0x8f, 0x42, 0x9c, 0x24, 0x24, 0x3e, 0xb0,
+    0x71, 0x64, 0xef, 0x85, 0xc2, 0xa7, 0xcc, 0x87, 0xa3, 0x9a, 0xb1, 0x0a, 0xfa, 0x8c, 0xdc, 0x2c,
+    0x91, 0x61, 0x07, 0x12, 0x58, 0xef, 0xfd, 0x15, 0x5d, 0x33, 0x9b, 0xc9, 0x53, 0xe0, 0x8c, 0x34,
+    0xab, 0x3b, 0x26, 0x74, 0xec, 0x38, 0x95, 0xfb, 0x68, 0x0c, 0xe7, 0xe1, 0x13, 0xf9, 0x70, 0xce,
+    0x32, 0xe8, 0x40, 0x66, 0x9d, 0xf4, 0xeb, 0xf2, 0xee, 0xa9, 0x47, 0x5d, 0xec, 0xfb, 0x4a, 0xe2,
+    0x1d, 0x05, 0xe6, 0x13, 0x13, 0x5e, 0xd0, 0x5f, 0xb2, 0x91, 0x67, 0x73, 0x76, 0x43, 0x62, 0xd0,
+    0x28, 0x4f, 0x94, 0x6e, 0x22, 0xff, 0xfc, 0xa3, 0x49, 0x5c, 0xd8, 0xee, 0x70, 0xcb, 0xd5, 0xef,
+    0x1e, 0x21, 0xd7, 0x06, 0xe0, 0x9b, 0x25, 0x1b, 0x97, 0xbd, 0xea, 0xe8, 0xdd, 0xc9, 0xe1, 0xc7,
+    0x95, 0xb7, 0xcf, 0xa6, 0xd8, 0x4b, 0x51, 0x49, 0x9e, 0x41, 0xea, 0xec, 0xf4, 0x74, 0x65, 0xb8,
+    0x86, 0x4c, 0x3f, 0x3c, 0x35, 0x3c, 0x56, 0x36, 0x3c, 0x16, 0x25, 0x98, 0x5a, 0x19, 0xa2, 0x67,
+    0xd1, 0xf8, 0x4f, 0xea, 0xfc, 0xb6, 0x2f, 0xc1, 0x6c, 0x22, 0xff, 0xf0, 0x8b, 0x99, 0xbc, 0x0d,
+    0x9c, 0x0f, 0x3f, 0x3c, 0x91, 0xcc, 0x3f, 0x39, 0x5a, 0x50, 0xba, 0x00, 0xa7, 0x0b, 0xad, 0x28,
+    0xc7, 0xea, 0x7a, 0xab, 0xa8, 0x56, 0x2b, 0xf1, 0xad, 0xc1, 0xaa, 0xa6, 0x3b, 0x5a, 0x36, 0xdd,
+    0x71, 0x37, 0xbf, 0x32, 0x19, 0x77, 0xf5, 0xef, 0xcd, 0xc6, 0x5d, 0xfd, 0x87, 0x4b, 0xff, 0x03,
+    0xe7, 0x07, 0x85, 0x0c, 0xd0, 0x24, 0x00, 0x00,
+};
+
+#endif // WEB_ASSETS_H
@@ -3,45 +3,46 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "system_log.h"
 
 #ifdef ENABLE_WIFI
-#include <WebServer.h>
-#include <vector>
+#include "http_server.h"
+#include "rollup_engine.h"
 
 // Web server functions
+// initWebServer() registers the routes and starts the "http" task, which
+// serves clients and event stream subscribers from then on
 void initWebServer();
-void handleWebServer();
-void addLogEntry(String message, String level = "INFO");
-String getStatusJSON();
-String getLogsJSON();
+String getLogsJSON(uint32_t after, size_t limit);
 String getSystemInfoJSON();
 String getOTAStatusJSON();
 String getOTAInfoJSON();
-String getMainPageHTML();
-String getCSS();
-String getJavaScript();
-
-// Log management
-struct LogEntry {
-    String timestamp;
-    String level;     // INFO, WARN, ERROR
-    String message;
-};
+String getSchedulerJSON();
+String getBeamFilterJSON();
+String getConfigJSON();
+String getBeamStatsJSON();
+void streamHistoryJSON(uint32_t from, uint32_t to);
+void streamRollupJSON(RollupResolution resolution, uint32_t from, uint32_t to);
+void sendDashboard();
+void sendStatusSnapshot();
+void sendSystemStatus();
+void sendMetrics();
 
 // Web server variables
-extern WebServer server;
+extern HttpServer server;
 extern bool webServerActive;
-extern std::vector<LogEntry> logEntries;
 
 // Constants
-#define MAX_LOG_ENTRIES 100
 #define WEB_SERVER_PORT 80
+#define WEB_SERVER_POLL_MS 20           // select() timeout, bounds SSE servicing latency
+#define WEB_SERVER_TASK_STACK 8192      // JSON documents
+#define WEB_SERVER_TASK_CORE 0          // Protocol core; the Arduino loop runs on core 1
+#define STATUS_SNAPSHOT_BYTES 1536      // Serialized /api/status document
+#define STATUS_SAMPLE_INTERVAL_MS 1000  // LED, IP and counters refresh period
 
 #else
 // WiFi disabled stubs
 void initWebServer();
-void handleWebServer();
-void addLogEntry(String message, String level = "INFO");
 #endif
 
 #endif // WEB_SERVER_H
\ No newline at end of file
@@ -25,10 +25,14 @@
 #define AP_PASSWORD "setup123"       // Access Point password for setup
 #define SETUP_TIMEOUT 300000         // 5 minutes setup timeout
 
-// WiFi Settings
-#define WIFI_CONNECT_TIMEOUT 10000    // 10 seconds timeout
-#define WIFI_RETRY_DELAY 1000         // 1 second between retries
-#define WIFI_MAX_RETRIES 5            // Maximum connection attempts
+// WiFi Settings (see wifi_link.h). Defaults for the wifi.* settings, which
+// can be changed at runtime (see config_store.h)
+#define WIFI_CONNECT_TIMEOUT 10000    // Abandon an attempt without an IP after 10 seconds
+#define WIFI_BACKOFF_MIN_MS 1000      // Wait after the first failed attempt, doubling per failure
+#define WIFI_BACKOFF_MAX_MS 60000     // Longest wait between attempts
+#define WIFI_FAST_RECONNECT           // Reconnect to the last BSSID and channel without scanning (default)
+// #define WIFI_FAST_RECONNECT_STATIC_IP  // Also reuse the last DHCP lease as a static IP (skips
+                                          // DHCP; only safe if the router reserves the address)
 
 // WiFi Status LED (optional)
 #define WIFI_STATUS_LED 48            // Built-in LED for ESP32-S3
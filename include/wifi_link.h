@@ -0,0 +1,93 @@
+#ifndef WIFI_LINK_H
+#define WIFI_LINK_H
+
+#include <stdint.h>
+#include <atomic>
+
+// WiFi station connection state machine. The WiFi event task reports what
+// happened through postEvent(); the main loop calls poll(), which applies
+// the latest event and the timeouts and starts or stops connection
+// attempts through the injected driver functions. Nothing here waits, so
+// an outage costs the caller a few microseconds per poll. Time comes from
+// an injected millisecond clock; no hardware dependencies.
+//
+//   IDLE         Not started
+//   ASSOCIATING  Attempt running; fails on a disconnect or after connectTimeoutMs
+//   CONNECTED    Got an IP address; losing the link starts a new attempt at once
+//   BACKOFF      Waiting after a failed attempt: backoffMinMs, doubling per
+//                failure in a row, capped at backoffMaxMs
+
+enum WiFiLinkState {
+    WIFI_LINK_IDLE,
+    WIFI_LINK_ASSOCIATING,
+    WIFI_LINK_CONNECTED,
+    WIFI_LINK_BACKOFF
+};
+
+enum WiFiLinkEvent {
+    WIFI_LINK_EVENT_NONE,
+    WIFI_LINK_EVENT_GOT_IP,
+    WIFI_LINK_EVENT_DISCONNECTED,   // Also lost IP
+};
+
+typedef uint32_t (*WiFiLinkClockFn)();              // Current time in milliseconds
+typedef void (*WiFiLinkConnectFn)(uint32_t attempt); // Start attempt 'attempt' (counts from 1)
+typedef void (*WiFiLinkDisconnectFn)();             // Abandon the current attempt
+
+struct WiFiLinkConfig {
+    uint32_t connectTimeoutMs;
+    uint32_t backoffMinMs;
+    uint32_t backoffMaxMs;
+};
+
+struct WiFiLinkStats {
+    uint32_t attempts;          // Connection attempts started
+    uint32_t connects;          // Attempts that got an IP address
+    uint32_t disconnects;       // Links lost after connecting
+    uint32_t timeouts;          // Attempts abandoned after connectTimeoutMs
+    uint8_t failures;           // Failed attempts in a row (backoff level)
+};
+
+class WiFiLink {
+public:
+    WiFiLink(WiFiLinkClockFn clock, WiFiLinkConnectFn connect, WiFiLinkDisconnectFn disconnect,
+             const WiFiLinkConfig& config);
+
+    // Takes effect from the next timeout or backoff decision
+    void setConfig(const WiFiLinkConfig& config) { this->config = config; }
+
+    // Start connecting (from IDLE); stop() abandons any attempt
+    void start();
+    void stop();
+
+    // Safe from another task or core; only the latest event is kept
+    void postEvent(WiFiLinkEvent event);
+
+    // Apply the latest event and timeouts. Returns true if the state changed.
+    bool poll();
+
+    WiFiLinkState getState() const { return state; }
+    bool isConnected() const { return state == WIFI_LINK_CONNECTED; }
+    // Time left in BACKOFF, 0 otherwise
+    uint32_t getBackoffRemainingMs() const;
+    WiFiLinkStats getStats() const { return stats; }
+
+    static const char* stateName(WiFiLinkState state);
+
+private:
+    void beginAttempt(uint32_t now);
+    void failAttempt(uint32_t now);
+
+    WiFiLinkClockFn clockFn;
+    WiFiLinkConnectFn connectFn;
+    WiFiLinkDisconnectFn disconnectFn;
+    WiFiLinkConfig config;
+
+    std::atomic<uint8_t> pendingEvent{WIFI_LINK_EVENT_NONE};
+    WiFiLinkState state = WIFI_LINK_IDLE;
+    uint32_t stateStartMs = 0;
+    uint32_t backoffMs = 0;
+    WiFiLinkStats stats = {};
+};
+
+#endif // WIFI_LINK_H
@@ -4,11 +4,13 @@
 #include <Arduino.h>
 #include <WiFi.h>
 #include "config.h"
+#include "wifi_link.h"
 
-// WiFi function declarations
+// WiFi function declarations. Connecting is event-driven (see
+// wifi_link.h): initWiFi() starts it and checkWiFiConnection() advances it
+// from the main loop; neither waits for the network.
 void initWiFi();
 void connectToWiFi();
-bool connectToWiFi(const String& ssid, const String& password);
 void checkWiFiConnection();
 bool isWiFiConnected();
 String getWiFiStatusString();
@@ -22,7 +24,8 @@ void clearWiFiCredentials();
 
 // WiFi status variables
 extern bool wifiConnected;
-extern unsigned long lastWiFiCheck;
-extern int wifiRetryCount;
+#ifdef ENABLE_WIFI
+extern WiFiLink wifiLink;
+#endif
 
 #endif // WIFI_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "beam_analytics.h"
+#include "config.h"
+#include <string.h>
+
+#define MS_PER_HOUR 3600000UL
+
+BeamAnalytics beamAnalytics({BEAM_CLASS_GLITCH_MAX_MS, BEAM_CLASS_PERSON_MAX_MS, BEAM_CLASS_CAR_MAX_MS});
+
+BeamAnalytics::BeamAnalytics(const BeamClassThresholds& thresholds) : thresholds(thresholds) {
+    reset();
+}
+
+void BeamAnalytics::reset() {
+    memset(dwellHistogram, 0, sizeof(dwellHistogram));
+    memset(classCounts, 0, sizeof(classCounts));
+    memset(hourlyCounts, 0, sizeof(hourlyCounts));
+    memset(hourlyStamp, 0, sizeof(hourlyStamp));
+    passCount = 0;
+    longestDwellMs = 0;
+    longestDwellEndMs = 0;
+    totalDwellMs = 0;
+    obstructed = false;
+    obstructionStartMs = 0;
+}
+
+int BeamAnalytics::dwellBucketFor(uint32_t dwellMs) {
+    // Bucket = number of significant bits: 0 -> 0, 1 -> 1, 2..3 -> 2, 4..7 -> 3, ...
+    int bucket = dwellMs == 0 ? 0 : 32 - __builtin_clz(dwellMs);
+    return bucket < BEAM_DWELL_BUCKETS ? bucket : BEAM_DWELL_BUCKETS - 1;
+}
+
+uint32_t BeamAnalytics::dwellBucketUpperMs(int bucket) {
+    if (bucket >= BEAM_DWELL_BUCKETS - 1) {
+        return 0;
+    }
+    return 1UL << bucket;
+}
+
+BeamPassClass BeamAnalytics::classify(uint32_t dwellMs) const {
+    if (dwellMs < thresholds.glitchMaxMs) {
+        return BEAM_PASS_GLITCH;
+    }
+    if (dwellMs <= thresholds.personMaxMs) {
+        return BEAM_PASS_PERSON;
+    }
+    if (dwellMs <= thresholds.carMaxMs) {
+        return BEAM_PASS_CAR;
+    }
+    return BEAM_PASS_DOOR;
+}
+
+const char* BeamAnalytics::className(BeamPassClass passClass) {
+    switch (passClass) {
+        case BEAM_PASS_GLITCH: return "glitch";
+        case BEAM_PASS_PERSON: return "person";
+        case BEAM_PASS_CAR: return "car";
+        case BEAM_PASS_DOOR: return "door";
+        default: return "unknown";
+    }
+}
+
+void BeamAnalytics::recordTransition(bool beamBroken, uint32_t timestampMs) {
+    if (beamBroken) {
+        obstructed = true;
+        obstructionStartMs = timestampMs;
+        return;
+    }
+
+    if (!obstructed) {
+        return;  // Clear without a preceding break (e.g. first event after boot)
+    }
+    obstructed = false;
+
+    uint32_t dwellMs = timestampMs - obstructionStartMs;
+    dwellHistogram[dwellBucketFor(dwellMs)]++;
+    classCounts[classify(dwellMs)]++;
+    passCount++;
+    totalDwellMs += dwellMs;
+
+    if (dwellMs > longestDwellMs) {
+        longestDwellMs = dwellMs;
+        longestDwellEndMs = timestampMs;
+    }
+
+    // Rolling per-hour counts: a slot is reused once its hour has passed
+    uint32_t hour = timestampMs / MS_PER_HOUR;
+    int slot = hour % BEAM_HOURLY_SLOTS;
+    if (hourlyStamp[slot] != hour) {
+        hourlyStamp[slot] = hour;
+        hourlyCounts[slot] = 0;
+    }
+    hourlyCounts[slot]++;
+}
+
+uint32_t BeamAnalytics::getHourlyCount(uint32_t nowMs, int hoursAgo) const {
+    uint32_t currentHour = nowMs / MS_PER_HOUR;
+    if (hoursAgo < 0 || hoursAgo >= BEAM_HOURLY_SLOTS || (uint32_t)hoursAgo > currentHour) {
+        return 0;
+    }
+    uint32_t hour = currentHour - hoursAgo;
+    int slot = hour % BEAM_HOURLY_SLOTS;
+    return hourlyStamp[slot] == hour ? hourlyCounts[slot] : 0;
+}
@@ -0,0 +1,187 @@
+#include "beam_filter.h"
+#include <string.h>
+
+// Wrap-safe "a is at or after b" for 32-bit microsecond timestamps
+static inline bool timeReached(uint32_t now, uint32_t deadline) {
+    return (int32_t)(now - deadline) >= 0;
+}
+
+static inline uint32_t windowMask(uint8_t length) {
+    return length >= 32 ? 0xFFFFFFFFUL : ((1UL << length) - 1);
+}
+
+BeamFilterConfig BeamFilter::configure(const BeamFilterConfig& newConfig, bool beamBroken, uint32_t nowUs) {
+    config = newConfig;
+
+    if (config.integrateUs == 0) {
+        config.integrateUs = 1;
+    }
+    if (config.sampleUs == 0) {
+        config.sampleUs = 1;
+    }
+    if (config.majorityM < 1) {
+        config.majorityM = 1;
+    } else if (config.majorityM > BEAM_FILTER_MAX_WINDOW) {
+        config.majorityM = BEAM_FILTER_MAX_WINDOW;
+    }
+    // N must be a strict majority so both directions cannot hold at once
+    uint8_t minimumN = config.majorityM / 2 + 1;
+    if (config.majorityN < minimumN) {
+        config.majorityN = minimumN;
+    } else if (config.majorityN > config.majorityM) {
+        config.majorityN = config.majorityM;
+    }
+
+    output = beamBroken;
+    raw = beamBroken;
+    deviating = false;
+    lastTimeUs = nowUs;
+    lastRawEdgeUs = nowUs;
+    lockoutActive = false;
+    lockoutUntilUs = nowUs;
+    integrator = beamBroken ? config.integrateUs : 0;
+    window = beamBroken ? windowMask(config.majorityM) : 0;
+    nextSampleUs = nowUs + config.sampleUs;
+
+    return config;
+}
+
+void BeamFilter::resetStats() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+void BeamFilter::setOutput(bool state, uint32_t timestampUs) {
+    output = state;
+    deviating = false;
+    stats.acceptedChanges++;
+    if (callback != nullptr) {
+        callback(state, timestampUs);
+    }
+}
+
+void BeamFilter::processEdge(uint32_t timestampUs, bool rawBroken) {
+    // Edges queued just after the last advance() can carry an earlier time
+    if (!timeReached(timestampUs, lastTimeUs)) {
+        timestampUs = lastTimeUs;
+    }
+    advance(timestampUs);
+
+    if (rawBroken == raw) {
+        return;  // Repeated level (edge pair faster than the ISR)
+    }
+    stats.rawEdges++;
+    raw = rawBroken;
+    lastRawEdgeUs = timestampUs;
+
+    if (raw != output) {
+        deviating = true;
+    } else if (deviating) {
+        // Raw level came back before the filter switched: a rejected glitch
+        stats.rejectedGlitches++;
+        deviating = false;
+    }
+
+    if (config.mode == BEAM_FILTER_LOCKOUT && !lockoutActive && raw != output) {
+        setOutput(raw, timestampUs);
+        lockoutActive = true;
+        lockoutUntilUs = timestampUs + config.lockoutUs;
+    }
+}
+
+void BeamFilter::advance(uint32_t nowUs) {
+    if (!timeReached(nowUs, lastTimeUs) || nowUs == lastTimeUs) {
+        return;
+    }
+
+    switch (config.mode) {
+        case BEAM_FILTER_LOCKOUT:
+            advanceLockout(nowUs);
+            break;
+        case BEAM_FILTER_INTEGRATOR:
+            advanceIntegrator(nowUs);
+            break;
+        case BEAM_FILTER_MAJORITY:
+            advanceMajority(nowUs);
+            break;
+    }
+    lastTimeUs = nowUs;
+}
+
+void BeamFilter::advanceLockout(uint32_t nowUs) {
+    // A deferred change starts a new lockout, which can also expire before
+    // nowUs; at most two iterations since raw is constant here
+    while (lockoutActive && timeReached(nowUs, lockoutUntilUs)) {
+        lockoutActive = false;
+        if (raw != output) {
+            uint32_t effectiveUs = lockoutUntilUs;
+            setOutput(raw, lastRawEdgeUs);
+            lockoutActive = true;
+            lockoutUntilUs = effectiveUs + config.lockoutUs;
+        }
+    }
+}
+
+void BeamFilter::advanceIntegrator(uint32_t nowUs) {
+    uint32_t elapsed = nowUs - lastTimeUs;
+
+    if (raw) {
+        uint32_t headroom = config.integrateUs - integrator;
+        integrator = elapsed >= headroom ? config.integrateUs : integrator + elapsed;
+        if (integrator == config.integrateUs && !output) {
+            setOutput(true, lastRawEdgeUs);
+        }
+    } else {
+        integrator = elapsed >= integrator ? 0 : integrator - elapsed;
+        if (integrator == 0 && output) {
+            setOutput(false, lastRawEdgeUs);
+        }
+    }
+}
+
+void BeamFilter::advanceMajority(uint32_t nowUs) {
+    uint32_t mask = windowMask(config.majorityM);
+    uint32_t saturated = raw ? mask : 0;
+
+    while (timeReached(nowUs, nextSampleUs)) {
+        if (window == saturated && output == raw) {
+            // Nothing can change until the next raw edge: jump the sample
+            // clock past nowUs instead of stepping through idle samples
+            uint32_t skipped = (nowUs - nextSampleUs) / config.sampleUs + 1;
+            nextSampleUs += skipped * config.sampleUs;
+            break;
+        }
+
+        window = ((window << 1) | (raw ? 1 : 0)) & mask;
+        uint8_t brokenSamples = __builtin_popcount(window);
+        uint8_t clearSamples = config.majorityM - brokenSamples;
+
+        if (!output && brokenSamples >= config.majorityN) {
+            setOutput(true, lastRawEdgeUs);
+        } else if (output && clearSamples >= config.majorityN) {
+            setOutput(false, lastRawEdgeUs);
+        }
+        nextSampleUs += config.sampleUs;
+    }
+}
+
+const char* BeamFilter::modeName(BeamFilterMode mode) {
+    switch (mode) {
+        case BEAM_FILTER_LOCKOUT: return "lockout";
+        case BEAM_FILTER_INTEGRATOR: return "integrator";
+        case BEAM_FILTER_MAJORITY: return "majority";
+        default: return "unknown";
+    }
+}
+
+bool BeamFilter::parseMode(const char* name, BeamFilterMode& mode) {
+    if (strcmp(name, "lockout") == 0) {
+        mode = BEAM_FILTER_LOCKOUT;
+    } else if (strcmp(name, "integrator") == 0) {
+        mode = BEAM_FILTER_INTEGRATOR;
+    } else if (strcmp(name, "majority") == 0) {
+        mode = BEAM_FILTER_MAJORITY;
+    } else {
+        return false;
+    }
+    return true;
+}
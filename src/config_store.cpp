@@ -0,0 +1,210 @@
+#include "config_store.h"
+#include <Preferences.h>
+#include "config.h"
+#include "beam_filter.h"
+#include "ota_config.h"
+#include "metrics.h"
+
+ConfigStore configStore;
+
+MetricCounter configWriteRequestsMetric("garage_config_write_requests_total", "Configuration values submitted");
+MetricCounter configNvsWritesMetric("garage_config_nvs_writes_total", "Configuration keys written to NVS");
+
+#ifdef WIFI_FAST_RECONNECT
+#define CONFIG_FAST_RECONNECT_DEFAULT 1
+#else
+#define CONFIG_FAST_RECONNECT_DEFAULT 0
+#endif
+
+// Grouped by namespace, so a commit opens each one once
+static const ConfigEntry configSchema[CONFIG_KEY_COUNT] = {
+    // name                       namespace key             type           default                        string  min    max        secret
+    {"wifi.ssid",                 "wifi", "ssid",         CONFIG_STRING, 0,                             "",     0,     32,        false},
+    {"wifi.password",             "wifi", "password",     CONFIG_STRING, 0,                             "",     0,     64,        true},
+    {"wifi.connect_timeout_ms",   "wifi", "connect_ms",   CONFIG_UINT,   WIFI_CONNECT_TIMEOUT,          nullptr, 1000,  120000,    false},
+    {"wifi.backoff_min_ms",       "wifi", "backoff_min",  CONFIG_UINT,   WIFI_BACKOFF_MIN_MS,           nullptr, 100,   60000,     false},
+    {"wifi.backoff_max_ms",       "wifi", "backoff_max",  CONFIG_UINT,   WIFI_BACKOFF_MAX_MS,           nullptr, 1000,  3600000,   false},
+    {"wifi.fast_reconnect",       "wifi", "fast",         CONFIG_BOOL,   CONFIG_FAST_RECONNECT_DEFAULT, nullptr, 0,     1,         false},
+    {"ota.check_interval_ms",     "ota",  "check_ms",     CONFIG_UINT,   OTA_CHECK_INTERVAL,            nullptr, 10000, 86400000,  false},
+    {"ota.backoff_max_ms",        "ota",  "backoff_max",  CONFIG_UINT,   OTA_BACKOFF_MAX_MS,            nullptr, 60000, 86400000,  false},
+    {"ota.resume_attempts",       "ota",  "resume_tries", CONFIG_UINT,   OTA_RESUME_ATTEMPTS,           nullptr, 0,     100,       false},
+    // Beam glitch filter (see beam_filter.h); mode is the BeamFilterMode value
+    {"beam.filter_mode",          "beam", "mode",         CONFIG_UINT,   E3JK_FILTER_MODE,              nullptr, 0,     BEAM_FILTER_MAJORITY, false},
+    {"beam.lockout_us",           "beam", "lockout_us",   CONFIG_UINT,   E3JK_DEBOUNCE_TIME * 1000UL,   nullptr, 0,     BEAM_FILTER_MAX_LOCKOUT_US, false},
+    {"beam.integrate_us",         "beam", "integrate_us", CONFIG_UINT,   E3JK_INTEGRATE_US,             nullptr, 1,     BEAM_FILTER_MAX_INTEGRATE_US, false},
+    {"beam.sample_us",            "beam", "sample_us",    CONFIG_UINT,   E3JK_MAJORITY_SAMPLE_US,       nullptr, 1,     BEAM_FILTER_MAX_SAMPLE_US, false},
+    {"beam.majority_n",           "beam", "majority_n",   CONFIG_UINT,   E3JK_MAJORITY_N,               nullptr, 1,     BEAM_FILTER_MAX_WINDOW, false},
+    {"beam.majority_m",           "beam", "majority_m",   CONFIG_UINT,   E3JK_MAJORITY_M,               nullptr, 1,     BEAM_FILTER_MAX_WINDOW, false},
+    // Read when the history job is registered, so a change applies after a restart
+    {"history.sample_interval_ms", "history", "sample_ms", CONFIG_UINT,  HISTORY_SAMPLE_INTERVAL,       nullptr, 1000,  3600000,   false},
+};
+
+const ConfigEntry& ConfigStore::entry(ConfigKey key) {
+    return configSchema[key];
+}
+
+ConfigKey ConfigStore::find(const char* name) {
+    for (int i = 0; i < CONFIG_KEY_COUNT; i++) {
+        if (strcmp(configSchema[i].name, name) == 0) {
+            return (ConfigKey)i;
+        }
+    }
+    return CONFIG_KEY_COUNT;
+}
+
+bool ConfigStore::accepts(ConfigKey key, uint32_t value) {
+    const ConfigEntry& config = configSchema[key];
+    return config.type != CONFIG_STRING && value >= config.min && value <= config.max;
+}
+
+bool ConfigStore::accepts(ConfigKey key, const String& value) {
+    const ConfigEntry& config = configSchema[key];
+    return config.type == CONFIG_STRING && value.length() >= config.min && value.length() <= config.max;
+}
+
+void ConfigStore::begin() {
+    if (mutex == nullptr) {
+        mutex = xSemaphoreCreateMutex();
+    }
+    lock();
+    Preferences prefs;
+    const char* opened = nullptr;
+    bool exists = false;
+    for (int i = 0; i < CONFIG_KEY_COUNT; i++) {
+        const ConfigEntry& config = configSchema[i];
+        if (opened == nullptr || strcmp(opened, config.nvsNamespace) != 0) {
+            if (exists) {
+                prefs.end();
+            }
+            opened = config.nvsNamespace;
+            exists = prefs.begin(opened, true);  // Fails if nothing was saved yet
+        }
+        bool stored = exists && prefs.isKey(config.nvsKey);
+        if (config.type == CONFIG_STRING) {
+            strings[i] = stored ? prefs.getString(config.nvsKey, config.defaultString) : String(config.defaultString);
+        } else {
+            uint32_t value = stored ? prefs.getUInt(config.nvsKey, config.defaultValue) : config.defaultValue;
+            values[i] = accepts((ConfigKey)i, value) ? value : config.defaultValue;
+        }
+    }
+    if (exists) {
+        prefs.end();
+    }
+    dirty = 0;
+    generation++;
+    unlock();
+}
+
+void ConfigStore::lock() {
+    if (mutex) {
+        xSemaphoreTake(mutex, portMAX_DELAY);
+    }
+}
+
+void ConfigStore::unlock() {
+    if (mutex) {
+        xSemaphoreGive(mutex);
+    }
+}
+
+uint32_t ConfigStore::getUInt(ConfigKey key) {
+    return values[key];         // A 32-bit read needs no lock
+}
+
+String ConfigStore::getString(ConfigKey key) {
+    lock();
+    String value = strings[key];
+    unlock();
+    return value;
+}
+
+bool ConfigStore::set(ConfigKey key, uint32_t value) {
+    configWriteRequestsMetric.increment();
+    if (!accepts(key, value)) {
+        return false;
+    }
+    lock();
+    if (values[key] != value) {
+        values[key] = value;
+        dirty |= 1UL << key;
+        stats.changes++;
+        generation++;
+    }
+    unlock();
+    return true;
+}
+
+bool ConfigStore::set(ConfigKey key, const String& value) {
+    configWriteRequestsMetric.increment();
+    if (!accepts(key, value)) {
+        return false;
+    }
+    lock();
+    if (strings[key] != value) {
+        strings[key] = value;
+        dirty |= 1UL << key;
+        stats.changes++;
+        generation++;
+    }
+    unlock();
+    return true;
+}
+
+uint32_t ConfigStore::commit() {
+    lock();
+    if (dirty == 0) {
+        unlock();
+        return 0;
+    }
+    stats.commits++;
+    Preferences prefs;
+    const char* opened = nullptr;
+    uint32_t written = 0;
+    for (int i = 0; i < CONFIG_KEY_COUNT; i++) {
+        if ((dirty & (1UL << i)) == 0) {
+            continue;
+        }
+        const ConfigEntry& config = configSchema[i];
+        if (opened == nullptr || strcmp(opened, config.nvsNamespace) != 0) {
+            if (opened != nullptr) {
+                prefs.end();
+            }
+            opened = config.nvsNamespace;
+            prefs.begin(opened, false);
+        }
+
+        // A value changed and changed back is still dirty; NVS decides
+        bool same;
+        if (config.type == CONFIG_STRING) {
+            same = prefs.isKey(config.nvsKey) && prefs.getString(config.nvsKey, "") == strings[i];
+        } else {
+            same = prefs.isKey(config.nvsKey) && prefs.getUInt(config.nvsKey, 0) == values[i];
+        }
+        if (same) {
+            stats.nvsSkipped++;
+            continue;
+        }
+        if (config.type == CONFIG_STRING) {
+            prefs.putString(config.nvsKey, strings[i]);
+        } else {
+            prefs.putUInt(config.nvsKey, values[i]);
+        }
+        written++;
+    }
+    if (opened != nullptr) {
+        prefs.end();
+    }
+    dirty = 0;
+    stats.nvsWrites += written;
+    unlock();
+    configNvsWritesMetric.increment(written);
+    return written;
+}
+
+ConfigStoreStats ConfigStore::getStats() {
+    lock();
+    ConfigStoreStats copy = stats;
+    unlock();
+    copy.setRequests = configWriteRequestsMetric.get();
+    return copy;
+}
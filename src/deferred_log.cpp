@@ -0,0 +1,105 @@
+#include "deferred_log.h"
+#include <stdio.h>
+#include <string.h>
+
+// Format one conversion with the captured argument, re-deriving the length
+// modifier from the stored type so the call-site modifier does not matter
+static int formatLogArg(char* out, size_t size, const char* spec, size_t specLength,
+                        char conversion, uint8_t type, const DeferredLogArg& arg) {
+    // spec = "%" + flags/width/precision, without length modifier or conversion
+    char format[24];
+    if (specLength > sizeof(format) - 4) {
+        specLength = sizeof(format) - 4;
+    }
+    memcpy(format, spec, specLength);
+    char* end = format + specLength;
+
+    switch (conversion) {
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+            *end++ = 'l';
+            *end++ = 'l';
+            *end++ = conversion;
+            *end = '\0';
+            if (type == LOG_ARG_DOUBLE) {
+                return snprintf(out, size, format, (long long)arg.d);
+            }
+            return snprintf(out, size, format, (long long)arg.i);
+        case 'c':
+            *end++ = 'c';
+            *end = '\0';
+            return snprintf(out, size, format, (int)arg.i);
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            *end++ = conversion;
+            *end = '\0';
+            if (type == LOG_ARG_INT) {
+                return snprintf(out, size, format, (double)arg.i);
+            }
+            if (type == LOG_ARG_UINT) {
+                return snprintf(out, size, format, (double)arg.u);
+            }
+            return snprintf(out, size, format, arg.d);
+        case 's':
+            *end++ = 's';
+            *end = '\0';
+            return snprintf(out, size, format, type == LOG_ARG_STRING && arg.s ? arg.s : "?");
+        case 'p':
+            *end++ = 'p';
+            *end = '\0';
+            return snprintf(out, size, format, (void*)(uintptr_t)arg.u);
+    }
+    return 0;
+}
+
+size_t formatDeferredLog(const DeferredLogEntry& entry, char* buffer, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+
+    size_t length = 0;
+    uint8_t argIndex = 0;
+    const char* p = entry.format;
+
+    while (*p && length < size - 1) {
+        if (*p != '%') {
+            buffer[length++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            buffer[length++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // Flags, width and precision
+        const char* spec = p++;
+        while (*p && strchr("-+ #0123456789.", *p)) {
+            p++;
+        }
+        size_t specLength = p - spec;
+        // Length modifiers are dropped; the captured type decides
+        while (*p && strchr("hljztL", *p)) {
+            p++;
+        }
+        char conversion = *p;
+        if (conversion == '\0') {
+            break;
+        }
+        p++;
+
+        if (argIndex >= entry.argCount) {
+            continue;  // Missing argument: print nothing
+        }
+        int written = formatLogArg(buffer + length, size - length, spec, specLength,
+                                   conversion, entry.types[argIndex], entry.args[argIndex]);
+        argIndex++;
+        if (written > 0) {
+            length += written;
+        }
+    }
+
+    if (length > size - 1) {
+        length = size - 1;
+    }
+    buffer[length] = '\0';
+    return length;
+}
@@ -0,0 +1,73 @@
+#include "dht22_decoder.h"
+
+bool dht22DecodeBytes(const uint8_t bytes[5], Dht22Reading& reading) {
+    uint8_t checksum = (uint8_t)(bytes[0] + bytes[1] + bytes[2] + bytes[3]);
+    if (checksum != bytes[4]) {
+        return false;
+    }
+
+    uint16_t rawHumidity = ((uint16_t)bytes[0] << 8) | bytes[1];
+    uint16_t rawTemperature = ((uint16_t)(bytes[2] & 0x7F) << 8) | bytes[3];
+
+    reading.humidity = rawHumidity * 0.1f;
+    reading.temperature = rawTemperature * 0.1f;
+    if (bytes[2] & 0x80) {
+        reading.temperature = -reading.temperature;
+    }
+    return true;
+}
+
+Dht22DecodeResult dht22DecodeEdges(const uint32_t* edgeTimesUs, const bool* edgeLevels,
+                                   size_t edgeCount, Dht22Reading& reading) {
+    // Collect the widths of complete high pulses (rising edge -> falling edge).
+    // The data bits are the last 40 of them; anything earlier is the start
+    // pulse release or the 80us response.
+    uint32_t highWidths[DHT22_MAX_EDGES / 2 + 1];
+    size_t highCount = 0;
+    bool haveRise = false;
+    uint32_t riseTime = 0;
+
+    for (size_t i = 0; i < edgeCount; i++) {
+        if (edgeLevels[i]) {
+            haveRise = true;
+            riseTime = edgeTimesUs[i];
+        } else if (haveRise) {
+            if (highCount < sizeof(highWidths) / sizeof(highWidths[0])) {
+                highWidths[highCount++] = edgeTimesUs[i] - riseTime;
+            }
+            haveRise = false;
+        }
+    }
+
+    if (highCount < DHT22_FRAME_BITS) {
+        return DHT22_DECODE_TOO_FEW_EDGES;
+    }
+
+    uint8_t bytes[5] = {0, 0, 0, 0, 0};
+    size_t first = highCount - DHT22_FRAME_BITS;
+    for (size_t bit = 0; bit < DHT22_FRAME_BITS; bit++) {
+        uint32_t width = highWidths[first + bit];
+        if (width > DHT22_MAX_HIGH_PULSE_US) {
+            return DHT22_DECODE_BAD_PULSE;
+        }
+        bytes[bit / 8] <<= 1;
+        if (width > DHT22_BIT_THRESHOLD_US) {
+            bytes[bit / 8] |= 1;
+        }
+    }
+
+    if (!dht22DecodeBytes(bytes, reading)) {
+        return DHT22_DECODE_CHECKSUM;
+    }
+    return DHT22_DECODE_OK;
+}
+
+const char* dht22DecodeResultString(Dht22DecodeResult result) {
+    switch (result) {
+        case DHT22_DECODE_OK: return "OK";
+        case DHT22_DECODE_TOO_FEW_EDGES: return "Too few edges (no response)";
+        case DHT22_DECODE_BAD_PULSE: return "Invalid pulse width";
+        case DHT22_DECODE_CHECKSUM: return "Checksum mismatch";
+        default: return "Unknown";
+    }
+}
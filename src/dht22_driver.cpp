@@ -0,0 +1,80 @@
+#include "dht22_driver.h"
+#include "config.h"
+
+DHT22Driver dht22Driver(DHT22_PIN);
+
+static void IRAM_ATTR dht22EdgeISR() {
+    dht22Driver.captureEdge();
+}
+
+void DHT22Driver::begin() {
+    pinMode(pin, INPUT_PULLUP);
+    state = DHT22_STATE_IDLE;
+    // Schedule the first read once the sensor has settled after power-up
+    lastStartTime = millis() + DHT22_STARTUP_DELAY - DHT22_SAMPLE_INTERVAL;
+}
+
+void IRAM_ATTR DHT22Driver::captureEdge() {
+    uint8_t count = edgeCount;
+    if (count < DHT22_MAX_EDGES) {
+        edgeTimes[count] = micros();
+        edgeLevels[count] = digitalRead(pin) == HIGH;
+        edgeCount = count + 1;
+    }
+}
+
+void DHT22Driver::poll() {
+    switch (state) {
+        case DHT22_STATE_IDLE:
+            if (millis() - lastStartTime >= DHT22_SAMPLE_INTERVAL) {
+                lastStartTime = millis();
+                // Host start pulse: hold the line low for just over 1ms
+                pinMode(pin, OUTPUT);
+                digitalWrite(pin, LOW);
+                phaseStartUs = micros();
+                state = DHT22_STATE_START_PULSE;
+            }
+            break;
+
+        case DHT22_STATE_START_PULSE:
+            if (micros() - phaseStartUs >= DHT22_START_PULSE_US) {
+                // Release the line and let the sensor drive it. The sensor
+                // answers 20-40us later, well after the interrupt is attached.
+                edgeCount = 0;
+                pinMode(pin, INPUT_PULLUP);
+                attachInterrupt(digitalPinToInterrupt(pin), dht22EdgeISR, CHANGE);
+                phaseStartUs = micros();
+                state = DHT22_STATE_CAPTURING;
+            }
+            break;
+
+        case DHT22_STATE_CAPTURING:
+            if (micros() - phaseStartUs >= DHT22_CAPTURE_WINDOW_US) {
+                detachInterrupt(digitalPinToInterrupt(pin));
+                finishCapture();
+                state = DHT22_STATE_IDLE;
+            }
+            break;
+    }
+}
+
+void DHT22Driver::finishCapture() {
+    // Copy out of the volatile capture buffer before decoding
+    uint32_t times[DHT22_MAX_EDGES];
+    bool levels[DHT22_MAX_EDGES];
+    size_t count = edgeCount;
+    for (size_t i = 0; i < count; i++) {
+        times[i] = edgeTimes[i];
+        levels[i] = edgeLevels[i];
+    }
+
+    Dht22Reading reading;
+    lastResult = dht22DecodeEdges(times, levels, count, reading);
+    if (lastResult == DHT22_DECODE_OK) {
+        lastReading = reading;
+        lastReadingTime = millis();
+        readingCount++;
+    } else {
+        errorCount++;
+    }
+}
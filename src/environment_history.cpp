@@ -0,0 +1,130 @@
+#include "environment_history.h"
+#include "config.h"
+#include "sensors.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <esp_timer.h>
+
+TimeSeriesStore environmentHistory;
+RollupEngine environmentRollups;
+
+static SemaphoreHandle_t historyMutex = nullptr;
+
+static void lockHistory() {
+  if (historyMutex) {
+    xSemaphoreTake(historyMutex, portMAX_DELAY);
+  }
+}
+
+static void unlockHistory() {
+  if (historyMutex) {
+    xSemaphoreGive(historyMutex);
+  }
+}
+
+static void initEnvironmentRollups() {
+  size_t bytes = RollupEngine::requiredBytes();
+  uint8_t* memory = nullptr;
+
+  // Rollups are only kept in PSRAM; internal RAM is too small to spare
+  #ifdef BOARD_HAS_PSRAM
+  if (psramFound()) {
+    memory = (uint8_t*)ps_malloc(bytes);
+  }
+  #endif
+
+  if (memory == nullptr || !environmentRollups.begin(memory, bytes)) {
+    Serial.println("Environment rollups disabled - no PSRAM");
+    free(memory);
+    return;
+  }
+
+  Serial.printf("Environment rollups: %u bytes\n", (unsigned)bytes);
+}
+
+uint32_t environmentHistoryTime() {
+  return (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+bool initEnvironmentHistory() {
+  if (historyMutex == nullptr) {
+    historyMutex = xSemaphoreCreateMutex();
+  }
+  initEnvironmentRollups();
+
+  size_t bytes = HISTORY_BUFFER_BYTES;
+  uint8_t* memory = nullptr;
+
+  #ifdef BOARD_HAS_PSRAM
+  if (psramFound()) {
+    memory = (uint8_t*)ps_malloc(bytes);
+  }
+  #endif
+  if (memory == nullptr) {
+    // No PSRAM: keep a shorter history in internal RAM
+    bytes = HISTORY_FALLBACK_BYTES;
+    memory = (uint8_t*)malloc(bytes);
+  }
+
+  if (memory == nullptr || !environmentHistory.begin(memory, bytes)) {
+    Serial.println("Environment history disabled - no memory");
+    free(memory);
+    return false;
+  }
+
+  Serial.printf("Environment history: %u bytes, %u blocks\n",
+                (unsigned)bytes, (unsigned)environmentHistory.getStats().blockCount);
+  return true;
+}
+
+void recordEnvironmentHistory() {
+  if (!environmentHistory.isReady() || isEnvironmentDataStale()) {
+    return;
+  }
+
+  TimeSeriesSample sample;
+  sample.timestamp = environmentHistoryTime();
+  sample.values[HISTORY_SERIES_TEMPERATURE] = currentSensorData.temperature;
+  sample.values[HISTORY_SERIES_HUMIDITY] = currentSensorData.humidity;
+  if (isnan(sample.values[HISTORY_SERIES_TEMPERATURE]) || isnan(sample.values[HISTORY_SERIES_HUMIDITY])) {
+    return;
+  }
+  lockHistory();
+  environmentHistory.append(sample);
+  unlockHistory();
+}
+
+void recordEnvironmentRollup(RollupSeries series, float value) {
+  lockHistory();
+  environmentRollups.addSample(series, environmentHistoryTime(), value);
+  unlockHistory();
+}
+
+uint32_t queryEnvironmentHistory(uint32_t from, uint32_t to, TimeSeriesVisitor visitor, void* context) {
+  lockHistory();
+  uint32_t visited = environmentHistory.query(from, to, visitor, context);
+  unlockHistory();
+  return visited;
+}
+
+TimeSeriesStats getEnvironmentHistoryStats() {
+  lockHistory();
+  TimeSeriesStats stats = environmentHistory.getStats();
+  unlockHistory();
+  return stats;
+}
+
+uint32_t queryEnvironmentRollups(RollupResolution resolution, uint32_t from, uint32_t to,
+                                 RollupVisitor visitor, void* context) {
+  lockHistory();
+  uint32_t visited = environmentRollups.query(resolution, from, to, visitor, context);
+  unlockHistory();
+  return visited;
+}
+
+RollupResolution selectEnvironmentRollupResolution(uint32_t from, uint32_t to, uint32_t points) {
+  lockHistory();
+  RollupResolution resolution = environmentRollups.selectResolution(from, to, points);
+  unlockHistory();
+  return resolution;
+}
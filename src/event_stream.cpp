@@ -0,0 +1,216 @@
+#include "event_stream.h"
+
+#ifdef ENABLE_WIFI
+#include <lwip/sockets.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "http_server.h"
+#include "ota_manager.h"
+#include "sensors.h"
+#include "system_log.h"
+
+extern HttpServer server;
+
+struct EventStreamClient {
+    bool active;
+    int fd;                         // Detached from the HTTP server, owned here
+    char buffer[SSE_CLIENT_BUFFER_BYTES];
+    size_t start;                   // Pending bytes are buffer[start, end)
+    size_t end;
+    uint32_t lastProgressMs;        // Last time the socket accepted data or had nothing pending
+    uint32_t lastSendMs;
+};
+
+static EventStreamClient eventClients[SSE_MAX_CLIENTS];
+static EventStreamStats eventStats = {0, 0, 0, 0, 0};
+
+// Publishers run on the sensor loop, the HTTP task services the sockets
+static SemaphoreHandle_t eventMutex = nullptr;
+
+static void closeEventClient(EventStreamClient& slot, bool evicted) {
+    close(slot.fd);
+    slot.fd = -1;
+    slot.active = false;
+    slot.start = slot.end = 0;
+    eventStats.clients--;
+    if (evicted) {
+        eventStats.evicted++;
+    }
+}
+
+// Push pending bytes without blocking; false if the client is gone
+static bool flushEventClient(EventStreamClient& slot, uint32_t now) {
+    while (slot.start < slot.end) {
+        int sent = send(slot.fd, slot.buffer + slot.start, slot.end - slot.start, MSG_DONTWAIT);
+        if (sent > 0) {
+            slot.start += sent;
+            slot.lastProgressMs = now;
+            slot.lastSendMs = now;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;  // Socket buffer full; try again next pass
+        } else {
+            return false;
+        }
+    }
+    slot.start = slot.end = 0;
+    slot.lastProgressMs = now;
+    return true;
+}
+
+// Queue text for one client; false if it does not fit
+static bool queueEventText(EventStreamClient& slot, const char* text, size_t length) {
+    if (slot.end + length > sizeof(slot.buffer) && slot.start > 0) {
+        memmove(slot.buffer, slot.buffer + slot.start, slot.end - slot.start);
+        slot.end -= slot.start;
+        slot.start = 0;
+    }
+    if (slot.end + length > sizeof(slot.buffer)) {
+        return false;
+    }
+    memcpy(slot.buffer + slot.end, text, length);
+    slot.end += length;
+    return true;
+}
+
+static void deliverEvent(EventStreamClient& slot, const char* text, size_t length, uint32_t now) {
+    if (!queueEventText(slot, text, length)) {
+        LOGW("SSE client too slow - disconnected");
+        closeEventClient(slot, true);
+        return;
+    }
+    if (!flushEventClient(slot, now)) {
+        closeEventClient(slot, false);
+    }
+}
+
+static void publishEvent(const char* type, const char* data) {
+    char text[256];
+    int length = snprintf(text, sizeof(text), "event: %s\ndata: %s\n\n", type, data);
+    if (length <= 0 || length >= (int)sizeof(text)) {
+        return;
+    }
+
+    xSemaphoreTake(eventMutex, portMAX_DELAY);
+    eventStats.published++;
+    uint32_t now = millis();
+    for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+        if (eventClients[i].active) {
+            deliverEvent(eventClients[i], text, length, now);
+        }
+    }
+    xSemaphoreGive(eventMutex);
+}
+
+void initEventStream() {
+    if (eventMutex == nullptr) {
+        eventMutex = xSemaphoreCreateMutex();
+    }
+}
+
+void acceptEventStreamClient() {
+    xSemaphoreTake(eventMutex, portMAX_DELAY);
+    EventStreamClient* slot = nullptr;
+    for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+        if (!eventClients[i].active) {
+            slot = &eventClients[i];
+            break;
+        }
+    }
+    if (slot == nullptr) {
+        eventStats.rejected++;
+        xSemaphoreGive(eventMutex);
+        server.send(503, "application/json", "{\"error\":\"too many event stream clients\"}");
+        return;
+    }
+
+    // Take the socket out of the HTTP server; from here on it is only
+    // written by this module, without blocking
+    slot->fd = server.detachClient();
+    fcntl(slot->fd, F_SETFL, fcntl(slot->fd, F_GETFL, 0) | O_NONBLOCK);
+    slot->active = true;
+    slot->start = slot->end = 0;
+    slot->lastProgressMs = slot->lastSendMs = millis();
+    eventStats.clients++;
+    eventStats.connected++;
+
+    // Headers plus the current state, so the client starts in sync
+    SensorData data = getSensorDataSnapshot();
+    char text[256];
+    int length = snprintf(text, sizeof(text),
+                          "HTTP/1.1 200 OK\r\n"
+                          "Content-Type: text/event-stream\r\n"
+                          "Cache-Control: no-cache\r\n"
+                          "Connection: keep-alive\r\n\r\n"
+                          "retry: 2000\n"
+                          "event: beam\ndata: {\"broken\":%s,\"time_ms\":%lu}\n\n",
+                          data.beamBroken ? "true" : "false",
+                          (unsigned long)data.lastStateChangeTime);
+    deliverEvent(*slot, text, length, millis());
+    xSemaphoreGive(eventMutex);
+}
+
+void serviceEventStream() {
+    if (eventStats.clients == 0) {
+        return;
+    }
+    xSemaphoreTake(eventMutex, portMAX_DELAY);
+    uint32_t now = millis();
+    for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+        EventStreamClient& slot = eventClients[i];
+        if (!slot.active) {
+            continue;
+        }
+
+        if (!flushEventClient(slot, now)) {
+            closeEventClient(slot, false);
+        } else if (slot.start < slot.end && now - slot.lastProgressMs > SSE_STALL_TIMEOUT_MS) {
+            LOGW("SSE client stalled - disconnected");
+            closeEventClient(slot, true);
+        } else if (now - slot.lastSendMs > SSE_KEEPALIVE_MS) {
+            deliverEvent(slot, ": keepalive\n\n", 13, now);
+        }
+    }
+    xSemaphoreGive(eventMutex);
+}
+
+EventStreamStats getEventStreamStats() {
+    return eventStats;
+}
+
+void publishBeamEvent(bool beamBroken, uint32_t timestampMs) {
+    if (eventStats.clients == 0) {
+        return;
+    }
+    char data[64];
+    snprintf(data, sizeof(data), "{\"broken\":%s,\"time_ms\":%lu}",
+             beamBroken ? "true" : "false", (unsigned long)timestampMs);
+    publishEvent("beam", data);
+}
+
+void publishEnvironmentEvent(float temperature, float humidity, uint32_t timestampMs) {
+    if (eventStats.clients == 0) {
+        return;
+    }
+    char data[96];
+    snprintf(data, sizeof(data), "{\"temperature\":%.1f,\"humidity\":%.1f,\"time_ms\":%lu}",
+             temperature, humidity, (unsigned long)timestampMs);
+    publishEvent("environment", data);
+}
+
+void publishOTAEvent() {
+    if (eventStats.clients == 0) {
+        return;
+    }
+    char data[192];
+    snprintf(data, sizeof(data), "{\"status\":%d,\"update_available\":%s,\"latest\":\"%s\",\"message\":\"%s\"}",
+             (int)otaManager.getStatus(), otaManager.isUpdateAvailable() ? "true" : "false",
+             otaManager.getLatestVersion().c_str(), otaManager.getStatusMessage().c_str());
+    publishEvent("ota", data);
+}
+
+#else
+// WiFi disabled: nothing to publish to
+void publishBeamEvent(bool, uint32_t) {}
+void publishEnvironmentEvent(float, float, uint32_t) {}
+void publishOTAEvent() {}
+#endif // ENABLE_WIFI
@@ -0,0 +1,861 @@
+#include "http_server.h"
+#include "system_log.h"
+#include <lwip/sockets.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// Request handling time, 1 ms to 5 s
+static const uint32_t httpLatencyBoundsUs[] = {
+    1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 5000000
+};
+
+static const char* statusText(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 202: return "Accepted";
+        case 204: return "No Content";
+        case 302: return "Found";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 408: return "Request Timeout";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default: return "";
+    }
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Decode %XX and '+' in place
+static void urlDecode(char* text) {
+    char* out = text;
+    for (char* in = text; *in; in++) {
+        if (*in == '+') {
+            *out++ = ' ';
+        } else if (*in == '%' && hexValue(in[1]) >= 0 && hexValue(in[2]) >= 0) {
+            *out++ = (char)(hexValue(in[1]) * 16 + hexValue(in[2]));
+            in += 2;
+        } else {
+            *out++ = *in;
+        }
+    }
+    *out = '\0';
+}
+
+// Find a header value in [headers, end) without modifying the buffer
+static const char* findHeader(const char* headers, const char* end, const char* name) {
+    size_t nameLength = strlen(name);
+    for (const char* line = headers; line < end; ) {
+        const char* next = strstr(line, "\r\n");
+        if (next == nullptr || next > end) {
+            break;
+        }
+        if ((size_t)(next - line) > nameLength && line[nameLength] == ':' &&
+            strncasecmp(line, name, nameLength) == 0) {
+            const char* value = line + nameLength + 1;
+            while (*value == ' ') value++;
+            return value;
+        }
+        line = next + 2;
+    }
+    return nullptr;
+}
+
+// Content-Length is digits only. strtoul() alone would accept a sign
+// ("-1" is ULONG_MAX) and saturate on overflow, and on the ESP32 both are
+// 32 bits, so a huge length could wrap the request size check.
+static bool parseContentLength(const char* value, size_t& length) {
+    if (*value < '0' || *value > '9') {
+        return false;
+    }
+    errno = 0;
+    char* end;
+    unsigned long parsed = strtoul(value, &end, 10);
+    while (*end == ' ' || *end == '\t') end++;
+    if (errno == ERANGE || *end != '\r') {
+        return false;
+    }
+    length = parsed;
+    return true;
+}
+
+void HttpServer::on(const char* path, HttpMethod method, HttpHandler handler) {
+    if (routeCount >= HTTP_MAX_ROUTES) {
+        LOGE("HTTP route table full, %s not registered", path);
+        return;
+    }
+    Route& route = routes[routeCount];
+    route.path = path;
+    route.method = method;
+    route.handler = handler;
+    route.latency = nullptr;
+    for (size_t i = 0; i < routeCount; i++) {
+        if (strcmp(routes[i].path, path) == 0) {
+            route.latency = routes[i].latency;
+        }
+    }
+    if (route.latency == nullptr) {
+        route.latency = &routeLatency[latencyCount++];
+        route.latency->init("garage_http_request_duration_seconds", "Time to handle an HTTP request",
+                            httpLatencyBoundsUs, sizeof(httpLatencyBoundsUs) / sizeof(httpLatencyBoundsUs[0]),
+                            "route", path);
+    }
+    routeCount++;
+}
+
+void HttpServer::collectHeaders(const char** names, size_t count) {
+    collectedCount = count < HTTP_MAX_COLLECTED_HEADERS ? count : HTTP_MAX_COLLECTED_HEADERS;
+    for (size_t i = 0; i < collectedCount; i++) {
+        collected[i] = names[i];
+    }
+}
+
+bool HttpServer::begin() {
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        connections[i].fd = -1;
+        connections[i].length = 0;
+        connections[i].spill = nullptr;
+        connections[i].fill = nullptr;
+    }
+
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        LOGE("HTTP socket() failed: %d", errno);
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(listenFd, (struct sockaddr*)&address, sizeof(address)) < 0 ||
+        listen(listenFd, HTTP_MAX_CONNECTIONS) < 0) {
+        LOGE("HTTP bind/listen on port %u failed: %d", (unsigned)port, errno);
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    fcntl(listenFd, F_SETFL, fcntl(listenFd, F_GETFL, 0) | O_NONBLOCK);
+    return true;
+}
+
+void HttpServer::stop() {
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        if (connections[i].fd >= 0) {
+            closeConnection(connections[i]);
+        }
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+        listenFd = -1;
+    }
+}
+
+void HttpServer::poll(uint32_t timeoutMs) {
+    if (listenFd < 0) {
+        return;
+    }
+
+    // Connections sending a response wait for room in the socket and are
+    // not read until it is done; the others wait for a request
+    fd_set readSet;
+    fd_set writeSet;
+    FD_ZERO(&readSet);
+    FD_ZERO(&writeSet);
+    int maxFd = -1;
+    bool slotFree = false;
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        const Connection& connection = connections[i];
+        int fd = connection.fd;
+        if (fd < 0) {
+            slotFree = true;
+            continue;
+        }
+        FD_SET(fd, connection.responding ? &writeSet : &readSet);
+        if (fd > maxFd) maxFd = fd;
+    }
+    // With every slot busy, new clients wait in the listen backlog
+    if (slotFree) {
+        FD_SET(listenFd, &readSet);
+        if (listenFd > maxFd) maxFd = listenFd;
+    }
+
+    struct timeval timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_usec = (timeoutMs % 1000) * 1000;
+    int ready = select(maxFd + 1, &readSet, &writeSet, nullptr, &timeout);
+
+    if (ready > 0 && slotFree && FD_ISSET(listenFd, &readSet)) {
+        acceptConnection();
+    }
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        Connection& connection = connections[i];
+        if (connection.fd < 0) {
+            continue;
+        }
+        if (connection.responding) {
+            if (ready > 0 && FD_ISSET(connection.fd, &writeSet)) {
+                serviceResponse(connection, millis());
+            }
+        } else if (ready > 0 && FD_ISSET(connection.fd, &readSet)) {
+            readConnection(connection);
+        }
+        // A pipelined request can be waiting once a response is done
+        if (connection.fd >= 0 && !connection.responding && connection.length > 0) {
+            serveRequests(connection);
+        }
+    }
+
+    uint32_t now = millis();
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        Connection& connection = connections[i];
+        if (connection.fd < 0) {
+            continue;
+        }
+        if (connection.responding) {
+            if (now - connection.lastProgressMs > HTTP_STALL_TIMEOUT_MS) {
+                closeConnection(connection);
+                stats.stalled++;
+            }
+        } else if (connection.length > 0 && now - connection.requestStartMs > HTTP_REQUEST_TIMEOUT_MS) {
+            sendStatus(connection, 408);
+            closeConnection(connection);
+            stats.timeouts++;
+        } else if (connection.length == 0 && now - connection.lastActivityMs > HTTP_KEEPALIVE_TIMEOUT_MS) {
+            closeConnection(connection);
+            stats.timeouts++;
+        }
+    }
+}
+
+void HttpServer::acceptConnection() {
+    Connection* connection = nullptr;
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        if (connections[i].fd < 0) {
+            connection = &connections[i];
+            break;
+        }
+    }
+    if (connection == nullptr) {
+        return;
+    }
+
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd < 0) {
+        return;
+    }
+
+    // Reads only happen once select() reports data and every send is
+    // non-blocking, so the socket itself never blocks the task
+    int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    connection->fd = fd;
+    connection->length = 0;
+    connection->requests = 0;
+    connection->lastActivityMs = millis();
+    connection->responding = false;
+    connection->outputStart = connection->outputEnd = 0;
+    connection->spillLength = connection->spillSent = 0;
+    connection->body = nullptr;
+    connection->bodyLength = 0;
+    stats.accepted++;
+    stats.open++;
+}
+
+void HttpServer::readConnection(Connection& connection) {
+    int received = recv(connection.fd, connection.buffer + connection.length,
+                        HTTP_REQUEST_BUFFER_BYTES - connection.length, MSG_DONTWAIT);
+    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return;
+    }
+    if (received <= 0) {
+        closeConnection(connection);  // Peer closed or reset
+        return;
+    }
+
+    uint32_t now = millis();
+    if (connection.length == 0) {
+        connection.requestStartMs = now;
+    }
+    connection.length += received;
+    connection.lastActivityMs = now;
+}
+
+// Serve complete requests in the buffer (pipelined clients) until one
+// leaves its response still being sent
+void HttpServer::serveRequests(Connection& connection) {
+    while (connection.fd >= 0 && !connection.responding && processRequest(connection)) {
+        serviceResponse(connection, millis());  // Small responses go out right away
+    }
+
+    if (connection.fd >= 0 && !connection.responding && connection.length >= HTTP_REQUEST_BUFFER_BYTES) {
+        sendStatus(connection, 413);
+        closeConnection(connection);
+        stats.rejected++;
+    }
+}
+
+// Handle one buffered request. Returns true when a request was dispatched
+// and its response queued on the still open connection.
+bool HttpServer::processRequest(Connection& connection) {
+    char* buffer = connection.buffer;
+    buffer[connection.length] = '\0';
+
+    char* headerEnd = strstr(buffer, "\r\n\r\n");
+    if (headerEnd == nullptr) {
+        return false;
+    }
+    char* headers = strstr(buffer, "\r\n") + 2;
+    size_t headerLength = headerEnd + 4 - buffer;
+
+    // Wait for the whole body before touching the buffer
+    size_t bodyLength = 0;
+    const char* contentLength = findHeader(headers, headerEnd + 2, "Content-Length");
+    if (contentLength != nullptr && !parseContentLength(contentLength, bodyLength)) {
+        sendStatus(connection, 400);
+        closeConnection(connection);
+        stats.rejected++;
+        return false;
+    }
+    // headerLength fits the buffer, so this cannot wrap
+    if (bodyLength > HTTP_REQUEST_BUFFER_BYTES - headerLength) {
+        sendStatus(connection, 413);
+        closeConnection(connection);
+        stats.rejected++;
+        return false;
+    }
+    size_t requestLength = headerLength + bodyLength;
+    if (requestLength > connection.length) {
+        return false;
+    }
+
+    // Request line: METHOD SP TARGET SP VERSION
+    char* line = buffer;
+    *(headers - 2) = '\0';
+    char* target = strchr(line, ' ');
+    char* version = target ? strchr(target + 1, ' ') : nullptr;
+    if (version == nullptr) {
+        sendStatus(connection, 400);
+        closeConnection(connection);
+        stats.rejected++;
+        return false;
+    }
+    *target++ = '\0';
+    *version++ = '\0';
+
+    if (strcmp(line, "GET") == 0) {
+        requestMethod = HTTP_GET;
+    } else if (strcmp(line, "POST") == 0) {
+        requestMethod = HTTP_POST;
+    } else if (strcmp(line, "PATCH") == 0) {
+        requestMethod = HTTP_PATCH;
+    } else {
+        sendStatus(connection, 501);
+        closeConnection(connection);
+        stats.rejected++;
+        return false;
+    }
+
+    http10 = strcmp(version, "HTTP/1.0") == 0;
+    keepAlive = !http10;
+
+    // Header lines: keep Connection and the collected ones
+    for (size_t i = 0; i < collectedCount; i++) {
+        collectedValues[i] = nullptr;
+    }
+    *headerEnd = '\0';
+    for (char* header = headers; header != nullptr && header < headerEnd; ) {
+        char* next = strstr(header, "\r\n");
+        if (next != nullptr) {
+            *next = '\0';
+            next += 2;
+        }
+        char* colon = strchr(header, ':');
+        if (colon != nullptr) {
+            *colon = '\0';
+            char* value = colon + 1;
+            while (*value == ' ') value++;
+            if (strcasecmp(header, "Connection") == 0) {
+                if (strcasecmp(value, "close") == 0) keepAlive = false;
+                if (strcasecmp(value, "keep-alive") == 0) keepAlive = true;
+            }
+            for (size_t i = 0; i < collectedCount; i++) {
+                if (strcasecmp(header, collected[i]) == 0) {
+                    collectedValues[i] = value;
+                }
+            }
+        }
+        header = next;
+    }
+    if (connection.requests + 1 >= HTTP_MAX_KEEPALIVE_REQUESTS) {
+        keepAlive = false;
+    }
+
+    // Arguments from the query string and a form body. The byte after the
+    // body may start a pipelined request, so it is restored afterwards.
+    argCount = 0;
+    char* query = strchr(target, '?');
+    if (query != nullptr) {
+        *query++ = '\0';
+        parseArgs(query);
+    }
+    requestPath = target;
+
+    char* body = buffer + headerLength;
+    char saved = body[bodyLength];
+    body[bodyLength] = '\0';
+    requestBody = body;
+    if (requestMethod == HTTP_POST && bodyLength > 0) {
+        parseArgs(body);
+    }
+
+    current = &connection;
+    detached = false;
+    sendFailed = false;
+    responseHeadersLength = 0;
+    responseLength = 0;
+    contentLengthSet = false;
+    responseStarted = false;
+    chunked = false;
+
+    uint32_t startUs = micros();
+    const Route* route = dispatch();
+    if (route != nullptr) {
+        route->latency->observe(micros() - startUs);
+    }
+
+    body[bodyLength] = saved;
+    requestBody = "";
+    current = nullptr;
+    stats.requests++;
+    if (connection.requests > 0) {
+        stats.reused++;
+    }
+    connection.requests++;
+
+    if (detached) {
+        // The socket now belongs to the handler (event stream)
+        connection.fd = -1;
+        connection.length = 0;
+        stats.open--;
+        return false;
+    }
+    if (sendFailed) {
+        closeConnection(connection);
+        return false;
+    }
+
+    connection.length -= requestLength;
+    memmove(buffer, buffer + requestLength, connection.length);
+    connection.closeAfter = !keepAlive;
+    connection.chunked = chunked;
+    connection.responding = true;
+    connection.lastProgressMs = millis();
+    return true;
+}
+
+// Run the matching handler; returns its route, or nullptr if none matched
+const HttpServer::Route* HttpServer::dispatch() {
+    const Route* matched = nullptr;
+    bool pathFound = false;
+    for (size_t i = 0; i < routeCount; i++) {
+        const Route& route = routes[i];
+        if (strcmp(route.path, requestPath) != 0) {
+            continue;
+        }
+        pathFound = true;
+        if (route.method == HTTP_ANY || route.method == requestMethod) {
+            matched = &route;
+            route.handler();
+            break;
+        }
+    }
+
+    if (detached) {
+        return matched;
+    }
+    if (!responseStarted) {
+        if (!pathFound) {
+            send(404, "application/json", "{\"error\":\"not found\"}");
+        } else {
+            send(405, "application/json", "{\"error\":\"method not allowed\"}");
+        }
+    } else if (chunked && current->fill == nullptr) {
+        sendContent("", 0);  // Handler did not terminate its chunked response
+    }
+    return matched;
+}
+
+// Send what the socket takes and refill a streamed body as it drains
+void HttpServer::serviceResponse(Connection& connection, uint32_t now) {
+    for (int fills = 0; ; fills++) {
+        if (!flushOutput(connection, now)) {
+            closeConnection(connection);  // Reset or closed by the peer
+            return;
+        }
+        bool drained = connection.outputStart == connection.outputEnd &&
+                       connection.spillSent == connection.spillLength && connection.bodyLength == 0;
+        if (connection.fill == nullptr) {
+            if (drained) {
+                endResponse(connection);
+            }
+            return;
+        }
+        // Refill once there is room; a fast client gets a few steps per poll
+        if (fills == HTTP_MAX_FILLS_PER_POLL || connection.spillSent != connection.spillLength ||
+            sizeof(connection.output) - (connection.outputEnd - connection.outputStart) < HTTP_STREAM_STEP_BYTES) {
+            return;
+        }
+        if (!runFill(connection)) {
+            closeConnection(connection);
+            return;
+        }
+    }
+}
+
+// Non-blocking sends of the queued bytes; false if the client is gone
+bool HttpServer::flushOutput(Connection& connection, uint32_t now) {
+    for (;;) {
+        const char* data;
+        size_t length;
+        if (connection.outputStart < connection.outputEnd) {
+            data = connection.output + connection.outputStart;
+            length = connection.outputEnd - connection.outputStart;
+        } else if (connection.spillSent < connection.spillLength) {
+            data = connection.spill + connection.spillSent;
+            length = connection.spillLength - connection.spillSent;
+        } else if (connection.bodyLength > 0) {
+            data = connection.body;
+            length = connection.bodyLength;
+        } else {
+            break;
+        }
+
+        int sent = ::send(connection.fd, data, length, MSG_DONTWAIT);
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;  // Socket buffer full; poll() waits for room
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        connection.lastProgressMs = now;
+        if (connection.outputStart < connection.outputEnd) {
+            connection.outputStart += sent;
+        } else if (connection.spillSent < connection.spillLength) {
+            connection.spillSent += sent;
+        } else {
+            connection.body += sent;
+            connection.bodyLength -= sent;
+        }
+    }
+
+    connection.outputStart = connection.outputEnd = 0;
+    if (connection.spill != nullptr) {
+        free(connection.spill);
+        connection.spill = nullptr;
+        connection.spillLength = connection.spillSent = 0;
+    }
+    return true;
+}
+
+// Run one fill step with the response state of the connection it belongs
+// to; false if the step could not queue its output
+bool HttpServer::runFill(Connection& connection) {
+    current = &connection;
+    detached = false;
+    sendFailed = false;
+    responseStarted = true;
+    chunked = connection.chunked;
+
+    bool more = connection.fill(connection.fillContext);
+    if (!more) {
+        if (chunked) {
+            sendContent("", 0);  // Fill did not terminate its chunked body
+        }
+        connection.release(connection.fillContext);
+        connection.fill = nullptr;
+    }
+    connection.chunked = chunked;
+    current = nullptr;
+    return !sendFailed;
+}
+
+// The whole response has been sent
+void HttpServer::endResponse(Connection& connection) {
+    connection.responding = false;
+    if (connection.closeAfter) {
+        closeConnection(connection);
+        return;
+    }
+    uint32_t now = millis();
+    connection.lastActivityMs = now;
+    connection.requestStartMs = now;
+}
+
+void HttpServer::closeConnection(Connection& connection) {
+    close(connection.fd);
+    connection.fd = -1;
+    connection.length = 0;
+    connection.responding = false;
+    connection.outputStart = connection.outputEnd = 0;
+    connection.body = nullptr;
+    connection.bodyLength = 0;
+    if (connection.spill != nullptr) {
+        free(connection.spill);
+        connection.spill = nullptr;
+    }
+    connection.spillLength = connection.spillSent = 0;
+    if (connection.fill != nullptr) {
+        connection.release(connection.fillContext);
+        connection.fill = nullptr;
+    }
+    stats.open--;
+}
+
+void HttpServer::parseArgs(char* query) {
+    char* pair = query;
+    while (pair != nullptr && *pair && argCount < HTTP_MAX_ARGS) {
+        char* next = strchr(pair, '&');
+        if (next != nullptr) {
+            *next++ = '\0';
+        }
+        char* value = strchr(pair, '=');
+        if (value != nullptr) {
+            *value++ = '\0';
+        } else {
+            value = pair + strlen(pair);
+        }
+        urlDecode(pair);
+        urlDecode(value);
+        args[argCount].name = pair;
+        args[argCount].value = value;
+        argCount++;
+        pair = next;
+    }
+}
+
+// Minimal response outside a handler, just before closing
+void HttpServer::sendStatus(Connection& connection, int code) {
+    char response[96];
+    int length = snprintf(response, sizeof(response),
+                          "HTTP/1.1 %d %s\r\nContent-Length: 0\r\nConnection: close\r\n\r\n",
+                          code, statusText(code));
+    ::send(connection.fd, response, length, MSG_DONTWAIT);
+}
+
+bool HttpServer::hasArg(const char* name) const {
+    for (size_t i = 0; i < argCount; i++) {
+        if (strcmp(args[i].name, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+String HttpServer::arg(const char* name) const {
+    for (size_t i = 0; i < argCount; i++) {
+        if (strcmp(args[i].name, name) == 0) {
+            return String(args[i].value);
+        }
+    }
+    return String();
+}
+
+bool HttpServer::hasHeader(const char* name) const {
+    for (size_t i = 0; i < collectedCount; i++) {
+        if (strcasecmp(collected[i], name) == 0) {
+            return collectedValues[i] != nullptr;
+        }
+    }
+    return false;
+}
+
+String HttpServer::header(const char* name) const {
+    for (size_t i = 0; i < collectedCount; i++) {
+        if (strcasecmp(collected[i], name) == 0 && collectedValues[i] != nullptr) {
+            return String(collectedValues[i]);
+        }
+    }
+    return String();
+}
+
+int HttpServer::detachClient() {
+    if (current == nullptr) {
+        return -1;
+    }
+    detached = true;
+    return current->fd;
+}
+
+void HttpServer::sendHeader(const String& name, const String& value, bool first) {
+    size_t length = name.length() + value.length() + 4;
+    if (responseHeadersLength + length >= sizeof(responseHeaders)) {
+        addLogEntryf(LOG_WARN, "HTTP response header %s dropped", name.c_str());
+        return;
+    }
+    char* position = responseHeaders + responseHeadersLength;
+    if (first) {
+        memmove(responseHeaders + length, responseHeaders, responseHeadersLength);
+        position = responseHeaders;
+    }
+    char saved = position[length];
+    snprintf(position, length + 1, "%s: %s\r\n", name.c_str(), value.c_str());
+    position[length] = saved;  // snprintf's terminator may land on a moved header
+    responseHeadersLength += length;
+}
+
+void HttpServer::writeHead(int code, const char* contentType, size_t contentLength) {
+    if (responseStarted) {
+        return;
+    }
+    responseStarted = true;
+
+    // HTTP/1.0 has no chunked encoding: stream the body and close instead
+    chunked = contentLength == CONTENT_LENGTH_UNKNOWN && !http10;
+    if (contentLength == CONTENT_LENGTH_UNKNOWN && http10) {
+        keepAlive = false;
+    }
+
+    char head[160];
+    int length = snprintf(head, sizeof(head), "HTTP/1.1 %d %s\r\n", code, statusText(code));
+    if (contentType != nullptr && *contentType) {
+        length += snprintf(head + length, sizeof(head) - length, "Content-Type: %s\r\n", contentType);
+    }
+    if (chunked) {
+        length += snprintf(head + length, sizeof(head) - length, "Transfer-Encoding: chunked\r\n");
+    } else if (contentLength != CONTENT_LENGTH_UNKNOWN) {
+        length += snprintf(head + length, sizeof(head) - length, "Content-Length: %u\r\n", (unsigned)contentLength);
+    }
+    snprintf(head + length, sizeof(head) - length, "Connection: %s\r\n",
+             keepAlive ? "keep-alive" : "close");
+
+    writeAll(head, strlen(head));
+    writeAll(responseHeaders, responseHeadersLength);
+    writeAll("\r\n", 2);
+}
+
+// Queue bytes on the current connection: in its output buffer when they
+// fit, otherwise on the heap after what is already queued
+bool HttpServer::writeAll(const char* data, size_t length) {
+    if (current == nullptr || detached || sendFailed) {
+        return false;
+    }
+    Connection& connection = *current;
+    if (connection.spillLength == connection.spillSent) {
+        if (connection.outputEnd + length > sizeof(connection.output) && connection.outputStart > 0) {
+            memmove(connection.output, connection.output + connection.outputStart,
+                    connection.outputEnd - connection.outputStart);
+            connection.outputEnd -= connection.outputStart;
+            connection.outputStart = 0;
+        }
+        if (connection.outputEnd + length <= sizeof(connection.output)) {
+            memcpy(connection.output + connection.outputEnd, data, length);
+            connection.outputEnd += length;
+            return true;
+        }
+    }
+
+    char* spill = (char*)realloc(connection.spill, connection.spillLength + length);
+    if (spill == nullptr) {
+        addLogEntryf(LOG_ERROR, "HTTP response of %u bytes dropped: out of memory",
+                     (unsigned)(connection.spillLength + length));
+        sendFailed = true;  // Drop the connection rather than send a cut body
+        return false;
+    }
+    memcpy(spill + connection.spillLength, data, length);
+    connection.spill = spill;
+    connection.spillLength += length;
+    return true;
+}
+
+size_t HttpServer::outputSpace() const {
+    if (current == nullptr || current->spillLength != current->spillSent) {
+        return 0;
+    }
+    return sizeof(current->output) - (current->outputEnd - current->outputStart);
+}
+
+void HttpServer::sendBody(int code, const char* contentType, const char* content, size_t length) {
+    writeHead(code, contentType, contentLengthSet ? responseLength : length);
+    if (length > 0) {
+        sendContent(content, length);
+    }
+}
+
+void HttpServer::send(int code, const char* contentType, const String& content) {
+    sendBody(code, contentType, content.c_str(), content.length());
+}
+
+void HttpServer::send(int code, const char* contentType, const char* content) {
+    sendBody(code, contentType, content, strlen(content));
+}
+
+// Flash is memory-mapped on the ESP32, so PROGMEM data is sent in place
+// from poll() after the head; it must be the whole body
+void HttpServer::send_P(int code, const char* contentType, const char* content, size_t length) {
+    writeHead(code, contentType, contentLengthSet ? responseLength : length);
+    if (current != nullptr && !detached && !sendFailed) {
+        current->body = content;
+        current->bodyLength = length;
+    }
+}
+
+void HttpServer::sendStream(int code, const char* contentType, HttpStreamFill fill, void* context,
+                            HttpStreamRelease release) {
+    if (current == nullptr || responseStarted) {
+        release(context);
+        return;
+    }
+    writeHead(code, contentType, CONTENT_LENGTH_UNKNOWN);
+    current->fill = fill;
+    current->release = release;
+    current->fillContext = context;
+}
+
+// With an unknown length each call is one chunk and an empty call ends the
+// response; otherwise the bytes are written as they are
+void HttpServer::sendContent(const char* content, size_t length) {
+    if (!responseStarted) {
+        return;
+    }
+    if (!chunked) {
+        writeAll(content, length);
+        return;
+    }
+    char size[12];
+    snprintf(size, sizeof(size), "%x\r\n", (unsigned)length);
+    writeAll(size, strlen(size));
+    if (length == 0) {
+        writeAll("\r\n", 2);
+        chunked = false;
+        return;
+    }
+    writeAll(content, length);
+    writeAll("\r\n", 2);
+}
+
+void HttpServer::sendContent(const String& content) {
+    sendContent(content.c_str(), content.length());
+}
+
+void HttpServer::sendContent(const char* content) {
+    sendContent(content, strlen(content));
+}
@@ -0,0 +1,67 @@
+#include "log_ring.h"
+#include <stdio.h>
+#include <string.h>
+
+LogRecord& LogRing::claim(LogLevel level, uint64_t timestampUs) {
+    LogRecord& record = records[head];
+    record.timestampUs = timestampUs;
+    record.sequence = nextSequence++;
+    record.level = level;
+
+    head = (head + 1) % LOG_RING_CAPACITY;
+    if (count < LOG_RING_CAPACITY) {
+        count++;
+    }
+    return record;
+}
+
+const LogRecord& LogRing::add(LogLevel level, uint64_t timestampUs, const char* message) {
+    LogRecord& record = claim(level, timestampUs);
+    strncpy(record.message, message, LOG_MESSAGE_LENGTH - 1);
+    record.message[LOG_MESSAGE_LENGTH - 1] = '\0';
+    return record;
+}
+
+const LogRecord& LogRing::addFormatted(LogLevel level, uint64_t timestampUs, const char* format, va_list args) {
+    LogRecord& record = claim(level, timestampUs);
+    vsnprintf(record.message, LOG_MESSAGE_LENGTH, format, args);
+    return record;
+}
+
+uint32_t LogRing::getOldestSequence() const {
+    return count ? nextSequence - count : 0;
+}
+
+size_t LogRing::readAfter(uint32_t after, size_t limit, LogVisitor visitor, void* context) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    // Skip straight to the first record newer than 'after'
+    uint32_t oldest = nextSequence - count;
+    size_t skip = after >= oldest ? after - oldest + 1 : 0;
+    if (skip >= count) {
+        return 0;
+    }
+
+    size_t index = (head + LOG_RING_CAPACITY - count + skip) % LOG_RING_CAPACITY;
+    size_t visited = 0;
+    for (size_t i = skip; i < count && visited < limit; i++) {
+        visited++;
+        if (!visitor(records[index], context)) {
+            break;
+        }
+        index = (index + 1) % LOG_RING_CAPACITY;
+    }
+    return visited;
+}
+
+const char* LogRing::levelName(LogLevel level) {
+    switch (level) {
+        case LOG_DEBUG: return "DEBUG";
+        case LOG_INFO:  return "INFO";
+        case LOG_WARN:  return "WARN";
+        case LOG_ERROR: return "ERROR";
+    }
+    return "UNKNOWN";
+}
@@ -1,17 +1,79 @@
 #include <Arduino.h>
 #include "sensors.h"
 #include "config.h"
+#include "scheduler.h"
+#include "environment_history.h"
+#include "system_log.h"
+#include "metrics.h"
+#include "config_store.h"
 #ifdef ENABLE_WIFI
 #include "wifi_manager.h"
 #include "web_server.h"
 #include "ota_manager.h"
 #endif
 
+// Scheduler time source: micros() clock, sleep in whole FreeRTOS ticks
+uint32_t schedulerClock() {
+  return micros();
+}
+
+void schedulerSleep(uint32_t us) {
+  delay((us + 999) / 1000);
+}
+
+Scheduler taskScheduler(schedulerClock, schedulerSleep);
+
+// Device-wide metrics (see metrics.h)
+static const uint32_t loopBoundsUs[] = {50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000};
+MetricHistogram loopTimeMetric("garage_loop_busy_seconds", "Time spent running jobs per scheduler pass",
+                               loopBoundsUs, sizeof(loopBoundsUs) / sizeof(loopBoundsUs[0]));
+
+static uint32_t readFreeHeap() { return ESP.getFreeHeap(); }
+static uint32_t readMinFreeHeap() { return ESP.getMinFreeHeap(); }
+static uint32_t readUptimeSeconds() { return millis() / 1000; }
+MetricGauge freeHeapMetric("garage_heap_free_bytes", "Free internal heap", readFreeHeap);
+MetricGauge minFreeHeapMetric("garage_heap_min_free_bytes", "Lowest free internal heap since boot", readMinFreeHeap);
+MetricGauge uptimeMetric("garage_uptime_seconds", "Seconds since boot", readUptimeSeconds);
+
+#ifdef ENABLE_WIFI
+// Web server and OTA start once the first connection is up; until then
+// sensing runs on its own
+static bool networkServicesStarted = false;
+
+static void serviceWiFi() {
+  checkWiFiConnection();
+  if (!networkServicesStarted && isWiFiConnected()) {
+    networkServicesStarted = true;
+    printWiFiInfo();
+    // Initialize OTA manager
+    otaManager.init();
+    // Start web server
+    initWebServer();
+    LOGI("System started successfully");
+  }
+}
+#endif
+
+void setupScheduler() {
+  // One job per enabled sensor, each at its own period
+  registerSensorJobs(taskScheduler);
+  #if defined(ENABLE_DHT22) || defined(ENABLE_BMP280)
+  taskScheduler.addJob("history", recordEnvironmentHistory,
+                       configStore.getUInt(CONFIG_HISTORY_SAMPLE_INTERVAL) * 1000UL);
+  #endif
+  #ifdef ENABLE_WIFI
+  taskScheduler.addJob("wifi", serviceWiFi, WIFI_POLL_INTERVAL * 1000UL);
+  // Web clients, event stream and OTA run on their own task (see web_server.h)
+  #endif
+}
+
 void setup() {
   Serial.begin(115200);
   while (!Serial) {
     delay(10); // Wait for serial port to connect
   }
+  initSystemLog();
+  configStore.begin();
   
   Serial.println("ESP32 S3 Nano Sensor Interface Starting...");
   
@@ -22,79 +84,22 @@ void setup() {
   
   // Initialize sensors
   initializeSensors();
+  #if defined(ENABLE_DHT22) || defined(ENABLE_BMP280)
+  initEnvironmentHistory();
+  #endif
   
-  // Initialize WiFi if enabled
+  // Start connecting to WiFi if enabled; the "wifi" job takes it from there
   #ifdef ENABLE_WIFI
   initWiFi();
-  delay(2000);  // Give WiFi time to settle
-  if (isWiFiConnected()) {
-    printWiFiInfo();
-    // Initialize OTA manager
-    otaManager.init();
-    // Start web server
-    initWebServer();
-    addLogEntry("System started successfully", "INFO");
-  }
   #endif
   
+  setupScheduler();
+  
   Serial.println("System initialized successfully!");
 }
 
 void loop() {
-  // Check WiFi connection status
-  #ifdef ENABLE_WIFI
-  checkWiFiConnection();
-  handleWebServer();
-  // Handle OTA updates
-  otaManager.loop();
-  #endif
-  
-  // Read sensors periodically
-  readAllSensors();
-  
-  // Check for beam break with E3JK-RR11
-  #ifdef ENABLE_E3JK_RR11
-  
-  #ifdef ENABLE_SIMULATION_MODE
-  // Simulate beam break every 10 seconds for testing
-  static unsigned long lastSimulation = 0;
-  static bool simulatedBeamBroken = false;
-  
-  if (millis() - lastSimulation >= SIMULATION_BEAM_INTERVAL) {
-    lastSimulation = millis();
-    simulatedBeamBroken = !simulatedBeamBroken;
-    currentSensorData.beamBroken = simulatedBeamBroken;
-    currentSensorData.lastStateChangeTime = millis();
-    
-    // Update LED for simulation
-    digitalWrite(LED_INDICATOR_PIN, simulatedBeamBroken ? HIGH : LOW);
-    
-    if (simulatedBeamBroken) {
-      Serial.println("🧪 SIMULATION: Beam BROKEN - LED ON");
-      addLogEntry("SIMULATION: Beam broken - object detected!", "WARN");
-    } else {
-      Serial.println("🧪 SIMULATION: Beam CLEAR - LED OFF");
-      addLogEntry("SIMULATION: Beam clear - path restored", "INFO");
-    }
-  }
-  #else
-  // Real hardware beam detection
-  static bool lastBeamBroken = false;
-  bool currentBeamBroken = isBeamBroken();
-  
-  if (currentBeamBroken && !lastBeamBroken) {
-    Serial.println(">>> BEAM BROKEN - LED ON <<<");
-    addLogEntry("Beam broken - object detected!", "WARN");
-  } else if (!currentBeamBroken && lastBeamBroken) {
-    Serial.println(">>> BEAM CLEAR - LED OFF <<<");
-    addLogEntry("Beam clear - path restored", "INFO");
-  }
-  
-  lastBeamBroken = currentBeamBroken;
-  #endif
-  
-  #endif
-  
-  // Wait before next reading cycle
-  delay(SENSOR_READ_INTERVAL);
-}
\ No newline at end of file
+  // Run due jobs, then sleep until the next deadline
+  taskScheduler.runOnce();
+  loopTimeMetric.observe(taskScheduler.getLastPassUs());
+}
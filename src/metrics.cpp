@@ -0,0 +1,180 @@
+#include "metrics.h"
+#include <stdio.h>
+#include <string.h>
+
+// Registration order is kept so families render in a stable order.
+// Constant-initialized, so static metrics in any file may register first.
+static Metric* metricsHead = nullptr;
+static Metric* metricsTail = nullptr;
+
+void Metric::registerMetric(const char* name, const char* help, MetricType type,
+                            const char* labelName, const char* labelValue) {
+    this->name = name;
+    this->help = help;
+    this->type = type;
+    this->labelName = labelName;
+    this->labelValue = labelValue;
+    next = nullptr;
+    if (metricsTail == nullptr) {
+        metricsHead = this;
+    } else {
+        metricsTail->next = this;
+    }
+    metricsTail = this;
+}
+
+MetricCounter::MetricCounter(const char* name, const char* help, MetricSource source) : source(source) {
+    value.store(0, std::memory_order_relaxed);
+    registerMetric(name, help, METRIC_COUNTER, nullptr, nullptr);
+}
+
+MetricGauge::MetricGauge(const char* name, const char* help, MetricSource source) : source(source) {
+    value.store(0, std::memory_order_relaxed);
+    registerMetric(name, help, METRIC_GAUGE, nullptr, nullptr);
+}
+
+MetricHistogram::MetricHistogram(const char* name, const char* help, const uint32_t* boundsUs, uint8_t boundCount) {
+    init(name, help, boundsUs, boundCount);
+}
+
+void MetricHistogram::init(const char* name, const char* help, const uint32_t* boundsUs, uint8_t boundCount,
+                           const char* labelName, const char* labelValue) {
+    bounds = boundsUs;
+    this->boundCount = boundCount < METRICS_MAX_BUCKETS ? boundCount : METRICS_MAX_BUCKETS;
+    for (int i = 0; i <= METRICS_MAX_BUCKETS; i++) {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+    sumLow.store(0, std::memory_order_relaxed);
+    sumHigh.store(0, std::memory_order_relaxed);
+    registerMetric(name, help, METRIC_HISTOGRAM, labelName, labelValue);
+}
+
+void MetricHistogram::observe(uint32_t us) {
+    uint8_t index = 0;
+    while (index < boundCount && us > bounds[index]) {
+        index++;
+    }
+    buckets[index].fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t previous = sumLow.fetch_add(us, std::memory_order_relaxed);
+    if (previous + us < previous) {
+        sumHigh.fetch_add(1, std::memory_order_relaxed);  // Carry
+    }
+}
+
+uint64_t MetricHistogram::getSumUs() const {
+    // Re-read if a carry landed in between
+    uint32_t high;
+    uint32_t low;
+    do {
+        high = sumHigh.load(std::memory_order_relaxed);
+        low = sumLow.load(std::memory_order_relaxed);
+    } while (high != sumHigh.load(std::memory_order_relaxed));
+    return ((uint64_t)high << 32) | low;
+}
+
+// Microseconds as decimal seconds, e.g. 2500 -> "0.002500"
+static void formatSeconds(char* out, size_t size, uint64_t us) {
+    snprintf(out, size, "%lu.%06lu", (unsigned long)(us / 1000000), (unsigned long)(us % 1000000));
+}
+
+// "{label="value"}", "{label="value",le="0.5"}", "{le="0.5"}" or ""
+static void formatLabels(char* out, size_t size, const char* labelName, const char* labelValue, const char* le) {
+    if (labelName != nullptr && le != nullptr) {
+        snprintf(out, size, "{%s=\"%s\",le=\"%s\"}", labelName, labelValue, le);
+    } else if (labelName != nullptr) {
+        snprintf(out, size, "{%s=\"%s\"}", labelName, labelValue);
+    } else if (le != nullptr) {
+        snprintf(out, size, "{le=\"%s\"}", le);
+    } else {
+        out[0] = '\0';
+    }
+}
+
+static void writeLine(MetricsWriter write, void* context, const char* line, int length, size_t size) {
+    if (length > 0) {
+        write(line, (size_t)length < size ? (size_t)length : size - 1, context);
+    }
+}
+
+bool renderNextMetric(MetricsCursor& cursor, MetricsWriter write, void* context) {
+    static const char* typeNames[] = {"counter", "gauge", "histogram"};
+    char line[256];
+    char labels[128];
+    char value[24];
+    int length;
+
+    if (!cursor.started) {
+        cursor.started = true;
+        cursor.family = metricsHead;
+        cursor.member = nullptr;
+    }
+    if (cursor.member == nullptr) {
+        // A family is rendered as a whole at its first member
+        for (; cursor.family != nullptr; cursor.family = cursor.family->next) {
+            const Metric* earlier = metricsHead;
+            while (earlier != cursor.family && strcmp(earlier->name, cursor.family->name) != 0) {
+                earlier = earlier->next;
+            }
+            if (earlier == cursor.family) {
+                break;
+            }
+        }
+        if (cursor.family == nullptr) {
+            return false;
+        }
+        const Metric* family = cursor.family;
+        length = snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s %s\n",
+                          family->name, family->help, family->name, typeNames[family->type]);
+        writeLine(write, context, line, length, sizeof(line));
+        cursor.member = family;
+    }
+
+    const Metric* metric = cursor.member;
+    if (metric->type != METRIC_HISTOGRAM) {
+        uint32_t sample = metric->type == METRIC_COUNTER
+            ? static_cast<const MetricCounter*>(metric)->get()
+            : static_cast<const MetricGauge*>(metric)->get();
+        formatLabels(labels, sizeof(labels), metric->labelName, metric->labelValue, nullptr);
+        length = snprintf(line, sizeof(line), "%s%s %lu\n", metric->name, labels, (unsigned long)sample);
+        writeLine(write, context, line, length, sizeof(line));
+    } else {
+        const MetricHistogram* histogram = static_cast<const MetricHistogram*>(metric);
+        uint32_t cumulative = 0;
+        for (uint8_t i = 0; i <= histogram->getBoundCount(); i++) {
+            cumulative += histogram->getBucket(i);
+            if (i < histogram->getBoundCount()) {
+                formatSeconds(value, sizeof(value), histogram->getBoundUs(i));
+            } else {
+                strcpy(value, "+Inf");
+            }
+            formatLabels(labels, sizeof(labels), metric->labelName, metric->labelValue, value);
+            length = snprintf(line, sizeof(line), "%s_bucket%s %lu\n",
+                              metric->name, labels, (unsigned long)cumulative);
+            writeLine(write, context, line, length, sizeof(line));
+        }
+
+        formatLabels(labels, sizeof(labels), metric->labelName, metric->labelValue, nullptr);
+        formatSeconds(value, sizeof(value), histogram->getSumUs());
+        length = snprintf(line, sizeof(line), "%s_sum%s %s\n%s_count%s %lu\n",
+                          metric->name, labels, value, metric->name, labels, (unsigned long)cumulative);
+        writeLine(write, context, line, length, sizeof(line));
+    }
+
+    // Next member of this family, or the next family
+    const Metric* next = metric->next;
+    while (next != nullptr && strcmp(next->name, cursor.family->name) != 0) {
+        next = next->next;
+    }
+    cursor.member = next;
+    if (next == nullptr) {
+        cursor.family = cursor.family->next;
+    }
+    return true;
+}
+
+void renderMetrics(MetricsWriter write, void* context) {
+    MetricsCursor cursor = {nullptr, nullptr, false};
+    while (renderNextMetric(cursor, write, context)) {
+    }
+}
@@ -0,0 +1,91 @@
+#include "ota_flash.h"
+#include <esp_ota_ops.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool OTAFlashWriter::begin(const esp_partition_t* partition, uint32_t offset) {
+    end();
+    if (partition == nullptr || offset % OTA_FLASH_SECTOR != 0 || offset > partition->size) {
+        return false;
+    }
+    sector = (uint8_t*)malloc(OTA_FLASH_SECTOR);
+    if (sector == nullptr) {
+        return false;
+    }
+    this->partition = partition;
+    sectorStart = offset;
+    sectorFill = 0;
+    erasedEnd = offset;
+    return true;
+}
+
+void OTAFlashWriter::end() {
+    if (sector != nullptr) {
+        free(sector);
+        sector = nullptr;
+    }
+}
+
+// Sectors are erased just before they are written (or by eraseAhead()),
+// never behind sectorStart, so resuming never touches what is in flash
+bool OTAFlashWriter::writeSector(size_t length) {
+    if (sectorStart + OTA_FLASH_SECTOR > partition->size) {
+        return false;
+    }
+    if (sectorStart >= erasedEnd) {
+        if (esp_partition_erase_range(partition, sectorStart, OTA_FLASH_SECTOR) != ESP_OK) {
+            return false;
+        }
+        erasedEnd = sectorStart + OTA_FLASH_SECTOR;
+    }
+    if (esp_partition_write(partition, sectorStart, sector, length) != ESP_OK) {
+        return false;
+    }
+    if (length == OTA_FLASH_SECTOR) {
+        sectorStart += OTA_FLASH_SECTOR;
+        sectorFill = 0;
+    }
+    return true;
+}
+
+bool OTAFlashWriter::eraseAhead(uint8_t sectors) {
+    if (sector == nullptr || erasedEnd >= sectorStart + (uint32_t)sectors * OTA_FLASH_SECTOR ||
+        erasedEnd + OTA_FLASH_SECTOR > partition->size) {
+        return false;
+    }
+    if (esp_partition_erase_range(partition, erasedEnd, OTA_FLASH_SECTOR) != ESP_OK) {
+        return false;
+    }
+    erasedEnd += OTA_FLASH_SECTOR;
+    return true;
+}
+
+bool OTAFlashWriter::write(const uint8_t* data, size_t length) {
+    if (sector == nullptr) {
+        return false;
+    }
+    while (length > 0) {
+        size_t used = OTA_FLASH_SECTOR - sectorFill < length ? OTA_FLASH_SECTOR - sectorFill : length;
+        memcpy(sector + sectorFill, data, used);
+        sectorFill += used;
+        data += used;
+        length -= used;
+        if (sectorFill == OTA_FLASH_SECTOR && !writeSector(OTA_FLASH_SECTOR)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool OTAFlashWriter::commit() {
+    if (sector == nullptr) {
+        return false;
+    }
+    if (sectorFill > 0 && !writeSector(sectorFill)) {
+        return false;
+    }
+    // Checks the image header, segments and checksum before switching
+    bool committed = esp_ota_set_boot_partition(partition) == ESP_OK;
+    end();
+    return committed;
+}
@@ -0,0 +1,423 @@
+#include "ota_image.h"
+#include <Arduino.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if CONFIG_IDF_TARGET_ESP32S3
+#include <esp32s3/rom/miniz.h>
+#else
+#include <esp32/rom/miniz.h>
+#endif
+
+// Gzip header fields (RFC 1952), then the deflate stream
+enum GzipStage {
+    GZIP_HEADER_FIXED,          // Magic, method, flags, mtime, xfl, os
+    GZIP_HEADER_EXTRA_LENGTH,
+    GZIP_HEADER_EXTRA,
+    GZIP_HEADER_NAME,
+    GZIP_HEADER_COMMENT,
+    GZIP_HEADER_CRC,
+    GZIP_BODY,
+    GZIP_DONE                   // Deflate stream complete; the trailer is ignored
+};
+
+#define GZIP_FLAG_HCRC 0x02
+#define GZIP_FLAG_EXTRA 0x04
+#define GZIP_FLAG_NAME 0x08
+#define GZIP_FLAG_COMMENT 0x10
+#define GZIP_FLAG_RESERVED 0xE0
+
+struct OTAInflateState {
+    GzipStage stage;
+    uint8_t flags;
+    uint8_t count;              // Bytes of the current header field seen
+    uint16_t extraRemaining;
+    uint32_t windowPos;
+    tinfl_decompressor inflator;
+    uint8_t window[OTA_INFLATE_WINDOW];  // Circular; also the inflater's dictionary
+};
+
+// Delta patch (see ota_image.h)
+enum PatchStage {
+    PATCH_HEADER,
+    PATCH_RECORD,
+    PATCH_DIFF,
+    PATCH_EXTRA,
+    PATCH_DONE
+};
+
+#define PATCH_SOURCE_CHUNK 256
+
+struct OTAPatchState {
+    PatchStage stage;
+    uint8_t field[OTA_PATCH_HEADER_SIZE];   // Header or record being collected
+    uint8_t fieldBytes;
+    uint32_t sourceSize;
+    uint32_t targetSize;
+    uint32_t sourcePos;
+    uint32_t diffRemaining;
+    uint32_t extraRemaining;
+    int32_t seek;
+    uint8_t sourceBuffer[PATCH_SOURCE_CHUNK];
+};
+
+static uint32_t readLE32(const uint8_t* data) {
+    return (uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24;
+}
+
+static bool gzipStageWanted(const OTAInflateState* state) {
+    switch (state->stage) {
+        case GZIP_HEADER_EXTRA_LENGTH: return state->flags & GZIP_FLAG_EXTRA;
+        case GZIP_HEADER_EXTRA: return (state->flags & GZIP_FLAG_EXTRA) && state->extraRemaining > 0;
+        case GZIP_HEADER_NAME: return state->flags & GZIP_FLAG_NAME;
+        case GZIP_HEADER_COMMENT: return state->flags & GZIP_FLAG_COMMENT;
+        case GZIP_HEADER_CRC: return state->flags & GZIP_FLAG_HCRC;
+        default: return true;
+    }
+}
+
+static void nextGzipStage(OTAInflateState* state) {
+    state->count = 0;
+    do {
+        state->stage = (GzipStage)(state->stage + 1);
+    } while (state->stage < GZIP_BODY && !gzipStageWanted(state));
+}
+
+OTAImageFormat OTAImageWriter::formatForName(const char* name) {
+    size_t length = strlen(name);
+    if (length > 9 && strcmp(name + length - 9, ".patch.gz") == 0) {
+        return OTA_IMAGE_DELTA;
+    }
+    if (length > 3 && strcmp(name + length - 3, ".gz") == 0) {
+        return OTA_IMAGE_GZIP;
+    }
+    return OTA_IMAGE_PLAIN;
+}
+
+bool OTAImageWriter::begin(OTAImageFormat format, OTAImageSink sink, void* context, OTAImageSource source) {
+    end();
+    this->format = format;
+    this->sink = sink;
+    this->context = context;
+    this->source = source;
+    imageBytes = 0;
+    error = nullptr;
+
+    if (format == OTA_IMAGE_DELTA) {
+        if (source == nullptr) {
+            return fail("No source for delta image");
+        }
+        patchState = (OTAPatchState*)malloc(sizeof(OTAPatchState));
+        if (patchState == nullptr) {
+            return fail("Not enough memory to patch");
+        }
+        patchState->stage = PATCH_HEADER;
+        patchState->fieldBytes = 0;
+        patchState->sourcePos = 0;
+        patchState->diffRemaining = 0;
+        patchState->extraRemaining = 0;
+        patchState->seek = 0;
+    }
+
+    if (format != OTA_IMAGE_PLAIN) {
+        inflateState = (OTAInflateState*)malloc(sizeof(OTAInflateState));
+        if (inflateState == nullptr) {
+            return fail("Not enough memory to decompress");
+        }
+        inflateState->stage = GZIP_HEADER_FIXED;
+        inflateState->flags = 0;
+        inflateState->count = 0;
+        inflateState->extraRemaining = 0;
+        inflateState->windowPos = 0;
+        tinfl_init(&inflateState->inflator);
+    }
+
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts_ret(&sha, 0);
+    hashing = true;
+    return true;
+}
+
+void OTAImageWriter::end() {
+    if (inflateState != nullptr) {
+        free(inflateState);
+        inflateState = nullptr;
+    }
+    if (patchState != nullptr) {
+        free(patchState);
+        patchState = nullptr;
+    }
+    if (hashing) {
+        mbedtls_sha256_free(&sha);
+        hashing = false;
+    }
+}
+
+bool OTAImageWriter::fail(const char* message) {
+    if (error == nullptr) {
+        error = message;
+    }
+    return false;
+}
+
+bool OTAImageWriter::emit(const uint8_t* data, size_t length) {
+    mbedtls_sha256_update_ret(&sha, data, length);
+    imageBytes += length;
+    if (!sink(data, length, context)) {
+        return fail("Flash write failed");
+    }
+    return true;
+}
+
+bool OTAImageWriter::resumeFrom(uint32_t length, OTAImageSource written, void* writtenContext) {
+    if (format != OTA_IMAGE_PLAIN || !hashing || imageBytes != 0) {
+        return fail("Only plain images can resume");
+    }
+    uint8_t buffer[PATCH_SOURCE_CHUNK];
+    for (uint32_t offset = 0; offset < length; offset += sizeof(buffer)) {
+        size_t chunk = length - offset < sizeof(buffer) ? length - offset : sizeof(buffer);
+        if (!written(offset, buffer, chunk, writtenContext)) {
+            return fail("Could not read back the partial image");
+        }
+        mbedtls_sha256_update_ret(&sha, buffer, chunk);
+    }
+    imageBytes = length;
+    return true;
+}
+
+// Output of the gzip layer
+bool OTAImageWriter::decoded(const uint8_t* data, size_t length) {
+    if (patchState != nullptr) {
+        return applyPatch(data, length);
+    }
+    return emit(data, length);
+}
+
+bool OTAImageWriter::write(const uint8_t* data, size_t length) {
+    if (error != nullptr || !hashing) {
+        return false;
+    }
+    if (format == OTA_IMAGE_PLAIN) {
+        return emit(data, length);
+    }
+
+    size_t used = parseGzipHeader(data, length);
+    if (error != nullptr) {
+        return false;
+    }
+    return inflate(data + used, length - used);
+}
+
+size_t OTAImageWriter::parseGzipHeader(const uint8_t* data, size_t length) {
+    OTAInflateState* state = inflateState;
+    size_t used = 0;
+    while (used < length && state->stage < GZIP_BODY) {
+        uint8_t byte = data[used++];
+        switch (state->stage) {
+            case GZIP_HEADER_FIXED:
+                if ((state->count == 0 && byte != 0x1f) || (state->count == 1 && byte != 0x8b) ||
+                    (state->count == 2 && byte != 8)) {
+                    fail("Not a gzip image");
+                    return used;
+                }
+                if (state->count == 3) {
+                    if (byte & GZIP_FLAG_RESERVED) {
+                        fail("Unsupported gzip flags");
+                        return used;
+                    }
+                    state->flags = byte;
+                }
+                if (++state->count == 10) {
+                    nextGzipStage(state);
+                }
+                break;
+            case GZIP_HEADER_EXTRA_LENGTH:
+                state->extraRemaining |= (uint16_t)byte << (8 * state->count);
+                if (++state->count == 2) {
+                    nextGzipStage(state);
+                }
+                break;
+            case GZIP_HEADER_EXTRA:
+                if (--state->extraRemaining == 0) {
+                    nextGzipStage(state);
+                }
+                break;
+            case GZIP_HEADER_NAME:
+            case GZIP_HEADER_COMMENT:
+                if (byte == 0) {
+                    nextGzipStage(state);
+                }
+                break;
+            case GZIP_HEADER_CRC:
+                if (++state->count == 2) {
+                    nextGzipStage(state);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return used;
+}
+
+bool OTAImageWriter::inflate(const uint8_t* data, size_t length) {
+    OTAInflateState* state = inflateState;
+    while (state->stage == GZIP_BODY) {
+        size_t inSize = length;
+        size_t outSize = OTA_INFLATE_WINDOW - state->windowPos;
+        tinfl_status status = tinfl_decompress(&state->inflator, data, &inSize,
+                                               state->window, state->window + state->windowPos, &outSize,
+                                               TINFL_FLAG_HAS_MORE_INPUT);
+        data += inSize;
+        length -= inSize;
+
+        if (outSize > 0) {
+            if (!decoded(state->window + state->windowPos, outSize)) {
+                return false;
+            }
+            state->windowPos = (state->windowPos + outSize) & (OTA_INFLATE_WINDOW - 1);
+        }
+
+        if (status == TINFL_STATUS_DONE) {
+            state->stage = GZIP_DONE;
+        } else if (status < 0) {
+            return fail("Corrupt compressed image");
+        } else if (status == TINFL_STATUS_NEEDS_MORE_INPUT && length == 0) {
+            break;
+        }
+        // TINFL_STATUS_HAS_MORE_OUTPUT: the window is full, go round again
+    }
+    return true;
+}
+
+bool OTAImageWriter::finish(uint8_t digest[OTA_SHA256_SIZE]) {
+    if (!hashing) {
+        return false;
+    }
+    mbedtls_sha256_finish_ret(&sha, digest);
+    if (error != nullptr) {
+        return false;
+    }
+    if (format != OTA_IMAGE_PLAIN && inflateState->stage != GZIP_DONE) {
+        return fail("Compressed image is truncated");
+    }
+    if (format == OTA_IMAGE_DELTA && patchState->stage != PATCH_DONE) {
+        return fail("Delta image is truncated");
+    }
+    return true;
+}
+
+// The patch only applies to the exact image it was made from
+bool OTAImageWriter::checkPatchSource() {
+    OTAPatchState* state = patchState;
+    mbedtls_sha256_context sourceSha;
+    uint8_t digest[OTA_SHA256_SIZE];
+    bool readOk = true;
+
+    mbedtls_sha256_init(&sourceSha);
+    mbedtls_sha256_starts_ret(&sourceSha, 0);
+    for (uint32_t offset = 0; offset < state->sourceSize && readOk; offset += PATCH_SOURCE_CHUNK) {
+        size_t length = state->sourceSize - offset < PATCH_SOURCE_CHUNK ? state->sourceSize - offset : PATCH_SOURCE_CHUNK;
+        readOk = source(offset, state->sourceBuffer, length, context);
+        if (readOk) {
+            mbedtls_sha256_update_ret(&sourceSha, state->sourceBuffer, length);
+        }
+    }
+    mbedtls_sha256_finish_ret(&sourceSha, digest);
+    mbedtls_sha256_free(&sourceSha);
+
+    if (!readOk || memcmp(digest, state->field + 12, OTA_SHA256_SIZE) != 0) {
+        return fail("Delta image is for different firmware");
+    }
+    return true;
+}
+
+// After a record's header or one of its parts: on to the next non-empty part
+void OTAImageWriter::nextPatchRecord() {
+    OTAPatchState* state = patchState;
+    if (state->diffRemaining > 0) {
+        state->stage = PATCH_DIFF;
+    } else if (state->extraRemaining > 0) {
+        state->stage = PATCH_EXTRA;
+    } else {
+        state->sourcePos += state->seek;
+        state->seek = 0;
+        state->fieldBytes = 0;
+        state->stage = imageBytes >= state->targetSize ? PATCH_DONE : PATCH_RECORD;
+    }
+}
+
+bool OTAImageWriter::applyPatch(const uint8_t* data, size_t length) {
+    OTAPatchState* state = patchState;
+    while (length > 0) {
+        size_t used = 0;
+        switch (state->stage) {
+            case PATCH_HEADER:
+            case PATCH_RECORD: {
+                size_t size = state->stage == PATCH_HEADER ? OTA_PATCH_HEADER_SIZE : OTA_PATCH_RECORD_SIZE;
+                used = size - state->fieldBytes < length ? size - state->fieldBytes : length;
+                memcpy(state->field + state->fieldBytes, data, used);
+                state->fieldBytes += used;
+                if (state->fieldBytes < size) {
+                    break;
+                }
+                if (state->stage == PATCH_HEADER) {
+                    if (memcmp(state->field, OTA_PATCH_MAGIC, 8) != 0) {
+                        return fail("Not a delta image");
+                    }
+                    state->sourceSize = readLE32(state->field + 8);
+                    state->targetSize = readLE32(state->field + 44);
+                    if (!checkPatchSource()) {
+                        return false;
+                    }
+                } else {
+                    state->diffRemaining = readLE32(state->field);
+                    state->extraRemaining = readLE32(state->field + 4);
+                    state->seek = (int32_t)readLE32(state->field + 8);
+                    if ((uint64_t)imageBytes + state->diffRemaining + state->extraRemaining > state->targetSize) {
+                        return fail("Delta image is larger than its target");
+                    }
+                }
+                nextPatchRecord();
+                break;
+            }
+            case PATCH_DIFF: {
+                used = length < PATCH_SOURCE_CHUNK ? length : PATCH_SOURCE_CHUNK;
+                if (used > state->diffRemaining) {
+                    used = state->diffRemaining;
+                }
+                if (state->sourcePos > state->sourceSize || used > state->sourceSize - state->sourcePos ||
+                    !source(state->sourcePos, state->sourceBuffer, used, context)) {
+                    return fail("Delta image reads outside its source");
+                }
+                for (size_t i = 0; i < used; i++) {
+                    state->sourceBuffer[i] += data[i];
+                }
+                if (!emit(state->sourceBuffer, used)) {
+                    return false;
+                }
+                state->sourcePos += used;
+                state->diffRemaining -= used;
+                if (state->diffRemaining == 0) {
+                    nextPatchRecord();
+                }
+                break;
+            }
+            case PATCH_EXTRA:
+                used = length < state->extraRemaining ? length : state->extraRemaining;
+                if (!emit(data, used)) {
+                    return false;
+                }
+                state->extraRemaining -= used;
+                if (state->extraRemaining == 0) {
+                    nextPatchRecord();
+                }
+                break;
+            case PATCH_DONE:
+                return fail("Unexpected data after delta image");
+        }
+        data += used;
+        length -= used;
+    }
+    return true;
+}
@@ -1,12 +1,55 @@
 #include "ota_manager.h"
+#include "ota_image.h"
+#include "ota_flash.h"
+#include "ota_pipeline.h"
+#include "config_store.h"
+#include <esp_ota_ops.h>
 #include "web_server.h"
+#include "event_stream.h"
+#include "metrics.h"
+#include <Preferences.h>
+#include <freertos/task.h>
 
 OTAManager otaManager;
 
+static const uint32_t otaCheckBoundsUs[] = {250000, 500000, 1000000, 2500000, 5000000, 10000000, 30000000};
+MetricHistogram otaCheckMetric("garage_ota_check_duration_seconds", "Duration of GitHub release checks",
+                               otaCheckBoundsUs, sizeof(otaCheckBoundsUs) / sizeof(otaCheckBoundsUs[0]));
+MetricCounter checkRequestsMetric("garage_ota_check_requests_total", "Release checks sent to the update server");
+MetricCounter checkNotModifiedMetric("garage_ota_check_not_modified_total", "Release checks answered 304 Not Modified");
+MetricCounter checkRateLimitedMetric("garage_ota_check_rate_limited_total", "Release checks refused by the rate limit");
+
+// Last release seen and its ETag/Last-Modified, kept across restarts
+Preferences otaPrefs;
+
+// A compressed image decodes to its plain sibling (firmware.bin.gz ->
+// firmware.bin, same digest), so the progress of either download is kept
+// under the plain image's URL. Empty for delta images.
+static String resumeUrlFor(const String& url) {
+    if (url.endsWith(".bin.gz")) {
+        return url.substring(0, url.length() - 3);
+    }
+    return url.endsWith(".bin") ? url : String();
+}
+
+static bool hasDownloadResume(const String& url) {
+    return url.length() > 0 && otaPrefs.getString("dl_url", "") == url;
+}
+
 void OTAManager::init() {
+    if (stateMutex == nullptr) {
+        stateMutex = xSemaphoreCreateMutex();
+    }
     currentStatus = OTA_UPDATE_IDLE;
     statusMessage = "OTA initialized";
     
+    otaPrefs.begin("ota", false);
+    releaseETag = otaPrefs.getString("etag", "");
+    releaseLastModified = otaPrefs.getString("modified", "");
+    releaseTag = otaPrefs.getString("tag", "");
+    releaseAssetUrl = otaPrefs.getString("url", "");
+    releasePatchUrl = otaPrefs.getString("patch", "");
+    
     // Configure ArduinoOTA
     ArduinoOTA.setPort(OTA_PORT);
     ArduinoOTA.setHostname(FIRMWARE_NAME);
@@ -47,6 +90,11 @@ void OTAManager::init() {
     
     ArduinoOTA.begin();
     
+    if (xTaskCreatePinnedToCore(checkTask, "ota-check", OTA_CHECK_TASK_STACK, this,
+                                tskIDLE_PRIORITY + 1, nullptr, OTA_TASK_CORE) != pdPASS) {
+        LOGE("OTA: Could not start check task");
+    }
+    
     Serial.println("OTA Manager initialized");
     Serial.printf("Current firmware version: %s\n", currentVersion.c_str());
     Serial.printf("OTA enabled on port %d\n", OTA_PORT);
@@ -59,10 +107,22 @@ void OTAManager::loop() {
     
     // Check for updates periodically
     if (WiFi.status() == WL_CONNECTED && 
-        millis() - lastUpdateCheck > OTA_CHECK_INTERVAL) {
+        millis() - lastUpdateCheck >= nextCheckDelayMs) {
         
+        uint32_t startUs = micros();
         checkForUpdate();
+        otaCheckMetric.observe(micros() - startUs);
         lastUpdateCheck = millis();
+        publishOTAEvent();
+        
+        // Finish a download that a reboot interrupted, once per boot
+        if (!resumeChecked && !latestVersion.isEmpty()) {
+            resumeChecked = true;
+            if (updateAvailable && hasDownloadResume(resumeUrlFor(latestReleaseUrl))) {
+                addLogEntryf(LOG_INFO, "OTA: Continuing interrupted download of %s", latestVersion.c_str());
+                installLatestRelease();
+            }
+        }
         
         // Force garbage collection if available heap is low (less than 50KB)
         if (ESP.getFreeHeap() < 50000) {
@@ -73,6 +133,14 @@ void OTAManager::loop() {
     }
 }
 
+void OTAManager::checkTask(void* parameter) {
+    OTAManager* manager = static_cast<OTAManager*>(parameter);
+    for (;;) {
+        manager->loop();
+        vTaskDelay(pdMS_TO_TICKS(OTA_CHECK_POLL_MS));
+    }
+}
+
 void OTAManager::enableWebOTA() {
     // ArduinoOTA provides network OTA functionality
     // Web interface can be added separately if needed
@@ -82,258 +150,751 @@ void OTAManager::enableWebOTA() {
     Serial.printf("Port: %d\n", OTA_PORT);
 }
 
+void OTAManager::lockState() {
+    if (stateMutex) {
+        xSemaphoreTake(stateMutex, portMAX_DELAY);
+    }
+}
+
+void OTAManager::unlockState() {
+    if (stateMutex) {
+        xSemaphoreGive(stateMutex);
+    }
+}
+
+void OTAManager::setStatus(OTAUpdateStatus status, const String& message) {
+    lockState();
+    currentStatus = status;
+    statusMessage = message;
+    unlockState();
+}
+
+bool OTAManager::isBusy() const {
+    return currentStatus == OTA_UPDATE_CHECKING ||
+           currentStatus == OTA_UPDATE_DOWNLOADING ||
+           currentStatus == OTA_UPDATE_INSTALLING ||
+           currentStatus == OTA_UPDATE_SUCCESS;  // Restarting
+}
+
+String OTAManager::getStatusMessage() {
+    lockState();
+    String message = statusMessage;
+    unlockState();
+    return message;
+}
+
+String OTAManager::getLatestVersion() {
+    lockState();
+    String version = latestVersion;
+    unlockState();
+    return version;
+}
+
+OTAProgress OTAManager::getProgress() {
+    OTAProgress progress;
+    lockState();
+    progress.phase = currentStatus;
+    progress.bytesWritten = bytesWritten;
+    progress.totalBytes = totalBytes;
+    progress.imageBytes = imageBytes;
+    progress.pipeline = pipelineStats;
+    if (downloadStartMs == 0) {
+        progress.elapsedMs = 0;
+    } else {
+        progress.elapsedMs = (downloadEndMs ? downloadEndMs : millis()) - downloadStartMs;
+    }
+    unlockState();
+    return progress;
+}
+
+const char* OTAManager::statusName(OTAUpdateStatus status) {
+    switch (status) {
+        case OTA_UPDATE_IDLE: return "idle";
+        case OTA_UPDATE_CHECKING: return "checking";
+        case OTA_UPDATE_DOWNLOADING: return "downloading";
+        case OTA_UPDATE_INSTALLING: return "installing";
+        case OTA_UPDATE_SUCCESS: return "success";
+        case OTA_UPDATE_ERROR: return "error";
+    }
+    return "unknown";
+}
+
 bool OTAManager::checkForUpdate() {
-    if (currentStatus != OTA_UPDATE_IDLE) {
-        Serial.println("OTA check skipped - already in progress");
+    if (isBusy()) {
+        LOGI("OTA check skipped - already in progress");
         return false;  // Already updating
     }
     
-    currentStatus = OTA_UPDATE_CHECKING;
-    statusMessage = "Checking for updates...";
-    
-    Serial.println("OTA: Checking for updates...");
-    Serial.print("Current version: ");
-    Serial.println(currentVersion);
+    setStatus(OTA_UPDATE_CHECKING, "Checking for updates...");
     
-    log_i("OTA UPDATE CHECK - Current: %s", currentVersion.c_str());
+    addLogEntryf(LOG_INFO, "OTA: Checking for updates (current version %s)", currentVersion.c_str());
     
     HTTPClient http;
     http.begin(OTA_UPDATE_URL);
     http.addHeader("User-Agent", "ESP32-GarageDoor-OTA");
+    http.useHTTP10(true);  // No chunked encoding, so the body can be parsed straight from the stream
     
     // Add GitHub authentication if token is provided
     if (strlen(GITHUB_TOKEN) > 0) {
         String authHeader = "Bearer " + String(GITHUB_TOKEN);
         http.addHeader("Authorization", authHeader.c_str());
-        Serial.println("Using GitHub authentication token");
+        LOGD("OTA: Using GitHub authentication token");
     } else {
-        Serial.println("Public repository access (no token)");
+        LOGD("OTA: Public repository access (no token)");
     }
     
-    Serial.println("Sending HTTP GET request...");
-    Serial.flush();
+    // Conditional request: an unchanged release comes back as an empty 304,
+    // which GitHub does not count against the rate limit
+    if (releaseETag.length() > 0) {
+        http.addHeader("If-None-Match", releaseETag);
+    } else if (releaseLastModified.length() > 0) {
+        http.addHeader("If-Modified-Since", releaseLastModified);
+    }
+    static const char* responseHeaders[] = {
+        "ETag", "Last-Modified", "Retry-After", "X-RateLimit-Remaining"
+    };
+    http.collectHeaders(responseHeaders, sizeof(responseHeaders) / sizeof(responseHeaders[0]));
+    
     int httpCode = http.GET();
+    checkRequestsMetric.increment();
+    LOGI("OTA: GitHub API response code %d", httpCode);
     
-    Serial.println("========================================");
-    Serial.print("GitHub API Response Code: ");
-    Serial.println(httpCode);
-    Serial.println("========================================");
-    Serial.flush();
-    delay(50);
+    // Seconds to wait before the next request, if the server asked for one
+    uint32_t retryAfterMs = 0;
+    if (http.hasHeader("Retry-After")) {
+        retryAfterMs = (uint32_t)http.header("Retry-After").toInt() * 1000;
+    }
+    bool rateLimited = httpCode == HTTP_CODE_TOO_MANY_REQUESTS ||
+                       (http.hasHeader("X-RateLimit-Remaining") && http.header("X-RateLimit-Remaining").toInt() == 0);
     
-    if (httpCode == HTTP_CODE_OK) {
-        String payload = http.getString();
-        Serial.print("Received JSON payload: ");
-        Serial.print(payload.length());
-        Serial.println(" bytes");
-        Serial.println("----------------------------------------");
-        Serial.println("Parsing JSON Response...");
-        Serial.flush();
-        delay(50);
-        
-        JsonDocument doc;
-        DeserializationError error = deserializeJson(doc, payload);
-        
-        if (error) {
-            Serial.print("!!! JSON PARSE ERROR: ");
-            Serial.println(error.c_str());
-            statusMessage = "Failed to parse update response";
-            currentStatus = OTA_UPDATE_IDLE;
-            http.end();
-            return false;
+    if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+        checkNotModifiedMetric.increment();
+        LOGD("OTA: Release unchanged (304)");
+        applyRelease(releaseTag, releaseAssetUrl, releasePatchUrl);
+        http.end();
+        scheduleNextCheck(!rateLimited, retryAfterMs);
+        return updateAvailable;
+    }
+    
+    if (httpCode != HTTP_CODE_OK) {
+        if (rateLimited || httpCode == HTTP_CODE_FORBIDDEN) {
+            checkRateLimitedMetric.increment();
+            setStatus(OTA_UPDATE_IDLE, "Update server rate limit reached, backing off");
+            addLogEntryf(LOG_WARN, "OTA: Rate limited (code %d), retry after %lu s",
+                         httpCode, (unsigned long)(retryAfterMs / 1000));
+        } else {
+            setStatus(OTA_UPDATE_IDLE, "Failed to check for updates: " + String(httpCode));
+            LOGE("OTA: API request failed, code %d", httpCode);
         }
-        
-        Serial.println("JSON parsed successfully!");
-        
-        if (!doc["tag_name"].isNull()) {
-            latestVersion = doc["tag_name"].as<String>();
-            Serial.print("Latest version: ");
-            Serial.println(latestVersion);
-            
-            log_i("Latest version: %s", latestVersion.c_str());
-            
-            // Remove 'v' prefix if present for comparison
-            String compareVersion = latestVersion;
-            if (compareVersion.startsWith("v")) {
-                compareVersion = compareVersion.substring(1);
-            }
-            
-            Serial.print("Comparing versions: ");
-            Serial.print(currentVersion);
-            Serial.print(" vs ");
-            Serial.println(compareVersion);
-            
-            log_i("Comparing versions: '%s' vs '%s'", currentVersion.c_str(), compareVersion.c_str());
-            
-            if (compareVersion != currentVersion) {
-                statusMessage = "Update available: " + latestVersion;
-                Serial.println("");
-                Serial.println("****************************************");
-                Serial.println("***      UPDATE AVAILABLE!!!        ***");
-                Serial.print("***  ");
-                Serial.print(currentVersion);
-                Serial.print(" -> ");
-                Serial.print(compareVersion);
-                Serial.println("  ***");
-                Serial.println("****************************************");
-                Serial.flush();
-                delay(200);
-                
-                // Critical update notification using ESP32 logging
-                log_w("UPDATE AVAILABLE: %s -> %s", currentVersion.c_str(), compareVersion.c_str());
-                
-                // Look for firmware asset
-                JsonArray assets = doc["assets"];
-                Serial.print("Checking ");
-                Serial.print(assets.size());
-                Serial.println(" assets for firmware binary");
-                
-                for (JsonVariant asset : assets) {
-                    String name = asset["name"];
-                    Serial.print("Asset found: ");
-                    Serial.println(name);
-                    
-                    if (name.endsWith(".bin") && name.indexOf("firmware") >= 0) {
-                        String downloadUrl = asset["browser_download_url"];
-                        Serial.print("Firmware found: ");
-                        Serial.println(name);
-                        Serial.print("Download URL: ");
-                        Serial.println(downloadUrl);
-                        
-                        // Store release info for web install button
-                        latestReleaseUrl = downloadUrl;
-                        updateAvailable = true;
-                        statusMessage = "Update available: " + latestVersion + " (Click to install)";
-                        
-                        currentStatus = OTA_UPDATE_IDLE;
-                        http.end();
-                        Serial.println("OTA: Update available");
-                        return true;
-                    }
-                }
-                Serial.println("!!! No .bin firmware file found in release assets !!!");
-                statusMessage = "No firmware binary found in release";
-            } else {
-                statusMessage = "Firmware up to date";
-                updateAvailable = false;
-                latestReleaseUrl = "";
-                Serial.println("OTA: Firmware is up to date");
-                log_i("Firmware is up to date");
-            }
+        http.end();
+        scheduleNextCheck(false, retryAfterMs);
+        return false;
+    }
+    
+    // The release JSON is tens of KB, mostly release notes and asset
+    // metadata. Parse it from the stream and keep only the fields used
+    // below instead of buffering the whole body. test_release_parse
+    // measures this filter on the host; keep the two in step.
+    JsonDocument filter;
+    filter["tag_name"] = true;
+    filter["assets"][0]["name"] = true;
+    filter["assets"][0]["browser_download_url"] = true;
+    
+    JsonDocument doc;
+    uint32_t heapBefore = ESP.getFreeHeap();
+    uint32_t parseStart = millis();
+    DeserializationError error = deserializeJson(doc, http.getStream(), DeserializationOption::Filter(filter));
+    LOGD("OTA: Release JSON read in %lu ms, document uses %ld bytes of heap",
+         (unsigned long)(millis() - parseStart), (long)heapBefore - (long)ESP.getFreeHeap());
+    
+    if (error || doc["tag_name"].isNull()) {
+        if (error) {
+            LOGE("OTA: JSON parse error: %s", error.c_str());
+            setStatus(OTA_UPDATE_IDLE, "Failed to parse update response");
         } else {
-            statusMessage = "Invalid response from update server";
-            Serial.println("OTA Error: No tag_name in API response");
-            Serial.print("Response preview: ");
-            Serial.println(payload.substring(0, 200));
+            addLogEntryf(LOG_ERROR, "OTA: No tag_name in API response");
+            setStatus(OTA_UPDATE_IDLE, "Invalid response from update server");
         }
-    } else {
-        statusMessage = "Failed to check for updates: " + String(httpCode);
-        Serial.print("OTA Error: API request failed, code ");
-        Serial.println(httpCode);
-        if (httpCode > 0) {
-            String response = http.getString();
-            Serial.print("Error response: ");
-            Serial.println(response.substring(0, 200));
+        http.end();
+        scheduleNextCheck(false, retryAfterMs);
+        return false;
+    }
+    
+    String tagName = doc["tag_name"].as<String>();
+    
+    // Look for firmware asset, and a delta image from the running version
+    String downloadUrl = "";
+    String patchUrl = "";
+    String patchName = "firmware-" + currentVersion + ".patch.gz";
+    JsonArray assets = doc["assets"];
+    LOGD("OTA: Checking %u assets for firmware binary", assets.size());
+    // A compressed image is preferred over the plain one
+    for (JsonVariant asset : assets) {
+        String name = asset["name"];
+        if (name == patchName) {
+            patchUrl = asset["browser_download_url"].as<String>();
+            addLogEntryf(LOG_INFO, "OTA: Delta image found: %s", name.c_str());
+            continue;
+        }
+        if (name.indexOf("firmware") < 0) {
+            continue;
+        }
+        bool compressed = name.endsWith(".bin.gz");
+        if (compressed || (name.endsWith(".bin") && downloadUrl.length() == 0)) {
+            downloadUrl = asset["browser_download_url"].as<String>();
+            addLogEntryf(LOG_INFO, "OTA: Firmware found: %s", name.c_str());
+            addLogEntryf(LOG_DEBUG, "OTA: Download URL: %s", downloadUrl.c_str());
         }
     }
     
-    currentStatus = OTA_UPDATE_IDLE;
-    http.end();
-    Serial.println("========================================");
-    Serial.println("      OTA CHECK COMPLETE");
-    Serial.println("========================================");
-    Serial.flush();
-    delay(100);  // Ensure all logs are flushed
+    // Remember the release with its validators so later checks can be
+    // conditional, across restarts too. NVS is only written when it changes.
+    String etag = http.header("ETag");
+    String lastModified = http.header("Last-Modified");
+    if (etag != releaseETag || lastModified != releaseLastModified ||
+        tagName != releaseTag || downloadUrl != releaseAssetUrl || patchUrl != releasePatchUrl) {
+        releaseETag = etag;
+        releaseLastModified = lastModified;
+        releaseTag = tagName;
+        releaseAssetUrl = downloadUrl;
+        releasePatchUrl = patchUrl;
+        otaPrefs.putString("etag", releaseETag);
+        otaPrefs.putString("modified", releaseLastModified);
+        otaPrefs.putString("tag", releaseTag);
+        otaPrefs.putString("url", releaseAssetUrl);
+        otaPrefs.putString("patch", releasePatchUrl);
+    }
     
-    return false;
+    applyRelease(tagName, downloadUrl, patchUrl);
+    http.end();
+    scheduleNextCheck(!rateLimited, retryAfterMs);
+    return updateAvailable;
 }
 
-bool OTAManager::performUpdate(String firmwareUrl) {
-    if (currentStatus != OTA_UPDATE_IDLE) {
-        return false;
+// Compare a release with the running firmware and publish the result
+void OTAManager::applyRelease(const String& tagName, const String& downloadUrl, const String& patchUrl) {
+    if (tagName.length() == 0) {
+        setStatus(OTA_UPDATE_IDLE, "Invalid response from update server");
+        return;
     }
     
-    currentStatus = OTA_UPDATE_DOWNLOADING;
-    statusMessage = "Downloading firmware...";
+    lockState();
+    latestVersion = tagName;
+    unlockState();
+    
+    // Remove 'v' prefix if present for comparison
+    String compareVersion = tagName;
+    if (compareVersion.startsWith("v")) {
+        compareVersion = compareVersion.substring(1);
+    }
+    
+    #if LOG_COMPILE_LEVEL <= LOG_LEVEL_DEBUG
+    addLogEntryf(LOG_DEBUG, "OTA: Comparing versions '%s' vs '%s'", currentVersion.c_str(), compareVersion.c_str());
+    #endif
+    
+    if (compareVersion == currentVersion) {
+        lockState();
+        updateAvailable = false;
+        latestReleaseUrl = "";
+        latestPatchUrl = "";
+        unlockState();
+        setStatus(OTA_UPDATE_IDLE, "Firmware up to date");
+        LOGI("OTA: Firmware is up to date");
+        return;
+    }
+    
+    if (downloadUrl.length() == 0) {
+        LOGW("OTA: No .bin firmware file found in release assets");
+        setStatus(OTA_UPDATE_IDLE, "No firmware binary found in release");
+        return;
+    }
+    
+    if (!updateAvailable) {
+        addLogEntryf(LOG_WARN, "OTA: UPDATE AVAILABLE %s -> %s",
+                     currentVersion.c_str(), compareVersion.c_str());
+    }
     
+    // Store release info for web install button
+    lockState();
+    latestReleaseUrl = downloadUrl;
+    latestPatchUrl = patchUrl;
+    updateAvailable = true;
+    unlockState();
+    setStatus(OTA_UPDATE_IDLE, "Update available: " + tagName + " (Click to install)");
+}
+
+// Regular interval after a good check. Failures and rate limiting back off
+// exponentially up to ota.backoff_max_ms, or longer if the server asked
+// for it with Retry-After. Jitter keeps devices behind one NAT from
+// checking in step.
+void OTAManager::scheduleNextCheck(bool succeeded, uint32_t retryAfterMs) {
+    uint32_t delayMs = configStore.getUInt(CONFIG_OTA_CHECK_INTERVAL);
+    uint32_t maxDelayMs = configStore.getUInt(CONFIG_OTA_BACKOFF_MAX);
+    if (succeeded) {
+        checkFailures = 0;
+    } else {
+        if (checkFailures < 16) {
+            checkFailures++;
+        }
+        for (uint8_t i = 0; i < checkFailures && delayMs < maxDelayMs; i++) {
+            delayMs *= 2;
+        }
+        if (delayMs > maxDelayMs) {
+            delayMs = maxDelayMs;
+        }
+    }
+    if (retryAfterMs > delayMs) {
+        delayMs = retryAfterMs;
+    }
+    delayMs += esp_random() % (delayMs / OTA_CHECK_JITTER_DIVISOR + 1);
+    
+    nextCheckDelayMs = delayMs;
+    backingOff = !succeeded;
+    LOGD("OTA: Next check in %lu s", (unsigned long)(delayMs / 1000));
+}
+
+OTACheckStats OTAManager::getCheckStats() {
+    OTACheckStats stats;
+    stats.requests = checkRequestsMetric.get();
+    stats.notModified = checkNotModifiedMetric.get();
+    stats.rateLimited = checkRateLimitedMetric.get();
+    stats.failures = checkFailures;
+    uint32_t sinceLast = millis() - lastUpdateCheck;
+    stats.nextCheckMs = sinceLast < nextCheckDelayMs ? nextCheckDelayMs - sinceLast : 0;
+    return stats;
+}
+
+void OTAManager::triggerUpdateCheck() {
+    // A manual check skips the regular interval but not a backoff
+    if (!backingOff) {
+        nextCheckDelayMs = 0;
+    }
+}
+
+static bool writeToFlash(const uint8_t* data, size_t length, void* context) {
+    return static_cast<OTAFlashWriter*>(context)->write(data, length);
+}
+
+static bool readPartition(uint32_t offset, uint8_t* data, size_t length, void* context) {
+    const esp_partition_t* partition = static_cast<const esp_partition_t*>(context);
+    return offset + length <= partition->size &&
+           esp_partition_read(partition, offset, data, length) == ESP_OK;
+}
+
+// Delta images patch the running firmware; the update goes to the other slot
+static bool readRunningFirmware(uint32_t offset, uint8_t* data, size_t length, void* context) {
+    const esp_partition_t* running = esp_ota_get_running_partition();
+    return running != nullptr && offset + length <= running->size &&
+           esp_partition_read(running, offset, data, length) == ESP_OK;
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Fetch "<image url>.sha256" (sha256sum format: hex digest, then the name).
+// Returns the HTTP code; the digest is only valid with HTTP_CODE_OK.
+static int fetchImageDigest(const String& imageUrl, uint8_t digest[OTA_SHA256_SIZE]) {
     HTTPClient http;
-    http.begin(firmwareUrl);
+    http.begin(imageUrl + ".sha256");
+    http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
+    http.setRedirectLimit(5);
+    
+    int httpCode = http.GET();
+    if (httpCode == HTTP_CODE_OK) {
+        String text = http.getString();
+        for (int i = 0; i < OTA_SHA256_SIZE; i++) {
+            int high = (int)text.length() > i * 2 + 1 ? hexValue(text[i * 2]) : -1;
+            int low = high >= 0 ? hexValue(text[i * 2 + 1]) : -1;
+            if (low < 0) {
+                httpCode = -1;  // Malformed
+                break;
+            }
+            digest[i] = (uint8_t)(high << 4 | low);
+        }
+    }
+    http.end();
+    return httpCode;
+}
+
+// How much of an image reached flash, kept in NVS under its plain URL so
+// the download can continue after a reboot. Only valid for the same URL,
+// digest and target slot.
+static uint32_t loadDownloadResume(const String& url, const esp_partition_t* partition,
+                                   const uint8_t digest[OTA_SHA256_SIZE]) {
+    uint8_t saved[OTA_SHA256_SIZE];
+    if (otaPrefs.getString("dl_url", "") != url || otaPrefs.getUInt("dl_part", 0) != partition->address ||
+        otaPrefs.getBytes("dl_sha", saved, sizeof(saved)) != sizeof(saved) ||
+        memcmp(saved, digest, sizeof(saved)) != 0) {
+        return 0;
+    }
+    uint32_t offset = otaPrefs.getUInt("dl_off", 0);
+    return offset % OTA_FLASH_SECTOR == 0 && offset <= partition->size ? offset : 0;
+}
+
+static void saveDownloadResume(const String& url, const esp_partition_t* partition,
+                               const uint8_t digest[OTA_SHA256_SIZE], uint32_t offset) {
+    if (otaPrefs.getString("dl_url", "") != url) {
+        otaPrefs.putUInt("dl_off", 0);  // Never pair a new URL with an old offset
+        otaPrefs.putString("dl_url", url);
+        otaPrefs.putUInt("dl_part", partition->address);
+        otaPrefs.putBytes("dl_sha", digest, OTA_SHA256_SIZE);
+    }
+    otaPrefs.putUInt("dl_off", offset);
+}
+
+// Only drops the record for 'url'; a delta attempt must not lose the
+// progress of the full image it falls back to
+static void clearDownloadResume(const String& url) {
+    if (hasDownloadResume(url)) {
+        otaPrefs.remove("dl_url");
+        otaPrefs.remove("dl_part");
+        otaPrefs.remove("dl_sha");
+        otaPrefs.remove("dl_off");
+    }
+}
+
+// Request the image from 'offset' on. 'remaining' is the response length.
+// A 206 must start exactly at the offset asked for.
+static int openImageDownload(HTTPClient& http, const String& url, uint32_t offset, int& remaining) {
+    static const char* headers[] = {"Content-Range"};
+    http.begin(url);
     
     // Enable redirect following for GitHub releases
     http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
     http.setRedirectLimit(5);
+    http.collectHeaders(headers, 1);
+    if (offset > 0) {
+        http.addHeader("Range", "bytes=" + String(offset) + "-");
+    }
     
     int httpCode = http.GET();
-    if (httpCode != HTTP_CODE_OK) {
-        statusMessage = "Download failed: " + String(httpCode);
-        currentStatus = OTA_UPDATE_ERROR;
-        http.end();
-        return false;
+    remaining = http.getSize();
+    if (httpCode == HTTP_CODE_PARTIAL_CONTENT &&
+        !http.header("Content-Range").startsWith("bytes " + String(offset) + "-")) {
+        httpCode = -1;
     }
-    
-    int contentLength = http.getSize();
-    if (contentLength <= 0) {
-        statusMessage = "Invalid firmware size";
-        currentStatus = OTA_UPDATE_ERROR;
-        http.end();
+    return httpCode;
+}
+
+// Runs on the install task; the caller has already set the status to
+// OTA_UPDATE_DOWNLOADING so checks and further installs stay out.
+// Compressed (.bin.gz) and delta (.patch.gz) images need a .sha256 next
+// to them; plain images are checked against one if it exists.
+//
+// The image is written straight into the inactive slot by an OTAPipeline:
+// this task receives while the flash task on the other core decodes and
+// writes. When the connection drops, the download continues where it
+// stopped with a Range request (the decoder state is kept in memory).
+// Full images with a digest also record the bytes in flash in NVS every
+// OTA_RESUME_COMMIT_BYTES; after a reboot the plain image continues from
+// there, whether the interrupted download was plain or compressed.
+bool OTAManager::performUpdate(String firmwareUrl) {
+    OTAImageFormat format = OTAImageWriter::formatForName(firmwareUrl.c_str());
+    uint8_t expectedDigest[OTA_SHA256_SIZE];
+    int digestCode = fetchImageDigest(firmwareUrl, expectedDigest);
+    bool verify = digestCode == HTTP_CODE_OK;
+    if (!verify && (format != OTA_IMAGE_PLAIN || digestCode != HTTP_CODE_NOT_FOUND)) {
+        setStatus(OTA_UPDATE_ERROR, "Image checksum unavailable: " + String(digestCode));
         return false;
     }
     
-    bool canBegin = Update.begin(contentLength);
-    if (!canBegin) {
-        statusMessage = "Not enough space for update";
-        currentStatus = OTA_UPDATE_ERROR;
-        http.end();
+    const esp_partition_t* partition = esp_ota_get_next_update_partition(nullptr);
+    if (partition == nullptr) {
+        setStatus(OTA_UPDATE_ERROR, "No OTA partition");
         return false;
     }
+    String resumeUrl = verify ? resumeUrlFor(firmwareUrl) : String();
+    bool resumable = resumeUrl.length() > 0;
+    uint32_t startOffset = resumable && format == OTA_IMAGE_PLAIN ?
+        loadDownloadResume(resumeUrl, partition, expectedDigest) : 0;
+    if (startOffset > 0) {
+        addLogEntryf(LOG_INFO, "OTA: Resuming download at %lu bytes", (unsigned long)startOffset);
+    } else {
+        clearDownloadResume(resumeUrl);
+    }
     
+    lockState();
+    totalBytes = 0;
+    bytesWritten = 0;
+    imageBytes = 0;
+    pipelineStats = OTAPipelineStats();
+    downloadStartMs = millis();
+    downloadEndMs = 0;
     currentStatus = OTA_UPDATE_INSTALLING;
     statusMessage = "Installing firmware...";
-    
-    WiFiClient* client = http.getStreamPtr();
-    size_t written = Update.writeStream(*client);
-    
-    if (written == contentLength) {
-        if (Update.end()) {
-            statusMessage = "Update successful! Rebooting...";
-            currentStatus = OTA_UPDATE_SUCCESS;
+    unlockState();
+    publishOTAEvent();
+    
+    OTAFlashWriter flash;
+    OTAImageWriter writer;
+    OTAPipeline pipeline;
+    uint8_t* buffer = nullptr;      // Being filled from the socket
+    size_t fill = 0;
+    uint32_t received = 0;          // Download offset
+    uint32_t total = 0;             // Download size, from the first response
+    uint32_t committed = 0;         // Offset last saved to NVS
+    uint32_t failedAttempts = 0;    // In a row without progress
+    uint32_t resumeAttempts = configStore.getUInt(CONFIG_OTA_RESUME_ATTEMPTS);
+    uint16_t resumes = 0;
+    bool restart = true;
+    const char* failure = nullptr;
+    
+    // Hand the filled buffer to the flash task
+    auto pushBuffer = [&]() -> bool {
+        bool written = pipeline.push(buffer, fill);
+        buffer = nullptr;
+        fill = 0;
+        return written;
+    };
+    
+    while (failure == nullptr) {
+        if (restart) {
+            // An acquired buffer can survive an attempt that read nothing
+            // into it; end() frees the pool it points into
+            buffer = nullptr;
+            fill = 0;
+            pipeline.end();
+            if (!flash.begin(partition, startOffset)) {
+                failure = "Could not start writing the update";
+                break;
+            }
+            if (!writer.begin(format, writeToFlash, &flash, readRunningFirmware) ||
+                (startOffset > 0 && !writer.resumeFrom(startOffset, readPartition, (void*)partition))) {
+                failure = writer.getError();
+                break;
+            }
+            if (!pipeline.begin(&writer, &flash)) {
+                failure = "Could not start the flash task";
+                break;
+            }
+            received = startOffset;
+            committed = startOffset;
+            restart = false;
+        }
+        
+        // Wait out a WiFi reconnect without using up attempts
+        uint32_t waitStartMs = millis();
+        while (WiFi.status() != WL_CONNECTED && millis() - waitStartMs < OTA_RESUME_WIFI_WAIT_MS) {
+            delay(100);
+        }
+        
+        HTTPClient http;
+        int remaining = 0;
+        int httpCode = openImageDownload(http, firmwareUrl, received, remaining);
+        uint32_t before = received;
+        
+        if (httpCode == HTTP_CODE_OK && received > 0) {
+            // The server ignored the range; start over
+            addLogEntryf(LOG_WARN, "OTA: Server does not support resuming, restarting download");
             http.end();
+            startOffset = 0;
+            restart = true;
+            clearDownloadResume(resumeUrl);
+            if (++failedAttempts > resumeAttempts) {
+                failure = "Download could not be resumed";
+            }
+            continue;
+        }
+        
+        if ((httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_PARTIAL_CONTENT) && remaining > 0) {
+            total = received + remaining;
+            lockState();
+            totalBytes = total;
+            unlockState();
             
-            delay(2000);
-            ESP.restart();
-            return true;
-        } else {
-            statusMessage = "Update failed: " + String(Update.getError());
+            // This task only receives; decompression and flash writes run
+            // on the flash task. A buffer is handed over when it is full
+            // or the socket runs dry, so neither side waits for the other.
+            WiFiClient* client = http.getStreamPtr();
+            uint32_t lastDataMs = millis();
+            while (received < total) {
+                size_t available = client->available();
+                if (available == 0) {
+                    if (fill > 0 && !pushBuffer()) {
+                        break;
+                    }
+                    if (!client->connected() || millis() - lastDataMs > OTA_DOWNLOAD_TIMEOUT_MS) {
+                        break;
+                    }
+                    delay(1);
+                    continue;
+                }
+                if (buffer == nullptr) {
+                    buffer = pipeline.acquire();
+                }
+                size_t space = OTA_PIPELINE_BUFFER_SIZE - fill;
+                int length = client->read(buffer + fill, available < space ? available : space);
+                if (length <= 0) {
+                    continue;
+                }
+                lastDataMs = millis();
+                fill += length;
+                received += length;
+                if (fill == OTA_PIPELINE_BUFFER_SIZE && !pushBuffer()) {
+                    break;
+                }
+                
+                if (resumable && pipeline.getFlushedBytes() - committed >= OTA_RESUME_COMMIT_BYTES) {
+                    committed = pipeline.getFlushedBytes();
+                    saveDownloadResume(resumeUrl, partition, expectedDigest, committed);
+                }
+                
+                lockState();
+                bytesWritten = received;
+                imageBytes = pipeline.getImageBytes();
+                pipelineStats = pipeline.getStats();
+                unlockState();
+            }
+            if (fill > 0) {
+                pushBuffer();
+            }
+            if (pipeline.failed()) {
+                failure = "Image write failed";
+            }
+        } else if (httpCode >= 400 && httpCode != 408 && httpCode != 429 && httpCode < 500) {
+            failure = "Download failed";
+            addLogEntryf(LOG_ERROR, "OTA: Download failed, code %d", httpCode);
         }
-    } else {
-        statusMessage = "Partial update: " + String(written) + "/" + String(contentLength);
+        http.end();
+        
+        if (failure != nullptr || (total > 0 && received == total)) {
+            break;
+        }
+        if (received > before) {
+            failedAttempts = 0;
+        }
+        if (++failedAttempts > resumeAttempts) {
+            failure = "Download interrupted";
+            break;
+        }
+        resumes++;
+        addLogEntryf(LOG_WARN, "OTA: Download interrupted at %lu/%lu bytes (code %d), retry %lu",
+                     (unsigned long)received, (unsigned long)total, httpCode, (unsigned long)failedAttempts);
+        delay(OTA_RESUME_DELAY_MS * failedAttempts);
     }
     
-    currentStatus = OTA_UPDATE_ERROR;
-    http.end();
-    return false;
+    // Let the flash task write what is queued; the writers are ours again
+    pipeline.end();
+    if (pipeline.failed()) {
+        failure = writer.getError();
+    }
+    OTAPipelineStats stats = pipeline.getStats();
+    lockState();
+    downloadEndMs = millis();
+    imageBytes = writer.getImageBytes();
+    pipelineStats = stats;
+    unlockState();
+    
+    uint8_t digest[OTA_SHA256_SIZE];
+    if (failure == nullptr && !writer.finish(digest)) {
+        failure = writer.getError();
+    }
+    if (failure == nullptr && verify && memcmp(digest, expectedDigest, OTA_SHA256_SIZE) != 0) {
+        failure = "Image checksum mismatch";
+    }
+    if (failure != nullptr) {
+        // A bad image must not be resumed; an interrupted one may be
+        if (strcmp(failure, "Download interrupted") != 0) {
+            clearDownloadResume(resumeUrl);
+        }
+        setStatus(OTA_UPDATE_ERROR, String(failure) + " at " + String(received) + "/" + String(total));
+        return false;
+    }
+    
+    addLogEntryf(LOG_INFO, "OTA: %lu byte image from %lu bytes downloaded (%lu%%) in %lu ms, %u resumes%s",
+                 (unsigned long)writer.getImageBytes(), (unsigned long)(received - startOffset),
+                 (unsigned long)((uint64_t)received * 100 / (writer.getImageBytes() ? writer.getImageBytes() : 1)),
+                 (unsigned long)(downloadEndMs - downloadStartMs), resumes, verify ? ", SHA-256 verified" : "");
+    addLogEntryf(LOG_INFO, "OTA: Network waited %lu ms for buffers; flash busy %lu ms (%lu KB/s), waited %lu ms for data, %lu sectors erased ahead",
+                 (unsigned long)stats.networkStallMs, (unsigned long)stats.flashBusyMs,
+                 (unsigned long)(stats.flashBusyMs ? (uint64_t)stats.bytes / stats.flashBusyMs : 0),
+                 (unsigned long)stats.flashStallMs, (unsigned long)stats.erasedAhead);
+    
+    if (!flash.commit()) {
+        clearDownloadResume(resumeUrl);
+        setStatus(OTA_UPDATE_ERROR, "Update failed: image rejected");
+        return false;
+    }
+    clearDownloadResume(resumeUrl);
+    
+    setStatus(OTA_UPDATE_SUCCESS, "Update successful! Rebooting...");
+    addLogEntryf(LOG_WARN, "OTA: Update installed, restarting");
+    publishOTAEvent();
+    
+    delay(2000);
+    ESP.restart();
+    return true;
+}
+
+void OTAManager::installTask(void* parameter) {
+    OTAManager* manager = static_cast<OTAManager*>(parameter);
+    // performUpdate() only returns if the update failed; success restarts
+    // the device. A failed delta leaves the running firmware untouched,
+    // so the full image is tried next.
+    if (manager->installPatchUrl.length() > 0) {
+        if (manager->performUpdate(manager->installPatchUrl)) {
+            vTaskDelete(nullptr);
+        }
+        addLogEntryf(LOG_WARN, "OTA: Delta update failed (%s), downloading full image",
+                     manager->getStatusMessage().c_str());
+        manager->setStatus(OTA_UPDATE_DOWNLOADING, "Downloading firmware...");
+        publishOTAEvent();
+    }
+    bool installed = manager->performUpdate(manager->installUrl);
+    if (!installed && manager->installFallbackUrl.length() > 0) {
+        addLogEntryf(LOG_WARN, "OTA: Resuming with the plain image failed (%s), downloading %s",
+                     manager->getStatusMessage().c_str(), manager->installFallbackUrl.c_str());
+        manager->setStatus(OTA_UPDATE_DOWNLOADING, "Downloading firmware...");
+        publishOTAEvent();
+        installed = manager->performUpdate(manager->installFallbackUrl);
+    }
+    if (!installed) {
+        addLogEntryf(LOG_ERROR, "OTA: Install failed: %s", manager->getStatusMessage().c_str());
+        publishOTAEvent();
+    }
+    vTaskDelete(nullptr);
 }
 
 bool OTAManager::installLatestRelease() {
-    Serial.println("OTA: Install latest release requested");
-    Serial.print("Available: ");
-    Serial.println(updateAvailable ? "true" : "false");
-    Serial.print("URL: ");
-    Serial.println(latestReleaseUrl);
-    
-    if (!updateAvailable || latestReleaseUrl.isEmpty()) {
-        Serial.println("OTA Error: No update available or URL empty");
+    lockState();
+    String releaseUrl = latestReleaseUrl;
+    String patchUrl = latestPatchUrl;
+    unlockState();
+    // A download a reboot interrupted continues with the plain image; a
+    // delta would write over the part already in flash
+    String resumeUrl = resumeUrlFor(releaseUrl);
+    bool resuming = hasDownloadResume(resumeUrl);
+    
+    lockState();
+    if (isBusy() || !updateAvailable || latestReleaseUrl.isEmpty() || latestReleaseUrl != releaseUrl) {
+        unlockState();
+        LOGW("OTA: Install requested but no update is available or one is running");
         return false;
     }
     
-    Serial.println("Installing update...");
-    Serial.print("Version: ");
-    Serial.println(latestVersion);
-    
-    log_i("Installing update: %s", latestVersion.c_str());
-    
-    bool result = performUpdate(latestReleaseUrl);
-    Serial.print("Install result: ");
-    Serial.println(result ? "SUCCESS" : "FAILED");
-    return result;
-}
\ No newline at end of file
+    // Claim the update before the task starts so no check or second
+    // install can slip in
+    installUrl = resuming ? resumeUrl : releaseUrl;
+    installFallbackUrl = resuming && resumeUrl != releaseUrl ? releaseUrl : String();
+    installPatchUrl = resuming ? String() : patchUrl;
+    currentStatus = OTA_UPDATE_DOWNLOADING;
+    statusMessage = "Downloading firmware...";
+    bytesWritten = 0;
+    totalBytes = 0;
+    imageBytes = 0;
+    downloadStartMs = 0;
+    downloadEndMs = 0;
+    unlockState();
+    
+    addLogEntryf(LOG_INFO, "OTA: Installing update %s", getLatestVersion().c_str());
+    if (xTaskCreatePinnedToCore(installTask, "ota", OTA_TASK_STACK, this,
+                                tskIDLE_PRIORITY + 1, nullptr, OTA_TASK_CORE) != pdPASS) {
+        setStatus(OTA_UPDATE_ERROR, "Could not start update task");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,130 @@
+#include "ota_pipeline.h"
+#include "ota_config.h"
+#include <Arduino.h>
+#include <stdlib.h>
+
+bool OTAPipeline::begin(OTAImageWriter* writer, OTAFlashWriter* flash) {
+    end();
+    this->writer = writer;
+    this->flash = flash;
+    writeFailed = false;
+    imageBytes = 0;
+    flushedBytes = flash->getFlushedBytes();
+    flashBusyUs = 0;
+    flashStallUs = 0;
+    erasedAhead = 0;
+    pushedBytes = 0;
+    networkStallUs = 0;
+
+    buffers = (uint8_t*)malloc((size_t)OTA_PIPELINE_BUFFERS * OTA_PIPELINE_BUFFER_SIZE);
+    freeQueue = xQueueCreate(OTA_PIPELINE_BUFFERS, sizeof(uint8_t*));
+    fullQueue = xQueueCreate(OTA_PIPELINE_BUFFERS + 1, sizeof(Chunk));  // + the stop marker
+    if (buffers == nullptr || freeQueue == nullptr || fullQueue == nullptr) {
+        end();
+        return false;
+    }
+    for (int i = 0; i < OTA_PIPELINE_BUFFERS; i++) {
+        uint8_t* buffer = buffers + (size_t)i * OTA_PIPELINE_BUFFER_SIZE;
+        xQueueSend(freeQueue, &buffer, 0);
+    }
+
+    owner = xTaskGetCurrentTaskHandle();
+    if (xTaskCreatePinnedToCore(flashTask, "ota_flash", OTA_TASK_STACK, this,
+                                tskIDLE_PRIORITY + 1, nullptr, OTA_FLASH_TASK_CORE) != pdPASS) {
+        end();
+        return false;
+    }
+    running = true;
+    return true;
+}
+
+void OTAPipeline::end() {
+    if (running) {
+        Chunk stop = {nullptr, 0};
+        xQueueSend(fullQueue, &stop, portMAX_DELAY);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        running = false;
+    }
+    if (freeQueue != nullptr) {
+        vQueueDelete(freeQueue);
+        freeQueue = nullptr;
+    }
+    if (fullQueue != nullptr) {
+        vQueueDelete(fullQueue);
+        fullQueue = nullptr;
+    }
+    if (buffers != nullptr) {
+        free(buffers);
+        buffers = nullptr;
+    }
+}
+
+uint8_t* OTAPipeline::acquire() {
+    if (!running) {
+        return nullptr;
+    }
+    uint8_t* buffer = nullptr;
+    if (xQueueReceive(freeQueue, &buffer, 0) != pdTRUE) {
+        uint32_t startUs = micros();
+        xQueueReceive(freeQueue, &buffer, portMAX_DELAY);
+        networkStallUs += micros() - startUs;
+    }
+    return buffer;
+}
+
+bool OTAPipeline::push(uint8_t* buffer, size_t length) {
+    Chunk chunk = {buffer, length};
+    xQueueSend(fullQueue, &chunk, portMAX_DELAY);
+    pushedBytes += length;
+    return !writeFailed;
+}
+
+OTAPipelineStats OTAPipeline::getStats() const {
+    OTAPipelineStats stats;
+    stats.bytes = pushedBytes;
+    stats.networkStallMs = networkStallUs / 1000;
+    stats.flashBusyMs = flashBusyUs / 1000;
+    stats.flashStallMs = flashStallUs / 1000;
+    stats.erasedAhead = erasedAhead;
+    return stats;
+}
+
+void OTAPipeline::flashTask(void* parameter) {
+    OTAPipeline* pipeline = static_cast<OTAPipeline*>(parameter);
+    pipeline->runFlash();
+    xTaskNotifyGive(pipeline->owner);
+    vTaskDelete(nullptr);
+}
+
+void OTAPipeline::runFlash() {
+    for (;;) {
+        Chunk chunk;
+        if (xQueueReceive(fullQueue, &chunk, 0) != pdTRUE) {
+            // Nothing to write yet: erase ahead meanwhile, then wait
+            uint32_t startUs = micros();
+            if (!writeFailed && flash->eraseAhead(OTA_PIPELINE_ERASE_AHEAD)) {
+                flashBusyUs += micros() - startUs;
+                erasedAhead += 1;
+                continue;
+            }
+            xQueueReceive(fullQueue, &chunk, portMAX_DELAY);
+            flashStallUs += micros() - startUs;
+        }
+        if (chunk.buffer == nullptr) {
+            return;
+        }
+
+        // After a failure, keep returning buffers so the download task
+        // never blocks; it sees the failure on its next push()
+        if (!writeFailed) {
+            uint32_t startUs = micros();
+            if (!writer->write(chunk.buffer, chunk.length)) {
+                writeFailed = true;
+            }
+            flashBusyUs += micros() - startUs;
+            imageBytes = writer->getImageBytes();
+            flushedBytes = flash->getFlushedBytes();
+        }
+        xQueueSend(freeQueue, &chunk.buffer, portMAX_DELAY);
+    }
+}
@@ -0,0 +1,162 @@
+#include "rollup_engine.h"
+#include <string.h>
+
+#define ROLLUP_EMPTY_START 0xFFFFFFFFUL
+
+static const uint32_t resolutionWidths[ROLLUP_RESOLUTION_COUNT] = {60, 3600, 86400};
+static const uint32_t resolutionSlots[ROLLUP_RESOLUTION_COUNT] = {
+    ROLLUP_MINUTE_SLOTS, ROLLUP_HOUR_SLOTS, ROLLUP_DAY_SLOTS
+};
+static const char* const resolutionNames[ROLLUP_RESOLUTION_COUNT] = {"minute", "hour", "day"};
+static const char* const seriesNames[ROLLUP_SERIES_COUNT] = {"temperature", "humidity", "pressure"};
+
+size_t RollupEngine::requiredBytes() {
+    size_t buckets = 0;
+    for (int i = 0; i < ROLLUP_RESOLUTION_COUNT; i++) {
+        buckets += resolutionSlots[i];
+    }
+    return buckets * sizeof(RollupBucket);
+}
+
+bool RollupEngine::begin(uint8_t* memory, size_t bytes) {
+    if (memory == nullptr || bytes < requiredBytes()) {
+        return false;
+    }
+
+    RollupBucket* bucket = reinterpret_cast<RollupBucket*>(memory);
+    for (int i = 0; i < ROLLUP_RESOLUTION_COUNT; i++) {
+        levels[i] = bucket;
+        for (uint32_t slot = 0; slot < resolutionSlots[i]; slot++) {
+            bucket[slot].start = ROLLUP_EMPTY_START;
+        }
+        bucket += resolutionSlots[i];
+    }
+    samplesAdded = 0;
+    newestTimestamp = 0;
+    return true;
+}
+
+void RollupEngine::addSample(RollupSeries series, uint32_t timestamp, float value) {
+    if (!isReady() || series >= ROLLUP_SERIES_COUNT || value != value) {
+        return;  // Not started, bad series or NaN
+    }
+
+    if (timestamp > newestTimestamp) {
+        newestTimestamp = timestamp;
+    }
+
+    for (int i = 0; i < ROLLUP_RESOLUTION_COUNT; i++) {
+        RollupResolution resolution = (RollupResolution)i;
+        if (!retains(resolution, timestamp)) {
+            continue;
+        }
+
+        uint32_t width = resolutionWidths[i];
+        uint32_t start = timestamp - timestamp % width;
+        RollupBucket& bucket = levels[i][(timestamp / width) % resolutionSlots[i]];
+        if (bucket.start != start) {
+            // Slot still holds an older period: reuse it
+            memset(&bucket, 0, sizeof(bucket));
+            bucket.start = start;
+        }
+
+        RollupAggregate& aggregate = bucket.series[series];
+        if (aggregate.count == 0) {
+            aggregate.min = value;
+            aggregate.max = value;
+        } else {
+            if (value < aggregate.min) aggregate.min = value;
+            if (value > aggregate.max) aggregate.max = value;
+        }
+        aggregate.sum += value;
+        aggregate.count++;
+    }
+    samplesAdded++;
+}
+
+bool RollupEngine::retains(RollupResolution resolution, uint32_t timestamp) const {
+    uint32_t width = resolutionWidths[resolution];
+    uint32_t newestStart = newestTimestamp - newestTimestamp % width;
+    uint32_t span = (resolutionSlots[resolution] - 1) * width;
+    return newestStart < span || timestamp >= newestStart - span;
+}
+
+RollupResolution RollupEngine::selectResolution(uint32_t from, uint32_t to, uint32_t points) const {
+    if (to < from) {
+        to = from;
+    }
+
+    for (int i = ROLLUP_RESOLUTION_COUNT - 1; i >= 0; i--) {
+        RollupResolution resolution = (RollupResolution)i;
+        uint32_t width = resolutionWidths[i];
+        uint32_t periods = (to / width) - (from / width) + 1;
+        if (periods >= points && retains(resolution, from)) {
+            return resolution;
+        }
+    }
+
+    for (int i = 0; i < ROLLUP_RESOLUTION_COUNT; i++) {
+        if (retains((RollupResolution)i, from)) {
+            return (RollupResolution)i;
+        }
+    }
+    return (RollupResolution)(ROLLUP_RESOLUTION_COUNT - 1);
+}
+
+uint32_t RollupEngine::query(RollupResolution resolution, uint32_t from, uint32_t to,
+                             RollupVisitor visitor, void* context) const {
+    if (!isReady() || resolution >= ROLLUP_RESOLUTION_COUNT || to < from) {
+        return 0;
+    }
+
+    uint32_t width = resolutionWidths[resolution];
+    uint32_t slots = resolutionSlots[resolution];
+    uint32_t first = from - from % width;
+    uint32_t last = to - to % width;
+
+    // Only the newest 'slots' periods can still be in the ring
+    if ((last - first) / width >= slots) {
+        first = last - (slots - 1) * width;
+    }
+
+    uint32_t visited = 0;
+    for (uint32_t start = first; ; start += width) {
+        const RollupBucket& bucket = levels[resolution][(start / width) % slots];
+        if (bucket.start == start) {
+            visited++;
+            if (!visitor(bucket, context)) {
+                break;
+            }
+        }
+        if (start == last) {
+            break;
+        }
+    }
+    return visited;
+}
+
+uint32_t RollupEngine::widthSeconds(RollupResolution resolution) {
+    return resolutionWidths[resolution];
+}
+
+uint32_t RollupEngine::slotCount(RollupResolution resolution) {
+    return resolutionSlots[resolution];
+}
+
+const char* RollupEngine::resolutionName(RollupResolution resolution) {
+    return resolution < ROLLUP_RESOLUTION_COUNT ? resolutionNames[resolution] : "unknown";
+}
+
+bool RollupEngine::parseResolution(const char* name, RollupResolution& resolution) {
+    for (int i = 0; i < ROLLUP_RESOLUTION_COUNT; i++) {
+        if (strcmp(name, resolutionNames[i]) == 0) {
+            resolution = (RollupResolution)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* RollupEngine::seriesName(RollupSeries series) {
+    return series < ROLLUP_SERIES_COUNT ? seriesNames[series] : "unknown";
+}
@@ -0,0 +1,113 @@
+#include "scheduler.h"
+#include <string.h>
+
+// Wrap-safe "a is at or after b" for 32-bit microsecond timestamps
+static inline bool timeReached(uint32_t now, uint32_t deadline) {
+    return (int32_t)(now - deadline) >= 0;
+}
+
+Scheduler::Scheduler(SchedulerClockFn clock, SchedulerSleepFn sleep)
+    : clockFn(clock), sleepFn(sleep) {
+    memset(jobs, 0, sizeof(jobs));
+}
+
+int Scheduler::addJob(const char* name, SchedulerJobFn fn, uint32_t periodUs) {
+    if (jobCount >= SCHEDULER_MAX_JOBS || fn == nullptr) {
+        return -1;
+    }
+
+    SchedulerJob& job = jobs[jobCount];
+    job.name = name;
+    job.fn = fn;
+    job.periodUs = periodUs;
+    job.nextDueUs = clockFn() + periodUs;
+    memset(&job.stats, 0, sizeof(job.stats));
+    return jobCount++;
+}
+
+const SchedulerJob* Scheduler::getJob(int index) const {
+    if (index < 0 || index >= jobCount) {
+        return nullptr;
+    }
+    return &jobs[index];
+}
+
+void Scheduler::resetStats() {
+    for (int i = 0; i < jobCount; i++) {
+        memset(&jobs[i].stats, 0, sizeof(jobs[i].stats));
+    }
+    passCount = 0;
+    totalSleepUs = 0;
+}
+
+void Scheduler::runJob(SchedulerJob& job, uint32_t startUs) {
+    SchedulerJobStats& stats = job.stats;
+
+    if (job.periodUs > 0) {
+        uint32_t jitter = startUs - job.nextDueUs;
+        stats.lastJitterUs = jitter;
+        stats.totalJitterUs += jitter;
+        if (jitter > stats.maxJitterUs) {
+            stats.maxJitterUs = jitter;
+        }
+
+        // Advance on the original grid so jitter never accumulates as drift;
+        // whole periods that were missed count as overruns and are skipped
+        job.nextDueUs += job.periodUs;
+        if (timeReached(startUs, job.nextDueUs)) {
+            uint32_t missed = (startUs - job.nextDueUs) / job.periodUs + 1;
+            stats.overruns += missed;
+            job.nextDueUs += missed * job.periodUs;
+        }
+    }
+
+    job.fn();
+
+    uint32_t runUs = clockFn() - startUs;
+    stats.lastRunUs = runUs;
+    if (runUs > stats.maxRunUs) {
+        stats.maxRunUs = runUs;
+    }
+    stats.runs++;
+}
+
+void Scheduler::runOnce() {
+    uint32_t passStart = clockFn();
+    for (int i = 0; i < jobCount; i++) {
+        SchedulerJob& job = jobs[i];
+        uint32_t now = clockFn();
+        if (job.periodUs == 0 || timeReached(now, job.nextDueUs)) {
+            runJob(job, now);
+        }
+    }
+    passCount++;
+    lastPassUs = clockFn() - passStart;
+
+    uint32_t sleepUs = timeUntilNextDeadline();
+    if (sleepUs > 0 && sleepFn != nullptr) {
+        sleepFn(sleepUs);
+        totalSleepUs += sleepUs;
+    }
+}
+
+uint32_t Scheduler::timeUntilNextDeadline() const {
+    uint32_t now = clockFn();
+    bool found = false;
+    uint32_t earliest = 0;
+
+    for (int i = 0; i < jobCount; i++) {
+        const SchedulerJob& job = jobs[i];
+        if (job.periodUs == 0) {
+            continue;  // Continuous jobs piggyback on the periodic wakeups
+        }
+        if (timeReached(now, job.nextDueUs)) {
+            return 0;
+        }
+        uint32_t remaining = job.nextDueUs - now;
+        if (!found || remaining < earliest) {
+            earliest = remaining;
+            found = true;
+        }
+    }
+    return earliest;
+}
@@ -1,9 +1,16 @@
 #include "sensors.h"
 #include "config.h"
+#include "sensor_registry.h"
+#include "beam_edge_queue.h"
+#include "beam_analytics.h"
+#include "environment_history.h"
+#include "event_stream.h"
+#include "system_log.h"
+#include "metrics.h"
+#include "config_store.h"
 
 #ifdef ENABLE_DHT22
-#include <DHT.h>
-DHT dht(DHT22_PIN, DHT22);
+#include "dht22_driver.h"
 #endif
 
 #ifdef ENABLE_BMP280
@@ -12,209 +19,403 @@ DHT dht(DHT22_PIN, DHT22);
 Adafruit_BMP280 bmp; // I2C interface
 #endif
 
-// Global sensor data
-SensorData currentSensorData = {false, 0, 0, 0, 0, 0, 0, false};
+// Global sensor data. Written by the sensor jobs on the loop task; the web
+// server and event stream read it from their own tasks on the other core,
+// so writes and their copies (with beamAnalytics, which changes with the
+// beam state) are taken under sensorDataLock.
+SensorData currentSensorData = {false, 0, 0, 0, 0, 0, 0, 0, 0, false};
+portMUX_TYPE sensorDataLock = portMUX_INITIALIZER_UNLOCKED;
 
+// Read at scrape time from the existing counters, so the ISR and the
+// filter do no extra work
+static uint32_t readBeamRejectedGlitches() { return getBeamFilterStats().rejectedGlitches; }
+MetricCounter beamEdgesMetric("garage_beam_isr_edges_total", "Beam edges captured by the ISR", getBeamEdgeCount);
+MetricCounter beamRejectsMetric("garage_beam_debounce_rejects_total", "Beam excursions rejected by the glitch filter",
+                                readBeamRejectedGlitches);
+
+#ifdef ENABLE_E3JK_RR11
 // E3JK-RR11 variables
-volatile bool e3jkStateChanged = false;
-volatile bool e3jkBeamBroken = false;
-unsigned long lastDebounceTime = 0;
+// Every edge is queued by the ISR with its micros() timestamp and drained in
+// order by readE3JKRR11(), so short breaks between loop passes are not lost.
+BeamEdgeQueue<E3JK_EDGE_QUEUE_SIZE> beamEdgeQueue;
+uint32_t lastSeenOverflowCount = 0;
 
-void initializeSensors() {
-  Serial.println("Initializing sensors...");
-  
-  #ifdef ENABLE_E3JK_RR11
-  pinMode(E3JK_RR11_PIN, INPUT);
-  pinMode(LED_INDICATOR_PIN, OUTPUT);
-  digitalWrite(LED_INDICATOR_PIN, LOW); // Start with LED off (beam clear)
-  
-  // Setup interrupt for E3JK-RR11
-  setupE3JKRR11Interrupt();
-  Serial.println("E3JK-RR11 photoelectric sensor initialized");
-  Serial.println("LED will turn ON when beam is BROKEN");
-  #endif
-  
-  #ifdef ENABLE_DHT22
-  dht.begin();
-  Serial.println("DHT22 sensor initialized");
-  Serial.printf("DHT22 using pin A5 (GPIO %d)\n", DHT22_PIN);
-  
-  // Test initial read after a delay
-  delay(2000);  // DHT22 needs time to stabilize
-  float testTemp = dht.readTemperature();
-  float testHum = dht.readHumidity();
-  
-  if (isnan(testTemp) || isnan(testHum)) {
-    Serial.println("⚠️  DHT22 initial test read FAILED!");
-    Serial.println("   Check connections:");
-    Serial.printf("   - Data pin A5 (GPIO %d) connected?\n", DHT22_PIN);
-    Serial.println("   - 3.3V power connected?");
-    Serial.println("   - Ground connected?");
-    Serial.println("   - 4.7kΩ pull-up resistor from data to 3.3V?");
-  } else {
-    Serial.printf("✅ DHT22 initial test: %.1f°C, %.1f%% humidity\n", testTemp, testHum);
+// Raw edges pass through the glitch filter before reaching currentSensorData.
+// New settings are staged and picked up by the next drain so they can be
+// changed from any context. The web server runs on its own task, so the
+// staged and applied copies are only touched under filterConfigLock.
+// Settings come from the config store ("beam.*"); the drain stages them
+// again when a write to the store changes them.
+static void applyBeamState(bool beamBroken, uint32_t edgeMicros);
+BeamFilter beamFilter(applyBeamState);
+BeamFilterConfig stagedFilterConfig = {
+  E3JK_FILTER_MODE, E3JK_DEBOUNCE_TIME * 1000UL, E3JK_INTEGRATE_US,
+  E3JK_MAJORITY_SAMPLE_US, E3JK_MAJORITY_N, E3JK_MAJORITY_M
+};
+BeamFilterConfig appliedFilterConfig = stagedFilterConfig;
+bool filterConfigStaged = true;
+portMUX_TYPE filterConfigLock = portMUX_INITIALIZER_UNLOCKED;
+uint32_t filterConfigGeneration = UINT32_MAX;   // Load the stored settings on the first drain
+#endif
+
+// ---------------------------------------------------------------------------
+// Sensor types (see sensor_registry.h). Each enabled sensor is a type with
+// init/sample/period; a disabled sensor is DisabledSensor and costs nothing.
+// ---------------------------------------------------------------------------
+
+#if defined(ENABLE_E3JK_RR11) && defined(ENABLE_SIMULATION_MODE)
+// Simulated beam: break/clear every SIMULATION_BEAM_INTERVAL, no hardware needed
+struct BeamSensor {
+  static const char* name() { return "beam"; }
+  static constexpr uint32_t periodUs() { return BEAM_DRAIN_INTERVAL_US; }
+
+  static void init() {
+    pinMode(LED_INDICATOR_PIN, OUTPUT);
+    digitalWrite(LED_INDICATOR_PIN, LOW);
+    Serial.println("E3JK-RR11 simulated (ENABLE_SIMULATION_MODE)");
   }
-  #endif
-  
-  #ifdef ENABLE_BMP280
-  Wire.begin(BMP280_SDA_PIN, BMP280_SCL_PIN);
-  if (!bmp.begin(0x76)) { // Try default address first
-    if (!bmp.begin(0x77)) { // Try alternative address
-      Serial.println("Could not find a valid BMP280 sensor, check wiring!");
-    } else {
-      Serial.println("BMP280 sensor initialized (address 0x77)");
+
+  static void sample() {
+    static unsigned long lastSimulation = 0;
+    static bool simulatedBeamBroken = false;
+
+    if (millis() - lastSimulation >= SIMULATION_BEAM_INTERVAL) {
+      lastSimulation = millis();
+      simulatedBeamBroken = !simulatedBeamBroken;
+      portENTER_CRITICAL(&sensorDataLock);
+      currentSensorData.beamBroken = simulatedBeamBroken;
+      currentSensorData.lastStateChangeTime = millis();
+      beamAnalytics.recordTransition(simulatedBeamBroken, currentSensorData.lastStateChangeTime);
+      portEXIT_CRITICAL(&sensorDataLock);
+
+      // Update LED for simulation
+      digitalWrite(LED_INDICATOR_PIN, simulatedBeamBroken ? HIGH : LOW);
+      publishBeamEvent(simulatedBeamBroken, currentSensorData.lastStateChangeTime);
+
+      if (simulatedBeamBroken) {
+        LOGW("SIMULATION: Beam broken - object detected!");
+      } else {
+        LOGI("SIMULATION: Beam clear - path restored");
+      }
     }
-  } else {
-    Serial.println("BMP280 sensor initialized (address 0x76)");
   }
-  
-  // Configure BMP280 settings
-  bmp.setSampling(Adafruit_BMP280::MODE_NORMAL,     /* Operating Mode. */
-                  Adafruit_BMP280::SAMPLING_X2,     /* Temp. oversampling */
-                  Adafruit_BMP280::SAMPLING_X16,    /* Pressure oversampling */
-                  Adafruit_BMP280::FILTER_X16,      /* Filtering. */
-                  Adafruit_BMP280::STANDBY_MS_500); /* Standby time. */
-  #endif
-  
-  #ifdef ENABLE_ANALOG_SENSOR
-  pinMode(ANALOG_SENSOR_PIN, INPUT);
-  Serial.println("Analog sensor pin configured");
-  #endif
-  
-  Serial.println("All sensors initialized successfully!");
-}
+};
+#elif defined(ENABLE_E3JK_RR11)
+// E3JK-RR11 photoelectric sensor: drains the ISR edge queue through the filter
+struct BeamSensor {
+  static const char* name() { return "beam"; }
+  static constexpr uint32_t periodUs() { return BEAM_DRAIN_INTERVAL_US; }
 
-void readAllSensors() {
-  if (DEBUG_SENSORS) {
-    Serial.println("\n--- Reading Sensors ---");
+  static void init() {
+    pinMode(E3JK_RR11_PIN, INPUT);
+    pinMode(LED_INDICATOR_PIN, OUTPUT);
+    digitalWrite(LED_INDICATOR_PIN, LOW); // Start with LED off (beam clear)
+
+    // Setup interrupt for E3JK-RR11
+    setupE3JKRR11Interrupt();
+    Serial.println("E3JK-RR11 photoelectric sensor initialized");
+    Serial.println("LED will turn ON when beam is BROKEN");
   }
-  
-  // Reset data validity
-  currentSensorData.dataValid = false;
-  
-  #ifdef ENABLE_E3JK_RR11
-  readE3JKRR11();
-  #endif
-  
-  #ifdef ENABLE_DHT22
-  readDHT22();
-  #endif
-  
-  #ifdef ENABLE_BMP280
-  readBMP280();
-  #endif
-  
-  #ifdef ENABLE_ANALOG_SENSOR
-  readAnalogSensor();
-  #endif
-  
-  currentSensorData.dataValid = true;
-  
-  if (DEBUG_SENSORS) {
-    Serial.println("--- Sensor Reading Complete ---\n");
+
+  static void sample() {
+    readE3JKRR11();
   }
-}
+};
+#else
+typedef DisabledSensor BeamSensor;
+#endif
 
 #ifdef ENABLE_DHT22
-void readDHT22() {
-  Serial.printf("Reading DHT22 from pin A5 (GPIO %d)...\n", DHT22_PIN);
-  
-  float humidity = dht.readHumidity();
-  float temperature = dht.readTemperature();
-  
-  Serial.printf("Raw DHT22 readings: Temp=%.2f, Humidity=%.2f\n", temperature, humidity);
-  
-  if (isnan(humidity) || isnan(temperature)) {
-    Serial.println("❌ Failed to read from DHT22 sensor!");
-    Serial.println("   Possible issues:");
-    Serial.println("   - Missing 4.7kΩ pull-up resistor on data line");
-    Serial.println("   - Loose connections");
-    Serial.println("   - Sensor defective");
-    Serial.printf("   - Check GPIO %d is correct for A5 on your board\n", DHT22_PIN);
-    currentSensorData.dataValid = false;
-    return;
+// DHT22: the driver's state machine is stepped every poll; a new reading is
+// published to currentSensorData as soon as a frame decodes
+struct Dht22Sensor {
+  static const char* name() { return "dht22"; }
+  static constexpr uint32_t periodUs() { return DHT22_POLL_INTERVAL_US; }
+
+  static void init() {
+    // Non-blocking driver: the first read happens DHT22_STARTUP_DELAY after boot
+    dht22Driver.begin();
+    Serial.println("DHT22 sensor initialized");
+    Serial.printf("DHT22 using pin A5 (GPIO %d)\n", DHT22_PIN);
   }
-  
-  currentSensorData.temperature = temperature;
-  currentSensorData.humidity = humidity;
-  currentSensorData.dataValid = true;
-  
-  if (DEBUG_SENSORS) {
-    Serial.printf("✅ DHT22 - Temperature: %.2f°C, Humidity: %.2f%%\n", 
-                  temperature, humidity);
+
+  static void sample() {
+    static uint32_t publishedReadings = 0;
+    static uint32_t reportedErrors = 0;
+
+    dht22Driver.poll();
+
+    if (dht22Driver.getErrorCount() != reportedErrors) {
+      reportedErrors = dht22Driver.getErrorCount();
+      LOGW("Failed to read from DHT22 sensor: %s (%lu errors)",
+           dht22DecodeResultString(dht22Driver.getLastResult()), (unsigned long)reportedErrors);
+      if (!dht22Driver.hasReading()) {
+        LOGW("DHT22 never read: check the 4.7kΩ pull-up, wiring and GPIO %d", DHT22_PIN);
+      }
+    }
+
+    if (dht22Driver.getReadingCount() == publishedReadings) {
+      return;  // Nothing new; the cached values stay in place
+    }
+    publishedReadings = dht22Driver.getReadingCount();
+
+    const Dht22Reading& reading = dht22Driver.getReading();
+    portENTER_CRITICAL(&sensorDataLock);
+    currentSensorData.temperature = reading.temperature;
+    currentSensorData.humidity = reading.humidity;
+    currentSensorData.environmentTimestamp = dht22Driver.getReadingTime();
+    currentSensorData.dataValid = true;
+    portEXIT_CRITICAL(&sensorDataLock);
+    recordEnvironmentRollup(ROLLUP_TEMPERATURE, reading.temperature);
+    recordEnvironmentRollup(ROLLUP_HUMIDITY, reading.humidity);
+    publishEnvironmentEvent(reading.temperature, reading.humidity, currentSensorData.environmentTimestamp);
+
+    LOGD("DHT22 - Temperature: %.2f°C, Humidity: %.2f%%", reading.temperature, reading.humidity);
   }
-}
+};
 #else
-void readDHT22() {
-  // DHT22 disabled
-}
+typedef DisabledSensor Dht22Sensor;
 #endif
 
 #ifdef ENABLE_BMP280
-void readBMP280() {
-  float temperature = bmp.readTemperature();
-  float pressure = bmp.readPressure() / 100.0F; // Convert to hPa
-  float altitude = bmp.readAltitude(1013.25); // Sea level pressure in hPa
-  
-  if (isnan(temperature) || isnan(pressure)) {
-    Serial.println("Failed to read from BMP280 sensor!");
-    return;
+// BMP280 pressure/temperature over I2C
+struct Bmp280Sensor {
+  static const char* name() { return "bmp280"; }
+  static constexpr uint32_t periodUs() { return ENV_SENSOR_READ_INTERVAL * 1000UL; }
+
+  static void init() {
+    Wire.begin(BMP280_SDA_PIN, BMP280_SCL_PIN);
+    if (!bmp.begin(0x76)) { // Try default address first
+      if (!bmp.begin(0x77)) { // Try alternative address
+        Serial.println("Could not find a valid BMP280 sensor, check wiring!");
+      } else {
+        Serial.println("BMP280 sensor initialized (address 0x77)");
+      }
+    } else {
+      Serial.println("BMP280 sensor initialized (address 0x76)");
+    }
+
+    // Configure BMP280 settings
+    bmp.setSampling(Adafruit_BMP280::MODE_NORMAL,     /* Operating Mode. */
+                    Adafruit_BMP280::SAMPLING_X2,     /* Temp. oversampling */
+                    Adafruit_BMP280::SAMPLING_X16,    /* Pressure oversampling */
+                    Adafruit_BMP280::FILTER_X16,      /* Filtering. */
+                    Adafruit_BMP280::STANDBY_MS_500); /* Standby time. */
   }
-  
-  currentSensorData.pressure = pressure;
-  currentSensorData.altitude = altitude;
-  
-  // Use BMP280 temperature if DHT22 is not available
-  #ifndef ENABLE_DHT22
-  currentSensorData.temperature = temperature;
-  #endif
-  
-  if (DEBUG_SENSORS) {
-    Serial.printf("BMP280 - Temperature: %.2f°C, Pressure: %.2f hPa, Altitude: %.2fm\n", 
-                  temperature, pressure, altitude);
+
+  static void sample() {
+    float temperature = bmp.readTemperature();
+    float pressure = bmp.readPressure() / 100.0F; // Convert to hPa
+    float altitude = bmp.readAltitude(1013.25); // Sea level pressure in hPa
+
+    if (isnan(temperature) || isnan(pressure)) {
+      LOGW("Failed to read from BMP280 sensor!");
+      return;
+    }
+
+    portENTER_CRITICAL(&sensorDataLock);
+    currentSensorData.pressure = pressure;
+    currentSensorData.altitude = altitude;
+    // Use BMP280 temperature if DHT22 is not available
+    #ifndef ENABLE_DHT22
+    currentSensorData.temperature = temperature;
+    currentSensorData.environmentTimestamp = millis();
+    currentSensorData.dataValid = true;
+    #endif
+    portEXIT_CRITICAL(&sensorDataLock);
+
+    recordEnvironmentRollup(ROLLUP_PRESSURE, pressure);
+    #ifndef ENABLE_DHT22
+    recordEnvironmentRollup(ROLLUP_TEMPERATURE, temperature);
+    #endif
+
+    LOGD("BMP280 - Temperature: %.2f°C, Pressure: %.2f hPa, Altitude: %.2fm",
+         temperature, pressure, altitude);
   }
-}
+};
 #else
-void readBMP280() {
-  // BMP280 disabled
-}
+typedef DisabledSensor Bmp280Sensor;
 #endif
 
 #ifdef ENABLE_ANALOG_SENSOR
-void readAnalogSensor() {
-  int analogValue = analogRead(ANALOG_SENSOR_PIN);
-  currentSensorData.analogValue = analogValue;
-  
-  if (DEBUG_SENSORS) {
-    float voltage = (analogValue / 4095.0) * 3.3; // Convert to voltage for ESP32
-    Serial.printf("Analog Sensor - Raw: %d, Voltage: %.2fV\n", analogValue, voltage);
+// Optional analog input
+struct AnalogSensor {
+  static const char* name() { return "analog"; }
+  static constexpr uint32_t periodUs() { return ENV_SENSOR_READ_INTERVAL * 1000UL; }
+
+  static void init() {
+    pinMode(ANALOG_SENSOR_PIN, INPUT);
+    Serial.println("Analog sensor pin configured");
   }
-}
+
+  static void sample() {
+    int analogValue = analogRead(ANALOG_SENSOR_PIN);
+    portENTER_CRITICAL(&sensorDataLock);
+    currentSensorData.analogValue = analogValue;
+    portEXIT_CRITICAL(&sensorDataLock);
+
+    LOGD("Analog Sensor - Raw: %d, Voltage: %.2fV", analogValue,
+         (analogValue / 4095.0) * 3.3); // Convert to voltage for ESP32
+  }
+};
 #else
-void readAnalogSensor() {
-  // Analog sensor disabled
-}
+typedef DisabledSensor AnalogSensor;
 #endif
 
+// The enabled sensor set, resolved at compile time
+typedef SensorRegistry<BeamSensor, Dht22Sensor, Bmp280Sensor, AnalogSensor> EnabledSensors;
+
+void initializeSensors() {
+  Serial.println("Initializing sensors...");
+  EnabledSensors::initAll();
+  Serial.printf("All %u sensors initialized successfully!\n", (unsigned)EnabledSensors::count());
+}
+
+void readAllSensors() {
+  EnabledSensors::sampleAll();
+}
+
+void registerSensorJobs(Scheduler& scheduler) {
+  EnabledSensors::registerJobs(scheduler);
+}
+
+bool isEnvironmentDataStale() {
+  #ifdef ENABLE_DHT22
+  return dht22Driver.isStale();
+  #else
+  SensorData data = getSensorDataSnapshot();
+  return !data.dataValid || millis() - data.environmentTimestamp > 2 * ENV_SENSOR_READ_INTERVAL;
+  #endif
+}
+
+SensorData getSensorDataSnapshot() {
+  portENTER_CRITICAL(&sensorDataLock);
+  SensorData data = currentSensorData;
+  portEXIT_CRITICAL(&sensorDataLock);
+  return data;
+}
+
+BeamAnalytics getBeamAnalyticsSnapshot() {
+  portENTER_CRITICAL(&sensorDataLock);
+  BeamAnalytics analytics = beamAnalytics;
+  portEXIT_CRITICAL(&sensorDataLock);
+  return analytics;
+}
+
 // E3JK-RR11 Photoelectric Sensor Functions
 #ifdef ENABLE_E3JK_RR11
+// Apply one beam state change to the shared sensor data
+static void applyBeamState(bool beamBroken, uint32_t edgeMicros) {
+  // Convert the ISR timestamp to the millis() timebase used elsewhere
+  uint32_t changeMs = millis() - (micros() - edgeMicros) / 1000;
+  portENTER_CRITICAL(&sensorDataLock);
+  currentSensorData.beamBroken = beamBroken;
+  currentSensorData.lastStateChangeMicros = edgeMicros;
+  currentSensorData.lastStateChangeTime = changeMs;
+  beamAnalytics.recordTransition(beamBroken, changeMs);
+  portEXIT_CRITICAL(&sensorDataLock);
+
+  // Update LED based on beam status
+  updateBeamStatusLED();
+  publishBeamEvent(beamBroken, currentSensorData.lastStateChangeTime);
+
+  LOGD("E3JK-RR11 - Beam %s at %lu ms", beamBroken ? "BROKEN (LED ON)" : "CLEAR (LED OFF)",
+       currentSensorData.lastStateChangeTime);
+
+  if (beamBroken) {
+    LOGW("Beam broken - object detected!");
+  } else {
+    LOGI("Beam clear - path restored");
+  }
+}
+
+static BeamFilterConfig loadBeamFilterConfig() {
+  BeamFilterConfig config;
+  config.mode = (BeamFilterMode)configStore.getUInt(CONFIG_BEAM_FILTER_MODE);
+  config.lockoutUs = configStore.getUInt(CONFIG_BEAM_LOCKOUT_US);
+  config.integrateUs = configStore.getUInt(CONFIG_BEAM_INTEGRATE_US);
+  config.sampleUs = configStore.getUInt(CONFIG_BEAM_SAMPLE_US);
+  config.majorityN = configStore.getUInt(CONFIG_BEAM_MAJORITY_N);
+  config.majorityM = configStore.getUInt(CONFIG_BEAM_MAJORITY_M);
+  return config;
+}
+
+static bool sameFilterConfig(const BeamFilterConfig& a, const BeamFilterConfig& b) {
+  return a.mode == b.mode && a.lockoutUs == b.lockoutUs && a.integrateUs == b.integrateUs &&
+         a.sampleUs == b.sampleUs && a.majorityN == b.majorityN && a.majorityM == b.majorityM;
+}
+
+// Stage the stored settings if they differ from the last ones requested.
+// Waits while a batch of writes is still uncommitted, so a half-written
+// set of values is never applied.
+static void refreshBeamFilterConfig() {
+  uint32_t generation = configStore.getGeneration();
+  if (generation == filterConfigGeneration || configStore.isDirty()) {
+    return;
+  }
+  filterConfigGeneration = generation;
+  BeamFilterConfig stored = loadBeamFilterConfig();
+  portENTER_CRITICAL(&filterConfigLock);
+  if (!sameFilterConfig(stored, stagedFilterConfig)) {
+    stagedFilterConfig = stored;
+    filterConfigStaged = true;
+  }
+  portEXIT_CRITICAL(&filterConfigLock);
+}
+
 void readE3JKRR11() {
-  bool currentBeamState = (digitalRead(E3JK_RR11_PIN) == E3JK_BEAM_BROKEN);
-  
-  // Update sensor data if state changed
-  if (currentBeamState != currentSensorData.beamBroken) {
-    currentSensorData.beamBroken = currentBeamState;
-    currentSensorData.lastStateChangeTime = millis();
-    
-    // Update LED based on beam status
-    updateBeamStatusLED();
-    
-    if (DEBUG_SENSORS) {
-      Serial.printf("E3JK-RR11 - Beam %s at %lu ms\n", 
-                    currentBeamState ? "BROKEN (LED ON)" : "CLEAR (LED OFF)", 
-                    currentSensorData.lastStateChangeTime);
-    }
+  refreshBeamFilterConfig();
+  portENTER_CRITICAL(&filterConfigLock);
+  bool staged = filterConfigStaged;
+  BeamFilterConfig config = stagedFilterConfig;
+  filterConfigStaged = false;
+  portEXIT_CRITICAL(&filterConfigLock);
+
+  if (staged) {
+    BeamFilterConfig applied = beamFilter.configure(config, currentSensorData.beamBroken, micros());
+    portENTER_CRITICAL(&filterConfigLock);
+    appliedFilterConfig = applied;
+    portEXIT_CRITICAL(&filterConfigLock);
+    LOGI("E3JK-RR11 filter: %s (lockout %lu us, integrate %lu us, %u of %u @ %lu us)",
+         BeamFilter::modeName(applied.mode), (unsigned long)applied.lockoutUs,
+         (unsigned long)applied.integrateUs, applied.majorityN, applied.majorityM,
+         (unsigned long)applied.sampleUs);
+  }
+
+  // Drain every queued edge in the order the ISR saw them
+  BeamEdge edge;
+  while (beamEdgeQueue.pop(edge)) {
+    beamFilter.processEdge(edge.timestampUs, edge.beamBroken);
+  }
+
+  // If edges were dropped the queued sequence is incomplete, so resync with the pin
+  uint32_t overflows = beamEdgeQueue.overflowCount();
+  if (overflows != lastSeenOverflowCount) {
+    lastSeenOverflowCount = overflows;
+    LOGW("E3JK-RR11 edge queue overflow (%lu dropped total)", (unsigned long)overflows);
+    beamFilter.processEdge(micros(), digitalRead(E3JK_RR11_PIN) == E3JK_BEAM_BROKEN);
   }
+
+  // Settle lockout expiry, integrator and majority samples up to now
+  beamFilter.advance(micros());
+}
+
+void setBeamFilterConfig(const BeamFilterConfig& config) {
+  portENTER_CRITICAL(&filterConfigLock);
+  stagedFilterConfig = config;
+  filterConfigStaged = true;
+  portEXIT_CRITICAL(&filterConfigLock);
+}
+
+BeamFilterConfig getBeamFilterConfig() {
+  portENTER_CRITICAL(&filterConfigLock);
+  BeamFilterConfig config = filterConfigStaged ? stagedFilterConfig : appliedFilterConfig;
+  portEXIT_CRITICAL(&filterConfigLock);
+  return config;
+}
+
+BeamFilterStats getBeamFilterStats() {
+  return beamFilter.getStats();
 }
 
 bool isBeamBroken() {
@@ -234,24 +435,33 @@ void updateBeamStatusLED() {
 }
 
 void setupE3JKRR11Interrupt() {
+  // Seed the state from the pin so the first queued edge is a real change
+  bool beamBroken = digitalRead(E3JK_RR11_PIN) == E3JK_BEAM_BROKEN;
+  portENTER_CRITICAL(&sensorDataLock);
+  currentSensorData.beamBroken = beamBroken;
+  currentSensorData.lastStateChangeMicros = micros();
+  portEXIT_CRITICAL(&sensorDataLock);
+  updateBeamStatusLED();
   attachInterrupt(digitalPinToInterrupt(E3JK_RR11_PIN), e3jkInterruptHandler, CHANGE);
 }
 
 void IRAM_ATTR e3jkInterruptHandler() {
-  unsigned long currentTime = millis();
-  
-  // Simple debouncing
-  if (currentTime - lastDebounceTime > E3JK_DEBOUNCE_TIME) {
-    e3jkStateChanged = true;
-    e3jkBeamBroken = (digitalRead(E3JK_RR11_PIN) == E3JK_BEAM_BROKEN);
-    lastDebounceTime = currentTime;
-  }
+  // Timestamp and queue every edge; filtering happens in readE3JKRR11()
+  beamEdgeQueue.push(micros(), digitalRead(E3JK_RR11_PIN) == E3JK_BEAM_BROKEN);
 }
-#else
-void readE3JKRR11() {
-  // E3JK-RR11 disabled
+
+uint32_t getBeamEdgeCount() {
+  return beamEdgeQueue.pushCount();
 }
 
+uint32_t getBeamEdgeOverflowCount() {
+  return beamEdgeQueue.overflowCount();
+}
+
+uint32_t getBeamEdgeQueueHighWater() {
+  return beamEdgeQueue.highWater();
+}
+#else
 bool isBeamBroken() {
   return false;
 }
@@ -264,11 +474,29 @@ void updateBeamStatusLED() {
   // E3JK-RR11 disabled
 }
 
-void setupE3JKRR11Interrupt() {
-  // E3JK-RR11 disabled
+uint32_t getBeamEdgeCount() {
+  return 0;
 }
 
-void IRAM_ATTR e3jkInterruptHandler() {
+uint32_t getBeamEdgeOverflowCount() {
+  return 0;
+}
+
+uint32_t getBeamEdgeQueueHighWater() {
+  return 0;
+}
+
+void setBeamFilterConfig(const BeamFilterConfig& config) {
   // E3JK-RR11 disabled
 }
-#endif
\ No newline at end of file
+
+BeamFilterConfig getBeamFilterConfig() {
+  BeamFilterConfig config = {BEAM_FILTER_LOCKOUT, 0, 0, 0, 0, 0};
+  return config;
+}
+
+BeamFilterStats getBeamFilterStats() {
+  BeamFilterStats stats = {0, 0, 0};
+  return stats;
+}
+#endif
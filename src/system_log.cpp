@@ -0,0 +1,170 @@
+#include "system_log.h"
+#include "mpsc_queue.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <atomic>
+
+static LogRing systemLog;
+static SemaphoreHandle_t systemLogMutex = nullptr;
+static MpscQueue<DeferredLogEntry, LOG_QUEUE_SIZE> deferredLogQueue;
+
+static std::atomic<uint32_t> enqueuedCount{0};
+static std::atomic<uint32_t> droppedCount{0};
+static std::atomic<uint32_t> queueHighWater{0};
+static std::atomic<uint32_t> enqueueCyclesMax{0};
+// 64-bit atomics take a lock on Xtensa, so the total is two 32-bit words
+// with a carry, as in MetricHistogram
+static std::atomic<uint32_t> enqueueCyclesLow{0};
+static std::atomic<uint32_t> enqueueCyclesHigh{0};
+
+// Ring access is shared by the loop, the web server and the log task.
+// Before initSystemLog() there is only the setup() context.
+static void lockLog() {
+  if (systemLogMutex) {
+    xSemaphoreTake(systemLogMutex, portMAX_DELAY);
+  }
+}
+
+static void unlockLog() {
+  if (systemLogMutex) {
+    xSemaphoreGive(systemLogMutex);
+  }
+}
+
+bool enqueueLogEntry(DeferredLogEntry& entry) {
+  uint32_t start = ESP.getCycleCount();
+  entry.timestampUs = esp_timer_get_time();
+  bool queued = deferredLogQueue.push(entry);
+  uint32_t cycles = ESP.getCycleCount() - start;
+
+  if (!queued) {
+    droppedCount.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  enqueuedCount.fetch_add(1, std::memory_order_relaxed);
+  uint32_t low = enqueueCyclesLow.fetch_add(cycles, std::memory_order_relaxed);
+  if (low + cycles < low) {
+    enqueueCyclesHigh.fetch_add(1, std::memory_order_relaxed);  // Carry
+  }
+  uint32_t previous = enqueueCyclesMax.load(std::memory_order_relaxed);
+  while (cycles > previous &&
+         !enqueueCyclesMax.compare_exchange_weak(previous, cycles, std::memory_order_relaxed)) {
+  }
+  uint32_t depth = deferredLogQueue.size();
+  previous = queueHighWater.load(std::memory_order_relaxed);
+  while (depth > previous &&
+         !queueHighWater.compare_exchange_weak(previous, depth, std::memory_order_relaxed)) {
+  }
+  return true;
+}
+
+void addLogEntry(const char* message, LogLevel level) {
+  lockLog();
+  systemLog.add(level, esp_timer_get_time(), message);
+  unlockLog();
+}
+
+void addLogEntryf(LogLevel level, const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  lockLog();
+  systemLog.addFormatted(level, esp_timer_get_time(), format, args);
+  unlockLog();
+  va_end(args);
+}
+
+static bool copyLogRecord(const LogRecord& record, void* context) {
+  *static_cast<LogRecord*>(context) = record;
+  return true;
+}
+
+size_t readLogEntries(uint32_t after, size_t limit, LogVisitor visitor, void* context) {
+  // Copy one record at a time so the visitor runs without the lock held
+  LogRecord record;
+  size_t visited = 0;
+  while (visited < limit) {
+    lockLog();
+    size_t found = systemLog.readAfter(after, 1, copyLogRecord, &record);
+    unlockLog();
+    if (found == 0) {
+      break;
+    }
+    visited++;
+    after = record.sequence;
+    if (!visitor(record, context)) {
+      break;
+    }
+  }
+  return visited;
+}
+
+uint32_t getLogOldestSequence() {
+  lockLog();
+  uint32_t sequence = systemLog.getOldestSequence();
+  unlockLog();
+  return sequence;
+}
+
+uint32_t getLogLastSequence() {
+  lockLog();
+  uint32_t sequence = systemLog.getLastSequence();
+  unlockLog();
+  return sequence;
+}
+
+SystemLogStats getSystemLogStats() {
+  SystemLogStats stats;
+  stats.enqueued = enqueuedCount.load(std::memory_order_relaxed);
+  stats.dropped = droppedCount.load(std::memory_order_relaxed);
+  stats.queueHighWater = queueHighWater.load(std::memory_order_relaxed);
+  stats.enqueueCyclesMax = enqueueCyclesMax.load(std::memory_order_relaxed);
+  // Re-read if a carry landed in between
+  uint32_t high;
+  uint32_t low;
+  do {
+    high = enqueueCyclesHigh.load(std::memory_order_relaxed);
+    low = enqueueCyclesLow.load(std::memory_order_relaxed);
+  } while (high != enqueueCyclesHigh.load(std::memory_order_relaxed));
+  stats.enqueueCyclesTotal = ((uint64_t)high << 32) | low;
+  return stats;
+}
+
+static bool echoLogRecord(const LogRecord& record, void* context) {
+  *static_cast<uint32_t*>(context) = record.sequence;
+  Serial.printf("[%s] %s\n", LogRing::levelName(record.level), record.message);
+  return true;
+}
+
+// Formats deferred entries into the ring, then echoes new ring entries
+// (from either path) to Serial. Runs at the loop task's priority (1, as
+// the other background tasks do) and sleeps between passes, so it shares
+// the CPU with the loop instead of preempting it.
+static void systemLogTask(void*) {
+  uint32_t echoedSequence = 0;
+  DeferredLogEntry entry;
+  char message[LOG_MESSAGE_LENGTH];
+
+  for (;;) {
+    while (deferredLogQueue.pop(entry)) {
+      formatDeferredLog(entry, message, sizeof(message));
+      lockLog();
+      systemLog.add((LogLevel)entry.level, entry.timestampUs, message);
+      unlockLog();
+    }
+
+    readLogEntries(echoedSequence, LOG_RING_CAPACITY, echoLogRecord, &echoedSequence);
+    vTaskDelay(pdMS_TO_TICKS(LOG_FLUSH_INTERVAL_MS));
+  }
+}
+
+void initSystemLog() {
+  if (systemLogMutex) {
+    return;
+  }
+  systemLogMutex = xSemaphoreCreateMutex();
+  xTaskCreate(systemLogTask, "log", 4096, nullptr, tskIDLE_PRIORITY + 1, nullptr);
+}
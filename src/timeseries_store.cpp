@@ -0,0 +1,290 @@
+#include "timeseries_store.h"
+#include <math.h>
+#include <string.h>
+
+#define TS_PAYLOAD_BITS ((uint32_t)(TS_BLOCK_BYTES - sizeof(BlockHeader)) * 8)
+// Worst case for one sample: '1111' + 32-bit delta-of-delta, then per
+// series '11' + 5-bit width + 32 significant bits
+#define TS_MAX_SAMPLE_BITS (4 + 32 + TS_SERIES_COUNT * (2 + 5 + 32))
+
+// MSB-first bit writer/reader over a block payload
+static void writeBits(uint8_t* buffer, uint32_t& bitPos, uint32_t value, uint8_t count) {
+    while (count > 0) {
+        count--;
+        uint8_t bit = (value >> count) & 1;
+        uint8_t& byte = buffer[bitPos >> 3];
+        uint8_t mask = 0x80 >> (bitPos & 7);
+        byte = bit ? (byte | mask) : (byte & ~mask);
+        bitPos++;
+    }
+}
+
+static uint32_t readBits(const uint8_t* buffer, uint32_t& bitPos, uint8_t count) {
+    uint32_t value = 0;
+    while (count > 0) {
+        count--;
+        value = (value << 1) | ((buffer[bitPos >> 3] >> (7 - (bitPos & 7))) & 1);
+        bitPos++;
+    }
+    return value;
+}
+
+// Small steps either way become small unsigned numbers: 0, -1, 1, -2 -> 0, 1, 2, 3
+static inline uint32_t zigzagEncode(int32_t delta) {
+    return ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+}
+
+static inline int32_t zigzagDecode(uint32_t zigzag) {
+    return (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+}
+
+static inline int32_t quantize(float value) {
+    return (int32_t)lroundf(value * TS_VALUE_SCALE);
+}
+
+bool TimeSeriesStore::begin(uint8_t* memory, size_t bytes) {
+    uint32_t count = bytes / TS_BLOCK_BYTES;
+    if (memory == nullptr || count < 2) {
+        return false;
+    }
+
+    blocks = memory;
+    blockCount = count;
+    headBlock = 0;
+    blocksInUse = 0;
+    samplesWritten = 0;
+    blocksEvicted = 0;
+    return true;
+}
+
+TimeSeriesStore::BlockHeader* TimeSeriesStore::header(uint32_t index) const {
+    return reinterpret_cast<BlockHeader*>(blocks + index * TS_BLOCK_BYTES);
+}
+
+uint8_t* TimeSeriesStore::payload(uint32_t index) const {
+    return blocks + index * TS_BLOCK_BYTES + sizeof(BlockHeader);
+}
+
+void TimeSeriesStore::startBlock(uint32_t index, const TimeSeriesSample& sample, const int32_t* quantized) {
+    BlockHeader* block = header(index);
+    block->firstTimestamp = sample.timestamp;
+    block->lastTimestamp = sample.timestamp;
+    block->sampleCount = 1;
+
+    // First sample of a block is stored raw so blocks decode independently
+    uint32_t bitPos = 0;
+    uint8_t* data = payload(index);
+    writeBits(data, bitPos, sample.timestamp, 32);
+    for (int i = 0; i < TS_SERIES_COUNT; i++) {
+        writeBits(data, bitPos, (uint32_t)quantized[i], 32);
+        series[i].previous = quantized[i];
+        series[i].hasWindow = false;
+    }
+    block->bitCount = bitPos;
+
+    previousTimestamp = sample.timestamp;
+    previousDelta = 0;
+}
+
+bool TimeSeriesStore::append(const TimeSeriesSample& sample) {
+    if (!isReady()) {
+        return false;
+    }
+
+    int32_t quantized[TS_SERIES_COUNT];
+    for (int i = 0; i < TS_SERIES_COUNT; i++) {
+        quantized[i] = quantize(sample.values[i]);
+    }
+
+    if (blocksInUse == 0) {
+        headBlock = 0;
+        blocksInUse = 1;
+        startBlock(headBlock, sample, quantized);
+        samplesWritten++;
+        return true;
+    }
+
+    if (sample.timestamp < previousTimestamp) {
+        return false;
+    }
+
+    BlockHeader* block = header(headBlock);
+    if ((uint32_t)block->bitCount + TS_MAX_SAMPLE_BITS > TS_PAYLOAD_BITS) {
+        // Head block full: move on, overwriting the oldest block when needed
+        headBlock = (headBlock + 1) % blockCount;
+        if (blocksInUse < blockCount) {
+            blocksInUse++;
+        } else {
+            blocksEvicted++;
+        }
+        startBlock(headBlock, sample, quantized);
+        samplesWritten++;
+        return true;
+    }
+
+    uint8_t* data = payload(headBlock);
+    uint32_t bitPos = block->bitCount;
+
+    // Timestamp: delta-of-delta with Gorilla's variable-length buckets
+    int32_t delta = (int32_t)(sample.timestamp - previousTimestamp);
+    int32_t dod = delta - previousDelta;
+    if (dod == 0) {
+        writeBits(data, bitPos, 0, 1);
+    } else if (dod >= -63 && dod <= 64) {
+        writeBits(data, bitPos, 0x2, 2);
+        writeBits(data, bitPos, dod + 63, 7);
+    } else if (dod >= -255 && dod <= 256) {
+        writeBits(data, bitPos, 0x6, 3);
+        writeBits(data, bitPos, dod + 255, 9);
+    } else if (dod >= -2047 && dod <= 2048) {
+        writeBits(data, bitPos, 0xE, 4);
+        writeBits(data, bitPos, dod + 2047, 12);
+    } else {
+        writeBits(data, bitPos, 0xF, 4);
+        writeBits(data, bitPos, (uint32_t)dod, 32);
+    }
+    previousDelta = delta;
+    previousTimestamp = sample.timestamp;
+
+    // Values: zigzag delta from the previous value, write only the
+    // significant bits
+    for (int i = 0; i < TS_SERIES_COUNT; i++) {
+        SeriesState& state = series[i];
+        uint32_t zigzag = zigzagEncode((int32_t)((uint32_t)quantized[i] - (uint32_t)state.previous));
+        state.previous = quantized[i];
+
+        if (zigzag == 0) {
+            writeBits(data, bitPos, 0, 1);
+            continue;
+        }
+
+        uint8_t width = 32 - __builtin_clz(zigzag);
+        // Reuse the previous width while that is cheaper than a new
+        // 7-bit header, so one large step does not widen every later one
+        if (state.hasWindow && width <= state.width && state.width <= width + 5) {
+            writeBits(data, bitPos, 0x2, 2);
+            writeBits(data, bitPos, zigzag, state.width);
+        } else {
+            writeBits(data, bitPos, 0x3, 2);
+            writeBits(data, bitPos, width - 1, 5);
+            writeBits(data, bitPos, zigzag, width);
+            state.width = width;
+            state.hasWindow = true;
+        }
+    }
+
+    block->bitCount = bitPos;
+    block->lastTimestamp = sample.timestamp;
+    block->sampleCount++;
+    samplesWritten++;
+    return true;
+}
+
+uint32_t TimeSeriesStore::decodeBlock(uint32_t index, uint32_t from, uint32_t to,
+                                      TimeSeriesVisitor visitor, void* context, bool& stop) const {
+    const BlockHeader* block = header(index);
+    const uint8_t* data = payload(index);
+    uint32_t bitPos = 0;
+    uint32_t visited = 0;
+
+    TimeSeriesSample sample;
+    int32_t values[TS_SERIES_COUNT];
+    uint8_t widths[TS_SERIES_COUNT];
+
+    sample.timestamp = readBits(data, bitPos, 32);
+    for (int i = 0; i < TS_SERIES_COUNT; i++) {
+        values[i] = (int32_t)readBits(data, bitPos, 32);
+        widths[i] = 0;
+    }
+    int32_t delta = 0;
+
+    for (uint16_t n = 0; n < block->sampleCount; n++) {
+        if (n > 0) {
+            int32_t dod;
+            if (readBits(data, bitPos, 1) == 0) {
+                dod = 0;
+            } else if (readBits(data, bitPos, 1) == 0) {
+                dod = (int32_t)readBits(data, bitPos, 7) - 63;
+            } else if (readBits(data, bitPos, 1) == 0) {
+                dod = (int32_t)readBits(data, bitPos, 9) - 255;
+            } else if (readBits(data, bitPos, 1) == 0) {
+                dod = (int32_t)readBits(data, bitPos, 12) - 2047;
+            } else {
+                dod = (int32_t)readBits(data, bitPos, 32);
+            }
+            delta += dod;
+            sample.timestamp += delta;
+
+            for (int i = 0; i < TS_SERIES_COUNT; i++) {
+                if (readBits(data, bitPos, 1) == 0) {
+                    continue;  // Unchanged
+                }
+                if (readBits(data, bitPos, 1) == 1) {
+                    widths[i] = readBits(data, bitPos, 5) + 1;
+                }
+                values[i] = (int32_t)((uint32_t)values[i] + (uint32_t)zigzagDecode(readBits(data, bitPos, widths[i])));
+            }
+        }
+
+        if (sample.timestamp > to) {
+            stop = true;
+            break;
+        }
+        if (sample.timestamp >= from) {
+            for (int i = 0; i < TS_SERIES_COUNT; i++) {
+                sample.values[i] = values[i] / TS_VALUE_SCALE;
+            }
+            visited++;
+            if (!visitor(sample, context)) {
+                stop = true;
+                break;
+            }
+        }
+    }
+    return visited;
+}
+
+uint32_t TimeSeriesStore::query(uint32_t from, uint32_t to, TimeSeriesVisitor visitor, void* context) const {
+    if (!isReady() || blocksInUse == 0 || from > to) {
+        return 0;
+    }
+
+    uint32_t visited = 0;
+    bool stop = false;
+    uint32_t index = (headBlock + blockCount - blocksInUse + 1) % blockCount;
+
+    for (uint32_t i = 0; i < blocksInUse && !stop; i++) {
+        const BlockHeader* block = header(index);
+        if (block->lastTimestamp >= from && block->firstTimestamp <= to) {
+            visited += decodeBlock(index, from, to, visitor, context, stop);
+        } else if (block->firstTimestamp > to) {
+            break;
+        }
+        index = (index + 1) % blockCount;
+    }
+    return visited;
+}
+
+TimeSeriesStats TimeSeriesStore::getStats() const {
+    TimeSeriesStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.blockCount = blockCount;
+    stats.blocksInUse = blocksInUse;
+    stats.samplesWritten = samplesWritten;
+    stats.blocksEvicted = blocksEvicted;
+
+    if (blocksInUse == 0) {
+        return stats;
+    }
+
+    uint32_t index = (headBlock + blockCount - blocksInUse + 1) % blockCount;
+    stats.oldestTimestamp = header(index)->firstTimestamp;
+    stats.newestTimestamp = header(headBlock)->lastTimestamp;
+    for (uint32_t i = 0; i < blocksInUse; i++) {
+        const BlockHeader* block = header(index);
+        stats.sampleCount += block->sampleCount;
+        stats.bytesUsed += sizeof(BlockHeader) + (block->bitCount + 7) / 8;
+        index = (index + 1) % blockCount;
+    }
+    return stats;
+}
@@ -2,26 +2,204 @@
 #include "sensors.h" 
 #include "wifi_manager.h"
 #include "ota_manager.h"
-
-extern SensorData currentSensorData;
+#include "scheduler.h"
+#include "beam_analytics.h"
+#include "environment_history.h"
+#include "history_batches.h"
+#include "web_assets.h"
+#include "event_stream.h"
+#include "metrics.h"
+#include "config_store.h"
 
 #ifdef ENABLE_WIFI
 #include <ArduinoJson.h>
-#include <WebServer.h>
+#include <esp_system.h>
+#include <errno.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
-WebServer server(WEB_SERVER_PORT);
+HttpServer server(WEB_SERVER_PORT);
 bool webServerActive = false;
 
+// HTTP clients and the SSE subscribers are served here, off the sensor
+// loop; release checks have their own task (see ota_manager.h).
+static void webServerTask(void* parameter) {
+    for (;;) {
+        server.poll(WEB_SERVER_POLL_MS);
+        serviceEventStream();
+    }
+}
+
+// All or nothing: every setting is checked before any is changed, then
+// the changes go to NVS in one commit
+static void patchConfig() {
+    JsonDocument doc;
+    if (deserializeJson(doc, server.body()) || !doc.is<JsonObject>()) {
+        server.send(400, "application/json", "{\"error\":\"body must be a JSON object\"}");
+        return;
+    }
+    JsonObject changes = doc.as<JsonObject>();
+    for (JsonPair change : changes) {
+        ConfigKey key = ConfigStore::find(change.key().c_str());
+        JsonVariant value = change.value();
+        bool valid = false;
+        if (key != CONFIG_KEY_COUNT) {
+            switch (ConfigStore::entry(key).type) {
+                case CONFIG_STRING:
+                    valid = value.is<const char*>() && ConfigStore::accepts(key, String(value.as<const char*>()));
+                    break;
+                case CONFIG_BOOL:
+                    valid = value.is<bool>();
+                    break;
+                case CONFIG_UINT:
+                    valid = value.is<uint32_t>() && ConfigStore::accepts(key, value.as<uint32_t>());
+                    break;
+            }
+        }
+        if (!valid) {
+            JsonDocument error;
+            error["error"] = key == CONFIG_KEY_COUNT ? "unknown setting" : "invalid value";
+            error["setting"] = change.key().c_str();
+            String response;
+            serializeJson(error, response);
+            server.send(400, "application/json", response);
+            return;
+        }
+    }
+    
+    for (JsonPair change : changes) {
+        ConfigKey key = ConfigStore::find(change.key().c_str());
+        JsonVariant value = change.value();
+        switch (ConfigStore::entry(key).type) {
+            case CONFIG_STRING: configStore.set(key, String(value.as<const char*>())); break;
+            case CONFIG_BOOL: configStore.set(key, (uint32_t)value.as<bool>()); break;
+            case CONFIG_UINT: configStore.set(key, value.as<uint32_t>()); break;
+        }
+    }
+    uint32_t written = configStore.commit();
+    addLogEntryf(LOG_INFO, "Config: %u settings submitted, %lu written to NVS",
+                 (unsigned)changes.size(), (unsigned long)written);
+    server.send(200, "application/json", getConfigJSON());
+}
+
+// Parse a decimal query argument into [min, max]. Signs, junk and values
+// too large for 32 bits are refused rather than wrapped.
+static bool parseUIntArg(const char* name, uint32_t min, uint32_t max, uint32_t& value) {
+    String text = server.arg(name);
+    if (text[0] < '0' || text[0] > '9') {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long parsed = strtoull(text.c_str(), &end, 10);
+    if (errno != 0 || *end != '\0' || parsed < min || parsed > max) {
+        return false;
+    }
+    value = (uint32_t)parsed;
+    return true;
+}
+
+static void sendArgRangeError(const char* name, uint32_t min, uint32_t max) {
+    JsonDocument error;
+    error["error"] = "parameter out of range";
+    error["parameter"] = name;
+    error["min"] = min;
+    error["max"] = max;
+    String response;
+    serializeJson(error, response);
+    server.send(400, "application/json", response);
+}
+
+// Every parameter is checked before the filter is touched
+static void postBeamFilter() {
+    BeamFilterConfig config = getBeamFilterConfig();
+    if (server.hasArg("mode") && !BeamFilter::parseMode(server.arg("mode").c_str(), config.mode)) {
+        server.send(400, "application/json", "{\"error\":\"mode must be lockout, integrator or majority\"}");
+        return;
+    }
+
+    struct {
+        const char* name;
+        uint32_t min;
+        uint32_t max;
+        uint32_t* value;
+    } timeArgs[] = {
+        {"lockout_us", 0, BEAM_FILTER_MAX_LOCKOUT_US, &config.lockoutUs},
+        {"integrate_us", 1, BEAM_FILTER_MAX_INTEGRATE_US, &config.integrateUs},
+        {"sample_us", 1, BEAM_FILTER_MAX_SAMPLE_US, &config.sampleUs},
+    };
+    for (auto& arg : timeArgs) {
+        if (server.hasArg(arg.name) && !parseUIntArg(arg.name, arg.min, arg.max, *arg.value)) {
+            sendArgRangeError(arg.name, arg.min, arg.max);
+            return;
+        }
+    }
+
+    uint32_t window = config.majorityM;
+    if (server.hasArg("m") && !parseUIntArg("m", 1, BEAM_FILTER_MAX_WINDOW, window)) {
+        sendArgRangeError("m", 1, BEAM_FILTER_MAX_WINDOW);
+        return;
+    }
+    // N must be a strict majority of M (see BeamFilter::configure)
+    uint32_t agreeing = config.majorityN;
+    uint32_t minimumN = window / 2 + 1;
+    if (server.hasArg("n") && !parseUIntArg("n", minimumN, window, agreeing)) {
+        sendArgRangeError("n", minimumN, window);
+        return;
+    }
+    if (config.mode == BEAM_FILTER_MAJORITY && (agreeing < minimumN || agreeing > window)) {
+        sendArgRangeError("n", minimumN, window);
+        return;
+    }
+    config.majorityM = window;
+    config.majorityN = agreeing;
+
+    // Staged first: the drain only reloads the store once the writes are
+    // committed, and then finds the same settings already staged
+    setBeamFilterConfig(config);
+    configStore.set(CONFIG_BEAM_FILTER_MODE, (uint32_t)config.mode);
+    configStore.set(CONFIG_BEAM_LOCKOUT_US, config.lockoutUs);
+    configStore.set(CONFIG_BEAM_INTEGRATE_US, config.integrateUs);
+    configStore.set(CONFIG_BEAM_SAMPLE_US, config.sampleUs);
+    configStore.set(CONFIG_BEAM_MAJORITY_N, (uint32_t)config.majorityN);
+    configStore.set(CONFIG_BEAM_MAJORITY_M, (uint32_t)config.majorityM);
+    configStore.commit();
+    addLogEntryf(LOG_INFO, "Beam filter set to %s", BeamFilter::modeName(config.mode));
+    server.send(200, "application/json", getBeamFilterJSON());
+}
+
+// Optional from/to window in seconds of uptime for the history routes;
+// sends the 400 itself when either is malformed or the window is reversed
+static bool parseHistoryWindow(uint32_t& from, uint32_t& to) {
+    from = 0;
+    to = environmentHistoryTime();
+    if (server.hasArg("from") && !parseUIntArg("from", 0, UINT32_MAX, from)) {
+        sendArgRangeError("from", 0, UINT32_MAX);
+        return false;
+    }
+    if (server.hasArg("to") && !parseUIntArg("to", 0, UINT32_MAX, to)) {
+        sendArgRangeError("to", 0, UINT32_MAX);
+        return false;
+    }
+    if (from > to) {
+        server.send(400, "application/json", "{\"error\":\"from must not be after to\"}");
+        return false;
+    }
+    return true;
+}
+
 void initWebServer() {
     if (!isWiFiConnected()) {
         Serial.println("Cannot start web server - WiFi not connected");
         return;
     }
 
-        // Main page
-    server.on("/", HTTP_GET, []() {
-        server.send(200, "text/html", getMainPageHTML());
-    });
+    // Needed to answer conditional requests for the dashboard
+    static const char* collectedHeaders[] = {"If-None-Match"};
+    server.collectHeaders(collectedHeaders, 1);
+
+    // Main page: static gzip blob from flash, live values come from /api/status
+    server.on("/", HTTP_GET, sendDashboard);
 
     // Refresh endpoint - redirects to main page for live data
     server.on("/refresh", HTTP_GET, []() {
@@ -29,10 +207,92 @@ void initWebServer() {
         server.send(302, "text/plain", "Redirecting...");
     });
 
-    // API endpoint for status JSON
-    server.on("/api/status", HTTP_GET, []() {
-        server.send(200, "application/json", getStatusJSON());
+    // Live push channel (Server-Sent Events) for beam, environment and OTA changes
+    server.on("/api/events", HTTP_GET, acceptEventStreamClient);
+
+    // API endpoint for status JSON; cached, supports If-None-Match
+    server.on("/api/status", HTTP_GET, sendStatusSnapshot);
+    server.on("/api/system", HTTP_GET, sendSystemStatus);
+
+    // Beam dwell histogram, pass classes and hourly counts
+    server.on("/api/beam/stats", HTTP_GET, []() {
+        server.send(200, "application/json", getBeamStatsJSON());
+    });
+
+    // Beam glitch filter configuration and statistics
+    server.on("/api/beam/filter", HTTP_GET, []() {
+        server.send(200, "application/json", getBeamFilterJSON());
+    });
+
+    // Update filter parameters, e.g. POST /api/beam/filter?mode=majority&n=3&m=5
+    server.on("/api/beam/filter", HTTP_POST, postBeamFilter);
+
+    // Temperature/humidity history, e.g. GET /api/history?from=3600&to=7200
+    // (seconds of uptime, both optional)
+    server.on("/api/history", HTTP_GET, []() {
+        uint32_t from, to;
+        if (!parseHistoryWindow(from, to)) {
+            return;
+        }
+        streamHistoryJSON(from, to);
+    });
+
+    // Min/max/mean rollups, e.g. GET /api/history/rollup?from=0&points=200
+    // The coarsest resolution giving at least 'points' buckets is used
+    // unless resolution=minute|hour|day is given
+    server.on("/api/history/rollup", HTTP_GET, []() {
+        uint32_t from, to;
+        if (!parseHistoryWindow(from, to)) {
+            return;
+        }
+        // No resolution holds more buckets than the minute ring
+        uint32_t points = 200;
+        if (server.hasArg("points") && !parseUIntArg("points", 1, ROLLUP_MINUTE_SLOTS, points)) {
+            sendArgRangeError("points", 1, ROLLUP_MINUTE_SLOTS);
+            return;
+        }
+        RollupResolution resolution = selectEnvironmentRollupResolution(from, to, points);
+        if (server.hasArg("resolution") &&
+            !RollupEngine::parseResolution(server.arg("resolution").c_str(), resolution)) {
+            server.send(400, "application/json", "{\"error\":\"resolution must be minute, hour or day\"}");
+            return;
+        }
+        if (!environmentRollups.isReady()) {
+            server.send(503, "application/json", "{\"error\":\"rollups unavailable\"}");
+            return;
+        }
+        streamRollupJSON(resolution, from, to);
+    });
+
+    // Event log, incrementally: GET /api/logs?after=<last seq seen>&limit=50
+    server.on("/api/logs", HTTP_GET, []() {
+        uint32_t after = server.hasArg("after") ? strtoul(server.arg("after").c_str(), nullptr, 10) : 0;
+        // More than the ring holds is the same as all of it
+        uint32_t limit = LOG_RING_CAPACITY;
+        if (server.hasArg("limit") && !parseUIntArg("limit", 1, UINT32_MAX, limit)) {
+            sendArgRangeError("limit", 1, UINT32_MAX);
+            return;
+        }
+        if (limit > LOG_RING_CAPACITY) {
+            limit = LOG_RING_CAPACITY;
+        }
+        server.send(200, "application/json", getLogsJSON(after, limit));
+    });
+
+    // Prometheus scrape target
+    server.on("/metrics", HTTP_GET, sendMetrics);
+
+    // Scheduler job timing statistics
+    server.on("/api/scheduler", HTTP_GET, []() {
+        server.send(200, "application/json", getSchedulerJSON());
+    });
+
+    // Runtime settings (see config_store.h), e.g.
+    // PATCH /api/config {"ota.check_interval_ms": 300000}
+    server.on("/api/config", HTTP_GET, []() {
+        server.send(200, "application/json", getConfigJSON());
     });
+    server.on("/api/config", HTTP_PATCH, patchConfig);
 
     // OTA endpoints
     server.on("/api/ota/status", HTTP_GET, []() {
@@ -42,36 +302,34 @@ void initWebServer() {
     server.on("/api/ota/check", HTTP_POST, []() {
         Serial.println("=== MANUAL OTA CHECK REQUEST ===");
         otaManager.triggerUpdateCheck();
-        delay(100); // Give it a moment to start checking
         server.send(200, "application/json", "{\"status\":\"checking\",\"message\":\"Update check triggered\"}");
     });
 
+    // Starts the install on its own task and returns at once; follow
+    // progress at /api/ota/status or through "ota" events
     server.on("/api/ota/install", HTTP_POST, []() {
-        Serial.println("=== OTA INSTALL REQUEST RECEIVED ===");
-        
-        // Send immediate response
-        server.send(200, "application/json", "{\"status\":\"installing\",\"message\":\"Update started, device will restart\"}");
-        
-        // Start OTA update after response is sent
-        delay(100);  // Brief delay to ensure response is sent
-        Serial.println("=== STARTING OTA UPDATE ===");
-        otaManager.installLatestRelease();
+        if (!otaManager.installLatestRelease()) {
+            server.send(409, "application/json", "{\"status\":\"error\",\"message\":\"No update available or update already running\"}");
+            return;
+        }
+        server.send(202, "application/json", "{\"status\":\"installing\",\"message\":\"Update started, device will restart\"}");
+        publishOTAEvent();
     });
 
-    server.begin();
+    initEventStream();
+    if (!server.begin()) {
+        Serial.println("Web server failed to start");
+        return;
+    }
     webServerActive = true;
+    xTaskCreatePinnedToCore(webServerTask, "http", WEB_SERVER_TASK_STACK, nullptr,
+                            tskIDLE_PRIORITY + 1, nullptr, WEB_SERVER_TASK_CORE);
     Serial.println("Web server started successfully");
     Serial.print("Access dashboard at: http://");
     Serial.print(WiFi.localIP());
     Serial.println("/");
 }
 
-void handleWebServer() {
-    if (webServerActive && isWiFiConnected()) {
-        server.handleClient();
-    }
-}
-
 void stopWebServer() {
     if (webServerActive) {
         server.stop();
@@ -84,42 +342,102 @@ bool isWebServerActive() {
     return webServerActive;
 }
 
-// Simple log function stub (lightweight version)
-void addLogEntry(String message, String level) {
-    // In lightweight version, just print to serial
-    Serial.print("[");
-    Serial.print(level);
-    Serial.print("] ");
-    Serial.println(message);
+// /api/status is polled many times per second (Home Assistant, wall
+// tablets), so the document is only rebuilt when a field in it changes.
+// Beam, environment and link state are compared on every request; the
+// LED, IP and counters are resampled at most every
+// STATUS_SAMPLE_INTERVAL_MS. The serialized document is kept in a fixed
+// buffer and its version is the ETag, so a matching If-None-Match is
+// answered with 304 without any JSON work. Values that move on every
+// poll (uptime, heap, RSSI, HTTP counters) would change the ETag every
+// time, so they are served uncached by /api/system instead.
+// Laid out without padding so snapshots compare with memcmp()
+struct StatusFields {
+    // Compared on every request
+    float temperature;
+    float humidity;
+    bool beamBroken;
+    bool environmentValid;
+    bool wifiConnected;
+    // Resampled every STATUS_SAMPLE_INTERVAL_MS
+    bool ledOn;
+    bool environmentStale;
+    uint8_t eventClients;
+    uint8_t unused[2];              // Always zero
+    uint32_t ip;
+    uint32_t beamEdges;
+    uint32_t beamQueueOverflows;
+    uint32_t beamQueueHighWater;
+    uint32_t eventEvicted;
+    uint32_t eventRejected;
+};
+
+static StatusFields statusFields;               // What the snapshot was built from
+static char statusSnapshot[STATUS_SNAPSHOT_BYTES];
+static char statusETag[24];
+static uint32_t statusVersion = 0;
+static uint32_t statusBootId = 0;               // Keeps ETags from one boot out of the next
+static uint32_t statusSampledMs = 0;
+
+static void sampleStatusFields(StatusFields& fields, bool resample) {
+    SensorData data = getSensorDataSnapshot();
+    fields.beamBroken = data.beamBroken;
+    fields.environmentValid = data.dataValid;
+    fields.temperature = data.temperature;
+    fields.humidity = data.humidity;
+    fields.wifiConnected = WiFi.isConnected();
+    if (!resample) {
+        return;
+    }
+    
+    fields.ip = (uint32_t)WiFi.localIP();
+    fields.ledOn = digitalRead(LED_INDICATOR_PIN);
+    fields.environmentStale = isEnvironmentDataStale();
+    fields.beamEdges = getBeamEdgeCount();
+    fields.beamQueueOverflows = getBeamEdgeOverflowCount();
+    fields.beamQueueHighWater = getBeamEdgeQueueHighWater();
+    
+    EventStreamStats events = getEventStreamStats();
+    fields.eventClients = events.clients;
+    fields.eventEvicted = events.evicted;
+    fields.eventRejected = events.rejected;
 }
 
-String getStatusJSON() {
+// False, leaving the previous snapshot as it was, if the document does
+// not fit: a cut document is invalid JSON and must never be served
+static bool buildStatusSnapshot(const StatusFields& fields, uint32_t version) {
     JsonDocument doc;
     
     // Basic device info
     doc["device"]["name"] = "ESP32 Garage Door Sensor";
     doc["device"]["version"] = FIRMWARE_VERSION;
-    doc["device"]["uptime"] = millis();
-    doc["device"]["free_heap"] = ESP.getFreeHeap();
+    doc["device"]["status_version"] = version;
     
     // WiFi status
-    doc["wifi"]["connected"] = WiFi.isConnected();
-    doc["wifi"]["ip"] = WiFi.localIP().toString();
-    doc["wifi"]["rssi"] = WiFi.RSSI();
+    doc["wifi"]["connected"] = fields.wifiConnected;
+    doc["wifi"]["ip"] = IPAddress(fields.ip).toString();
     
     // Sensor status - simple and clear
-    doc["sensors"]["beam"]["status"] = currentSensorData.beamBroken ? "BLOCKED" : "CLEAR";
+    doc["sensors"]["beam"]["status"] = fields.beamBroken ? "BLOCKED" : "CLEAR";
     doc["sensors"]["beam"]["pin"] = E3JK_RR11_PIN;
-    doc["sensors"]["led"]["status"] = digitalRead(LED_INDICATOR_PIN) ? "ON" : "OFF";
+    doc["sensors"]["beam"]["edges"] = fields.beamEdges;
+    doc["sensors"]["beam"]["queue_overflows"] = fields.beamQueueOverflows;
+    doc["sensors"]["beam"]["queue_high_water"] = fields.beamQueueHighWater;
+    doc["sensors"]["led"]["status"] = fields.ledOn ? "ON" : "OFF";
     doc["sensors"]["led"]["pin"] = LED_INDICATOR_PIN;
     
+    doc["events"]["clients"] = fields.eventClients;
+    doc["events"]["evicted"] = fields.eventEvicted;
+    doc["events"]["rejected"] = fields.eventRejected;
+    
     // DHT22 environmental data
     #ifdef ENABLE_DHT22
-    if (currentSensorData.dataValid) {
-        doc["sensors"]["temperature"]["value"] = currentSensorData.temperature;
+    if (fields.environmentValid) {
+        doc["sensors"]["temperature"]["value"] = fields.temperature;
         doc["sensors"]["temperature"]["unit"] = "°C";
-        doc["sensors"]["humidity"]["value"] = currentSensorData.humidity;
+        doc["sensors"]["humidity"]["value"] = fields.humidity;
         doc["sensors"]["humidity"]["unit"] = "%";
+        doc["sensors"]["environment"]["stale"] = fields.environmentStale;
     } else {
         doc["sensors"]["temperature"]["value"] = "N/A";
         doc["sensors"]["temperature"]["unit"] = "°C";
@@ -128,142 +446,540 @@ String getStatusJSON() {
     }
     #endif
     
-    String jsonString;
-    serializeJson(doc, jsonString);
-    return jsonString;
+    size_t length = measureJson(doc);
+    if (length >= sizeof(statusSnapshot)) {
+        LOGE("Status document of %u bytes exceeds STATUS_SNAPSHOT_BYTES (%u)",
+             (unsigned)length, (unsigned)sizeof(statusSnapshot));
+        return false;
+    }
+    serializeJson(doc, statusSnapshot, sizeof(statusSnapshot));
+    return true;
+}
+
+void sendStatusSnapshot() {
+    uint32_t now = millis();
+    bool resample = statusVersion == 0 || now - statusSampledMs >= STATUS_SAMPLE_INTERVAL_MS;
+    
+    StatusFields fields = statusFields;
+    sampleStatusFields(fields, resample);
+    if (resample) {
+        statusSampledMs = now;
+    }
+    
+    if (statusVersion == 0 || memcmp(&fields, &statusFields, sizeof(fields)) != 0) {
+        // Nothing is cached or tagged on failure, so the next request
+        // tries again instead of revalidating against a broken version
+        if (!buildStatusSnapshot(fields, statusVersion + 1)) {
+            server.send(500, "application/json", "{\"error\":\"status document too large\"}");
+            return;
+        }
+        if (statusVersion == 0) {
+            statusBootId = esp_random();
+        }
+        statusVersion++;
+        statusFields = fields;
+        snprintf(statusETag, sizeof(statusETag), "\"%08lx-%lu\"",
+                 (unsigned long)statusBootId, (unsigned long)statusVersion);
+    }
+    
+    server.sendHeader("ETag", statusETag);
+    server.sendHeader("Cache-Control", "no-cache");
+    if (server.header("If-None-Match") == statusETag) {
+        server.send(304);
+        return;
+    }
+    server.send(200, "application/json", statusSnapshot);
+}
+
+// The fast-moving counterpart of /api/status, built on every request and
+// never cached
+void sendSystemStatus() {
+    JsonDocument doc;
+    uint32_t now = millis();
+    
+    doc["uptime"] = now;
+    doc["free_heap"] = ESP.getFreeHeap();
+    doc["min_free_heap"] = ESP.getMinFreeHeap();
+    doc["rssi"] = WiFi.RSSI();
+    #ifdef ENABLE_DHT22
+    SensorData data = getSensorDataSnapshot();
+    if (data.dataValid) {
+        doc["environment_age_ms"] = now - data.environmentTimestamp;
+    }
+    #endif
+    
+    HttpServerStats http = server.getStats();
+    doc["http"]["open"] = http.open;
+    doc["http"]["accepted"] = http.accepted;
+    doc["http"]["requests"] = http.requests;
+    doc["http"]["reused"] = http.reused;
+    doc["http"]["timeouts"] = http.timeouts;
+    doc["http"]["rejected"] = http.rejected;
+    doc["http"]["stalled"] = http.stalled;
+    
+    String response;
+    serializeJson(doc, response);
+    server.sendHeader("Cache-Control", "no-store");
+    server.send(200, "application/json", response);
 }
 
 String getOTAStatusJSON() {
     JsonDocument doc;
+    OTAProgress progress = otaManager.getProgress();
     
     doc["current_version"] = FIRMWARE_VERSION;
     doc["latest_version"] = otaManager.getLatestVersion();
     doc["update_available"] = otaManager.isUpdateAvailable();
     doc["last_check"] = "now";
+    doc["phase"] = OTAManager::statusName(progress.phase);
+    doc["message"] = otaManager.getStatusMessage();
+    
+    OTACheckStats checks = otaManager.getCheckStats();
+    doc["checks"]["requests"] = checks.requests;
+    doc["checks"]["not_modified"] = checks.notModified;
+    doc["checks"]["rate_limited"] = checks.rateLimited;
+    doc["checks"]["failures"] = checks.failures;
+    doc["checks"]["next_check_s"] = checks.nextCheckMs / 1000;
+    
+    // Download/flash progress of the current or last install
+    if (progress.totalBytes > 0) {
+        uint32_t bytesPerSecond = progress.elapsedMs
+            ? (uint32_t)((uint64_t)progress.bytesWritten * 1000 / progress.elapsedMs) : 0;
+        doc["progress"]["bytes"] = progress.bytesWritten;
+        doc["progress"]["total"] = progress.totalBytes;
+        doc["progress"]["image_bytes"] = progress.imageBytes;
+        doc["progress"]["percent"] = (uint32_t)((uint64_t)progress.bytesWritten * 100 / progress.totalBytes);
+        doc["progress"]["elapsed_ms"] = progress.elapsedMs;
+        doc["progress"]["bytes_per_s"] = bytesPerSecond;
+        if (bytesPerSecond > 0 && progress.phase == OTA_UPDATE_INSTALLING) {
+            doc["progress"]["eta_s"] = (progress.totalBytes - progress.bytesWritten) / bytesPerSecond;
+        }
+        
+        // Where the time went: the download task waits for free buffers
+        // when flash is the bottleneck, the flash task waits for data when
+        // the network is
+        const OTAPipelineStats& pipeline = progress.pipeline;
+        doc["progress"]["pipeline"]["network_stall_ms"] = pipeline.networkStallMs;
+        doc["progress"]["pipeline"]["flash_busy_ms"] = pipeline.flashBusyMs;
+        doc["progress"]["pipeline"]["flash_stall_ms"] = pipeline.flashStallMs;
+        doc["progress"]["pipeline"]["flash_bytes_per_s"] = pipeline.flashBusyMs
+            ? (uint32_t)((uint64_t)pipeline.bytes * 1000 / pipeline.flashBusyMs) : 0;
+        doc["progress"]["pipeline"]["erased_ahead"] = pipeline.erasedAhead;
+    }
     
     String jsonString;
     serializeJson(doc, jsonString);
     return jsonString;
 }
 
-String getMainPageHTML() {
-    // Get current sensor data to embed in HTML
-    String beamStatus = currentSensorData.beamBroken ? "BLOCKED" : "CLEAR";
-    String beamClass = currentSensorData.beamBroken ? "blocked" : "clear";
-    String ledStatus = digitalRead(LED_INDICATOR_PIN) ? "ON" : "OFF";
-    String ledClass = digitalRead(LED_INDICATOR_PIN) ? "on" : "";
-    String uptime = String(millis() / 1000) + "s";
-    String memory = String(ESP.getFreeHeap() / 1024) + " KB";
-    // Get latest version info for display
-    #ifdef ENABLE_WIFI
-    String latestVersion = otaManager.getLatestVersion();
-    bool updateAvailable = otaManager.isUpdateAvailable();
-    String updateStatus = updateAvailable ? "Update available!" : "Up to date";
-    String updateClass = updateAvailable ? "update-available" : "update-current";
-    #else
-    String latestVersion = "Unknown";
-    bool updateAvailable = false;
-    String updateStatus = "WiFi disabled";
-    String updateClass = "";
-    #endif
+String getConfigJSON() {
+    JsonDocument doc;
+    for (int i = 0; i < CONFIG_KEY_COUNT; i++) {
+        ConfigKey key = (ConfigKey)i;
+        const ConfigEntry& entry = ConfigStore::entry(key);
+        JsonObject setting = doc["settings"][entry.name].to<JsonObject>();
+        switch (entry.type) {
+            case CONFIG_STRING:
+                if (entry.secret) {
+                    setting["set"] = configStore.getString(key).length() > 0;
+                } else {
+                    setting["value"] = configStore.getString(key);
+                    setting["default"] = entry.defaultString;
+                }
+                setting["max_length"] = entry.max;
+                break;
+            case CONFIG_BOOL:
+                setting["value"] = configStore.getBool(key);
+                setting["default"] = entry.defaultValue != 0;
+                break;
+            case CONFIG_UINT:
+                setting["value"] = configStore.getUInt(key);
+                setting["default"] = entry.defaultValue;
+                setting["min"] = entry.min;
+                setting["max"] = entry.max;
+                break;
+        }
+    }
     
-    // DHT22 sensor data
-    #ifdef ENABLE_DHT22
-    String temperature = currentSensorData.dataValid ? String(currentSensorData.temperature, 1) + "°C" : "N/A";
-    String humidity = currentSensorData.dataValid ? String(currentSensorData.humidity, 1) + "%" : "N/A";
-    String tempClass = currentSensorData.dataValid ? "temp-normal" : "";
-    String humidityClass = currentSensorData.dataValid ? "humidity-normal" : "";
-    #else
-    String temperature = "Disabled";
-    String humidity = "Disabled";
-    String tempClass = "";
-    String humidityClass = "";
-    #endif
+    // Flash wear: NVS writes against submitted values
+    ConfigStoreStats stats = configStore.getStats();
+    doc["stats"]["set_requests"] = stats.setRequests;
+    doc["stats"]["changes"] = stats.changes;
+    doc["stats"]["commits"] = stats.commits;
+    doc["stats"]["nvs_writes"] = stats.nvsWrites;
+    doc["stats"]["nvs_skipped"] = stats.nvsSkipped;
+    
+    String jsonString;
+    serializeJson(doc, jsonString);
+    return jsonString;
+}
+
+String getBeamFilterJSON() {
+    JsonDocument doc;
+    BeamFilterConfig config = getBeamFilterConfig();
+    BeamFilterStats stats = getBeamFilterStats();
+    
+    doc["mode"] = BeamFilter::modeName(config.mode);
+    doc["lockout_us"] = config.lockoutUs;
+    doc["integrate_us"] = config.integrateUs;
+    doc["sample_us"] = config.sampleUs;
+    doc["n"] = config.majorityN;
+    doc["m"] = config.majorityM;
+    doc["stats"]["raw_edges"] = stats.rawEdges;
+    doc["stats"]["accepted_changes"] = stats.acceptedChanges;
+    doc["stats"]["rejected_glitches"] = stats.rejectedGlitches;
+    
+    String jsonString;
+    serializeJson(doc, jsonString);
+    return jsonString;
+}
+
+String getBeamStatsJSON() {
+    JsonDocument doc;
+    BeamAnalytics analytics = getBeamAnalyticsSnapshot();
+    uint32_t now = millis();
+    
+    doc["passes"] = analytics.getPassCount();
+    doc["total_dwell_ms"] = analytics.getTotalDwellMs();
+    doc["longest"]["dwell_ms"] = analytics.getLongestDwellMs();
+    doc["longest"]["ended_ms"] = analytics.getLongestDwellEndMs();
+    doc["obstructed"] = analytics.isObstructed();
+    if (analytics.isObstructed()) {
+        doc["obstructed_for_ms"] = now - analytics.getObstructionStartMs();
+    }
+    
+    for (int i = 0; i < BEAM_PASS_CLASS_COUNT; i++) {
+        BeamPassClass passClass = (BeamPassClass)i;
+        doc["classes"][BeamAnalytics::className(passClass)] = analytics.getClassCount(passClass);
+    }
+    
+    // Histogram buckets as [upper bound ms (0 = open-ended), count]
+    JsonArray histogram = doc["dwell_histogram"].to<JsonArray>();
+    for (int i = 0; i < BEAM_DWELL_BUCKETS; i++) {
+        JsonArray bucket = histogram.add<JsonArray>();
+        bucket.add(BeamAnalytics::dwellBucketUpperMs(i));
+        bucket.add(analytics.getDwellBucket(i));
+    }
+    
+    // Passes per hour of uptime, current hour first
+    JsonArray hourly = doc["hourly"].to<JsonArray>();
+    for (int i = 0; i < BEAM_HOURLY_SLOTS; i++) {
+        hourly.add(analytics.getHourlyCount(now, i));
+    }
+    
+    String jsonString;
+    serializeJson(doc, jsonString);
+    return jsonString;
+}
+
+// History responses are streamed (HttpServer::sendStream()): each fill
+// step decodes and formats entries until one chunk has gone out, so a
+// response never has to fit in RAM as a whole and is only produced as
+// fast as the client reads it. Entries are copied out of the store in
+// batches under the history lock and formatted after it is released, so a
+// slow client never holds up the sensor loop.
+#define HISTORY_CHUNK_BYTES 1024
+
+struct HistoryStream {
+    char buffer[HISTORY_CHUNK_BYTES];
+    size_t length;
+    bool first;
+    uint32_t chunks;                // Sent so far
+};
+
+static void flushHistoryStream(HistoryStream& stream) {
+    if (stream.length > 0) {
+        server.sendContent(stream.buffer, stream.length);
+        stream.length = 0;
+        stream.chunks++;
+    }
+}
+
+static void appendHistoryEntry(HistoryStream& stream, const char* entry, size_t length) {
+    if (!stream.first) {
+        if (stream.length + 1 > sizeof(stream.buffer)) {
+            flushHistoryStream(stream);
+        }
+        stream.buffer[stream.length++] = ',';
+    }
+    if (stream.length + length > sizeof(stream.buffer)) {
+        flushHistoryStream(stream);
+    }
+    memcpy(stream.buffer + stream.length, entry, length);
+    stream.length += length;
+    stream.first = false;
+}
+
+static void appendHistoryItem(const TimeSeriesSample& sample, HistoryStream& stream) {
+    char entry[48];
+    int length = snprintf(entry, sizeof(entry), "[%u,%.1f,%.1f]",
+                          (unsigned)sample.timestamp,
+                          sample.values[HISTORY_SERIES_TEMPERATURE],
+                          sample.values[HISTORY_SERIES_HUMIDITY]);
+    appendHistoryEntry(stream, entry, length);
+}
+
+// One bucket: [start, [count, min, max, mean] per series, null when empty]
+static void appendHistoryItem(const RollupBucket& bucket, HistoryStream& stream) {
+    char entry[32 + ROLLUP_SERIES_COUNT * 48];
+    int length = snprintf(entry, sizeof(entry), "[%u", (unsigned)bucket.start);
+    for (int i = 0; i < ROLLUP_SERIES_COUNT; i++) {
+        const RollupAggregate& aggregate = bucket.series[i];
+        if (aggregate.count == 0) {
+            length += snprintf(entry + length, sizeof(entry) - length, ",null");
+        } else {
+            length += snprintf(entry + length, sizeof(entry) - length, ",[%u,%.2f,%.2f,%.2f]",
+                               (unsigned)aggregate.count, aggregate.min, aggregate.max, aggregate.mean());
+        }
+    }
+    length += snprintf(entry + length, sizeof(entry) - length, "]");
+    appendHistoryEntry(stream, entry, length);
+}
+
+struct SampleQuery {
+    uint32_t to;
+    void operator()(uint32_t start, TimeSeriesVisitor visitor, void* batch) const {
+        queryEnvironmentHistory(start, to, visitor, batch);
+    }
+};
+
+struct RollupQuery {
+    RollupResolution resolution;
+    uint32_t to;
+    void operator()(uint32_t start, RollupVisitor visitor, void* batch) const {
+        queryEnvironmentRollups(resolution, start, to, visitor, batch);
+    }
+};
+
+template <typename Item, typename Query>
+struct HistoryResponse {
+    HistoryStream stream;
+    HistoryCursor<Item> cursor;
+    Query query;
+};
+
+// Fill step: entries until a chunk has gone out, then the document end
+// after the last one
+template <typename Item, typename Query>
+static bool fillHistoryResponse(void* context) {
+    HistoryResponse<Item, Query>& response = *static_cast<HistoryResponse<Item, Query>*>(context);
+    HistoryStream& stream = response.stream;
+    uint32_t chunks = stream.chunks;
+    while (stream.chunks == chunks) {
+        const Item* item = nextHistoryItem(response.cursor, response.query);
+        if (item == nullptr) {
+            flushHistoryStream(stream);
+            server.sendContent("]}");
+            server.sendContent("");  // Terminating chunk
+            return false;
+        }
+        appendHistoryItem(*item, stream);
+    }
+    return true;
+}
+
+template <typename Item, typename Query>
+static void releaseHistoryResponse(void* context) {
+    delete static_cast<HistoryResponse<Item, Query>*>(context);
+}
+
+// Start a chunked JSON response with 'header'; the entries follow as the
+// client reads. 'step' is the spacing of entry times (see history_batches.h).
+template <typename Item, typename Query>
+static void streamHistoryResponse(const char* header, uint32_t from, uint32_t step, const Query& query) {
+    HistoryResponse<Item, Query>* response = new HistoryResponse<Item, Query>();
+    response->stream.length = 0;
+    response->stream.first = true;
+    response->stream.chunks = 0;
+    beginHistoryCursor(response->cursor, from, step);
+    response->query = query;
+    server.sendStream(200, "application/json", fillHistoryResponse<Item, Query>, response,
+                      releaseHistoryResponse<Item, Query>);
+    server.sendContent(header);
+}
+
+void streamHistoryJSON(uint32_t from, uint32_t to) {
+    TimeSeriesStats stats = getEnvironmentHistoryStats();
+    
+    char header[384];
+    snprintf(header, sizeof(header),
+             "{\"now\":%u,\"from\":%u,\"to\":%u,"
+             "\"stats\":{\"samples\":%u,\"bytes\":%u,\"blocks\":%u,\"blocks_in_use\":%u,"
+             "\"evicted\":%u,\"oldest\":%u,\"newest\":%u},"
+             "\"columns\":[\"t\",\"temperature\",\"humidity\"],\"samples\":[",
+             (unsigned)environmentHistoryTime(), (unsigned)from, (unsigned)to,
+             (unsigned)stats.sampleCount, (unsigned)stats.bytesUsed, (unsigned)stats.blockCount,
+             (unsigned)stats.blocksInUse, (unsigned)stats.blocksEvicted,
+             (unsigned)stats.oldestTimestamp, (unsigned)stats.newestTimestamp);
+    
+    SampleQuery query = {to};
+    streamHistoryResponse<TimeSeriesSample>(header, from, 1, query);
+}
+
+void streamRollupJSON(RollupResolution resolution, uint32_t from, uint32_t to) {
+    char header[256];
+    int length = snprintf(header, sizeof(header),
+                          "{\"now\":%u,\"from\":%u,\"to\":%u,\"resolution\":\"%s\",\"width_s\":%u,"
+                          "\"series\":[",
+                          (unsigned)environmentHistoryTime(), (unsigned)from, (unsigned)to,
+                          RollupEngine::resolutionName(resolution),
+                          (unsigned)RollupEngine::widthSeconds(resolution));
+    for (int i = 0; i < ROLLUP_SERIES_COUNT; i++) {
+        length += snprintf(header + length, sizeof(header) - length, "%s\"%s\"",
+                           i ? "," : "", RollupEngine::seriesName((RollupSeries)i));
+    }
+    snprintf(header + length, sizeof(header) - length, "],\"buckets\":[");
+    
+    RollupQuery query = {resolution, to};
+    streamHistoryResponse<RollupBucket>(header, from, RollupEngine::widthSeconds(resolution), query);
+}
+
+struct LogsJSONContext {
+    JsonArray entries;
+    uint32_t lastSequence;
+};
+
+static bool addLogRecordJSON(const LogRecord& record, void* context) {
+    LogsJSONContext& logs = *static_cast<LogsJSONContext*>(context);
+    JsonObject entry = logs.entries.add<JsonObject>();
+    entry["seq"] = record.sequence;
+    entry["time_us"] = record.timestampUs;
+    entry["level"] = LogRing::levelName(record.level);
+    entry["message"] = record.message;
+    logs.lastSequence = record.sequence;
+    return true;
+}
+
+String getLogsJSON(uint32_t after, size_t limit) {
+    JsonDocument doc;
+    
+    // A cursor ahead of the log means the device restarted: start over
+    if (after > getLogLastSequence()) {
+        after = 0;
+        doc["reset"] = true;
+    }
+    
+    // 'missed' counts entries overwritten before this client fetched them
+    uint32_t oldest = getLogOldestSequence();
+    doc["missed"] = (oldest > 0 && after + 1 < oldest) ? oldest - after - 1 : 0;
+    
+    LogsJSONContext logs = {doc["entries"].to<JsonArray>(), after};
+    readLogEntries(after, limit, addLogRecordJSON, &logs);
+    doc["next"] = logs.lastSequence;  // Cursor for the following request
+    
+    // Deferred logging pipeline: cost at the call site and losses
+    SystemLogStats stats = getSystemLogStats();
+    doc["pipeline"]["enqueued"] = stats.enqueued;
+    doc["pipeline"]["dropped"] = stats.dropped;
+    doc["pipeline"]["queue_high_water"] = stats.queueHighWater;
+    doc["pipeline"]["enqueue_cycles_max"] = stats.enqueueCyclesMax;
+    doc["pipeline"]["enqueue_cycles_mean"] = stats.enqueued ? (uint32_t)(stats.enqueueCyclesTotal / stats.enqueued) : 0;
+    doc["pipeline"]["cpu_mhz"] = getCpuFrequencyMhz();
+    
+    String jsonString;
+    serializeJson(doc, jsonString);
+    return jsonString;
+}
+
+String getSchedulerJSON() {
+    JsonDocument doc;
     
-    return R"(<!DOCTYPE html>
-<html>
-<head>
-    <meta charset="UTF-8">
-    <meta name="viewport" content="width=device-width, initial-scale=1.0">
-    <title>ESP32 Garage Door Sensor</title>
-    <style>
-        body { font-family: Arial, sans-serif; max-width: 800px; margin: 0 auto; padding: 20px; background: #f5f5f5; }
-        .container { background: white; border-radius: 8px; padding: 20px; box-shadow: 0 2px 10px rgba(0,0,0,0.1); margin-bottom: 20px; }
-        h1 { color: #333; text-align: center; margin-bottom: 30px; }
-        .status-grid { display: grid; grid-template-columns: repeat(auto-fit, minmax(200px, 1fr)); gap: 20px; margin-bottom: 30px; }
-        .status-card { background: #f8f9fa; border-radius: 6px; padding: 15px; text-align: center; border-left: 4px solid #007bff; }
-        .status-card.blocked { border-left-color: #dc3545; background: #f8d7da; }
-        .status-card.clear { border-left-color: #28a745; background: #d4edda; }
-        .status-card.on { border-left-color: #ffc107; background: #fff3cd; }
-        .status-card.temp-normal { border-left-color: #17a2b8; background: #d1ecf1; }
-        .status-card.humidity-normal { border-left-color: #6f42c1; background: #e2d9f3; }
-        .update-available { color: #856404; background: #fff3cd; padding: 5px 10px; border-radius: 4px; font-weight: bold; }
-        .update-current { color: #155724; background: #d4edda; padding: 5px 10px; border-radius: 4px; font-weight: bold; }
-        .status-value { font-size: 24px; font-weight: bold; margin-bottom: 5px; }
-        .status-label { color: #666; font-size: 14px; }
-        .button { background: #007bff; color: white; border: none; padding: 12px 24px; border-radius: 4px; cursor: pointer; font-size: 16px; margin: 5px; text-decoration: none; display: inline-block; }
-        .button:hover { background: #0056b3; }
-        .button.success { background: #28a745; }
-        .update-section { text-align: center; }
-        .refresh-note { color: #666; font-size: 12px; margin-top: 10px; }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <h1>ESP32 Garage Door Sensor</h1>
-        <div class="status-grid">
-            <div class="status-card )" + beamClass + R"(">
-                <div class="status-value">)" + beamStatus + R"(</div>
-                <div class="status-label">Beam Sensor</div>
-            </div>
-            <div class="status-card )" + ledClass + R"(">
-                <div class="status-value">)" + ledStatus + R"(</div>
-                <div class="status-label">Status LED</div>
-            </div>
-            <div class="status-card )" + tempClass + R"(">
-                <div class="status-value">)" + temperature + R"(</div>
-                <div class="status-label">Temperature</div>
-            </div>
-            <div class="status-card )" + humidityClass + R"(">
-                <div class="status-value">)" + humidity + R"(</div>
-                <div class="status-label">Humidity</div>
-            </div>
-            <div class="status-card">
-                <div class="status-value">)" + uptime + R"(</div>
-                <div class="status-label">Uptime</div>
-            </div>
-            <div class="status-card">
-                <div class="status-value">)" + memory + R"(</div>
-                <div class="status-label">Free Memory</div>
-            </div>
-        </div>
-        <div class="update-section">
-            <h3>Firmware Updates</h3>
-            <p>Current Version: )" + String(FIRMWARE_VERSION) + R"(</p>
-            <p>Latest Available: )" + latestVersion + R"( <span class=")" + updateClass + R"(">)" + updateStatus + R"(</span></p>
-            <div style="margin: 20px 0; padding: 20px; background: #e8f5e8; border-radius: 8px; border: 2px solid #28a745;">
-                <h4 style="margin: 0 0 10px 0; color: #155724;">🚀 Install Latest Update</h4>
-                <p style="margin: 0 0 15px 0; color: #155724;">Click the button below to install the latest firmware version.</p>
-                <form method="POST" action="/api/ota/install" style="margin: 0;">
-                    <button type="submit" class="button success" style="font-size: 18px; padding: 15px 30px; background: #28a745; border: none; color: white; border-radius: 6px; cursor: pointer; font-weight: bold;">
-                        ⬇️ Install Update Now
-                    </button>
-                </form>
-                <p style="margin-top: 10px; font-size: 12px; color: #666;">Device will restart automatically after update</p>
-            </div>
-            <p><a href="/refresh" class="button">🔄 Refresh Status</a></p>
-            <p>
-                <form method="POST" action="/api/ota/check" style="display: inline; margin: 5px;">
-                    <button type="submit" class="button" style="background: #17a2b8;">🔍 Check for Updates</button>
-                </form>
-            </p>
-            <p><a href="/api/status" class="button">📊 View Status JSON</a></p>
-            <p><a href="/api/ota/status" class="button">🔍 Check Updates JSON</a></p>
-            <div class="refresh-note">Click "Refresh Status" to update sensor readings</div>
-        </div>
-    </div>
-</body>
-</html>)";
+    doc["passes"] = taskScheduler.getPassCount();
+    doc["sleep_us"] = taskScheduler.getTotalSleepUs();
+    
+    JsonArray jobs = doc["jobs"].to<JsonArray>();
+    for (int i = 0; i < taskScheduler.getJobCount(); i++) {
+        const SchedulerJob* job = taskScheduler.getJob(i);
+        JsonObject entry = jobs.add<JsonObject>();
+        entry["name"] = job->name;
+        entry["period_us"] = job->periodUs;
+        entry["runs"] = job->stats.runs;
+        entry["overruns"] = job->stats.overruns;
+        entry["jitter_last_us"] = job->stats.lastJitterUs;
+        entry["jitter_max_us"] = job->stats.maxJitterUs;
+        entry["jitter_mean_us"] = job->stats.runs ? (uint32_t)(job->stats.totalJitterUs / job->stats.runs) : 0;
+        entry["run_last_us"] = job->stats.lastRunUs;
+        entry["run_max_us"] = job->stats.maxRunUs;
+    }
+    
+    String jsonString;
+    serializeJson(doc, jsonString);
+    return jsonString;
+}
+
+// Metrics text is rendered line by line into a small buffer and streamed
+// as chunks, a metric at a time as the client reads. There is one static
+// buffer, so a scrape allocates nothing; a second scrape while one is
+// still streaming gets a 503. Fill and release run on the web server task,
+// so the flag needs no lock.
+#define METRICS_CHUNK_BYTES 512
+
+struct MetricsChunk {
+    char buffer[METRICS_CHUNK_BYTES];
+    size_t length;
+    uint32_t chunks;                // Sent so far
+    MetricsCursor cursor;
+};
+
+static MetricsChunk metricsChunk;
+static bool metricsStreaming = false;
+
+static void appendMetricsText(const char* text, size_t length, void* context) {
+    MetricsChunk& chunk = *static_cast<MetricsChunk*>(context);
+    if (chunk.length + length > sizeof(chunk.buffer)) {
+        server.sendContent(chunk.buffer, chunk.length);
+        chunk.length = 0;
+        chunk.chunks++;
+    }
+    memcpy(chunk.buffer + chunk.length, text, length);
+    chunk.length += length;
+}
+
+// Fill step: metrics until a chunk has gone out
+static bool fillMetrics(void* context) {
+    MetricsChunk& chunk = *static_cast<MetricsChunk*>(context);
+    uint32_t chunks = chunk.chunks;
+    while (chunk.chunks == chunks) {
+        if (!renderNextMetric(chunk.cursor, appendMetricsText, &chunk)) {
+            if (chunk.length > 0) {
+                server.sendContent(chunk.buffer, chunk.length);
+            }
+            server.sendContent("");  // Terminating chunk
+            return false;
+        }
+    }
+    return true;
+}
+
+static void releaseMetrics(void*) {
+    metricsStreaming = false;
+}
+
+void sendMetrics() {
+    if (metricsStreaming) {
+        server.sendHeader("Retry-After", "1");
+        server.send(503, "text/plain", "scrape in progress\n");
+        return;
+    }
+    metricsStreaming = true;
+    metricsChunk.length = 0;
+    metricsChunk.chunks = 0;
+    metricsChunk.cursor.started = false;
+    server.sendStream(200, "text/plain; version=0.0.4", fillMetrics, &metricsChunk, releaseMetrics);
+}
+
+// The dashboard never changes at runtime, so it is served exactly as
+// generated at build time (see tools/embed_web_assets.py): no per-request
+// HTML, and browsers revalidate with the ETag instead of downloading again
+void sendDashboard() {
+    server.sendHeader("ETag", DASHBOARD_HTML_ETAG);
+    server.sendHeader("Cache-Control", "no-cache");
+    if (server.header("If-None-Match") == DASHBOARD_HTML_ETAG) {
+        server.send(304);
+        return;
+    }
+    server.sendHeader("Content-Encoding", "gzip");
+    server.send_P(200, "text/html", (const char*)DASHBOARD_HTML_GZ, DASHBOARD_HTML_GZ_LENGTH);
 }
 
 #endif // ENABLE_WIFI
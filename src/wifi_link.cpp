@@ -0,0 +1,107 @@
+#include "wifi_link.h"
+
+WiFiLink::WiFiLink(WiFiLinkClockFn clock, WiFiLinkConnectFn connect, WiFiLinkDisconnectFn disconnect,
+                   const WiFiLinkConfig& config)
+    : clockFn(clock), connectFn(connect), disconnectFn(disconnect), config(config) {
+}
+
+void WiFiLink::start() {
+    if (state == WIFI_LINK_IDLE) {
+        beginAttempt(clockFn());
+    }
+}
+
+void WiFiLink::stop() {
+    if (state != WIFI_LINK_IDLE) {
+        disconnectFn();
+        state = WIFI_LINK_IDLE;
+        stats.failures = 0;
+    }
+}
+
+void WiFiLink::postEvent(WiFiLinkEvent event) {
+    pendingEvent.store(event);
+}
+
+// Events that arrive while backing off (typically the disconnect caused by
+// abandoning the last attempt) are dropped when the next attempt starts
+void WiFiLink::beginAttempt(uint32_t now) {
+    pendingEvent.store(WIFI_LINK_EVENT_NONE);
+    stats.attempts++;
+    state = WIFI_LINK_ASSOCIATING;
+    stateStartMs = now;
+    connectFn(stats.attempts);
+}
+
+void WiFiLink::failAttempt(uint32_t now) {
+    if (stats.failures < 255) {
+        stats.failures++;
+    }
+    backoffMs = config.backoffMinMs;
+    for (uint8_t i = 1; i < stats.failures && backoffMs < config.backoffMaxMs; i++) {
+        backoffMs *= 2;
+    }
+    if (backoffMs > config.backoffMaxMs) {
+        backoffMs = config.backoffMaxMs;
+    }
+    state = WIFI_LINK_BACKOFF;
+    stateStartMs = now;
+}
+
+bool WiFiLink::poll() {
+    WiFiLinkState previous = state;
+    uint32_t now = clockFn();
+    WiFiLinkEvent event = (WiFiLinkEvent)pendingEvent.exchange(WIFI_LINK_EVENT_NONE);
+
+    switch (state) {
+        case WIFI_LINK_IDLE:
+            break;
+
+        case WIFI_LINK_ASSOCIATING:
+            if (event == WIFI_LINK_EVENT_GOT_IP) {
+                state = WIFI_LINK_CONNECTED;
+                stateStartMs = now;
+                stats.connects++;
+                stats.failures = 0;
+            } else if (event == WIFI_LINK_EVENT_DISCONNECTED) {
+                failAttempt(now);
+            } else if (now - stateStartMs >= config.connectTimeoutMs) {
+                stats.timeouts++;
+                disconnectFn();
+                failAttempt(now);
+            }
+            break;
+
+        case WIFI_LINK_CONNECTED:
+            if (event == WIFI_LINK_EVENT_DISCONNECTED) {
+                stats.disconnects++;
+                beginAttempt(now);
+            }
+            break;
+
+        case WIFI_LINK_BACKOFF:
+            if (now - stateStartMs >= backoffMs) {
+                beginAttempt(now);
+            }
+            break;
+    }
+    return state != previous;
+}
+
+uint32_t WiFiLink::getBackoffRemainingMs() const {
+    if (state != WIFI_LINK_BACKOFF) {
+        return 0;
+    }
+    uint32_t waited = clockFn() - stateStartMs;
+    return waited < backoffMs ? backoffMs - waited : 0;
+}
+
+const char* WiFiLink::stateName(WiFiLinkState state) {
+    switch (state) {
+        case WIFI_LINK_IDLE: return "idle";
+        case WIFI_LINK_ASSOCIATING: return "associating";
+        case WIFI_LINK_CONNECTED: return "connected";
+        case WIFI_LINK_BACKOFF: return "backoff";
+        default: return "unknown";
+    }
+}
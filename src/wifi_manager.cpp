@@ -1,49 +1,182 @@
 #include "wifi_manager.h"
 #include <Preferences.h>
+#include "metrics.h"
+#include "system_log.h"
+#include "config_store.h"
 
 #ifdef ENABLE_WIFI
 
+MetricCounter wifiReconnectsMetric("garage_wifi_reconnects_total", "Reconnection attempts after losing WiFi");
+
 Preferences wifiPrefs;
 bool wifiConnected = false;
-unsigned long lastWiFiCheck = 0;
-int wifiRetryCount = 0;
 
-void initWiFi() {
-    Serial.println("\n=== WiFi Initialization with NVS Support ===");
+// Credentials tried in turn: saved in NVS first, then the ones from secrets.h
+static String candidateSSID[2];
+static String candidatePassword[2];
+static uint8_t candidateCount = 0;
+static uint8_t candidateIndex = 0;      // Of the current attempt
+static uint32_t attemptStartMs = 0;
+static bool attemptFast = false;        // Current attempt uses the fast path
+
+// Last successful association, kept in the "wifi" namespace. Associating
+// straight to that BSSID on its channel skips the scan of every channel;
+// with WIFI_FAST_RECONNECT_STATIC_IP the old DHCP lease is reused as a
+// static address too. After a failed fast attempt, attempts scan again
+// until the next connection.
+struct WiFiFastPath {
+    String ssid;
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+};
+static WiFiFastPath fastPath;
+static bool fastPathValid = false;
+static bool fastPathFailed = false;
+
+static void loadFastPath() {
+    fastPath.ssid = wifiPrefs.getString("fast_ssid", "");
+    fastPath.channel = wifiPrefs.getUChar("channel", 0);
+    fastPath.ip = wifiPrefs.getUInt("ip", 0);
+    fastPath.gateway = wifiPrefs.getUInt("gateway", 0);
+    fastPath.subnet = wifiPrefs.getUInt("subnet", 0);
+    fastPath.dns = wifiPrefs.getUInt("dns", 0);
+    fastPathValid = fastPath.ssid.length() > 0 && fastPath.channel != 0 &&
+                    wifiPrefs.getBytes("bssid", fastPath.bssid, sizeof(fastPath.bssid)) == sizeof(fastPath.bssid);
+}
+
+// Only writes what changed, so reconnecting to the same AP costs no flash wear
+static void saveFastPath(const String& ssid) {
+    WiFiFastPath current;
+    current.ssid = ssid;
+    memcpy(current.bssid, WiFi.BSSID(), sizeof(current.bssid));
+    current.channel = WiFi.channel();
+    current.ip = WiFi.localIP();
+    current.gateway = WiFi.gatewayIP();
+    current.subnet = WiFi.subnetMask();
+    current.dns = WiFi.dnsIP();
     
-    // Initialize NVS preferences
-    wifiPrefs.begin("wifi", false);
+    bool fresh = !fastPathValid;
+    if (fresh || fastPath.ssid != current.ssid) {
+        wifiPrefs.putString("fast_ssid", current.ssid);
+    }
+    if (fresh || memcmp(fastPath.bssid, current.bssid, sizeof(current.bssid)) != 0) {
+        wifiPrefs.putBytes("bssid", current.bssid, sizeof(current.bssid));
+    }
+    if (fresh || fastPath.channel != current.channel) {
+        wifiPrefs.putUChar("channel", current.channel);
+    }
+    if (fresh || fastPath.ip != current.ip) {
+        wifiPrefs.putUInt("ip", current.ip);
+    }
+    if (fresh || fastPath.gateway != current.gateway) {
+        wifiPrefs.putUInt("gateway", current.gateway);
+    }
+    if (fresh || fastPath.subnet != current.subnet) {
+        wifiPrefs.putUInt("subnet", current.subnet);
+    }
+    if (fresh || fastPath.dns != current.dns) {
+        wifiPrefs.putUInt("dns", current.dns);
+    }
+    fastPath = current;
+    fastPathValid = current.channel != 0;
+}
+
+static uint32_t wifiClock() {
+    return millis();
+}
+
+// WiFi.begin() and WiFi.disconnect() only queue the request with the
+// driver; the outcome comes back as an event
+static void startWiFiAttempt(uint32_t attempt) {
+    candidateIndex = (attempt - 1) % candidateCount;
+    const String& ssid = candidateSSID[candidateIndex];
+    const String& password = candidatePassword[candidateIndex];
+    attemptStartMs = millis();
     
-    // Try to load saved credentials first
-    String savedSSID = wifiPrefs.getString("ssid", "");
-    String savedPassword = wifiPrefs.getString("password", "");
+    attemptFast = configStore.getBool(CONFIG_WIFI_FAST_RECONNECT) && fastPathValid && !fastPathFailed &&
+                  fastPath.ssid == ssid;
     
-    if (savedSSID.length() > 0) {
-        Serial.printf("Found saved WiFi credentials for: %s\n", savedSSID.c_str());
-        if (connectToWiFi(savedSSID, savedPassword)) {
-            return; // Successfully connected with saved credentials
-        }
-        Serial.println("Saved credentials failed, trying hardcoded...");
+    #ifdef WIFI_FAST_RECONNECT_STATIC_IP
+    if (attemptFast && fastPath.ip != 0) {
+        WiFi.config(IPAddress(fastPath.ip), IPAddress(fastPath.gateway), IPAddress(fastPath.subnet),
+                    IPAddress(fastPath.dns));
+    } else {
+        WiFi.config(IPAddress(), IPAddress(), IPAddress());  // DHCP
     }
+    #endif
     
-    // Try hardcoded credentials from secrets.h
-    Serial.printf("Trying hardcoded SSID: %s\n", WIFI_SSID);
-    if (connectToWiFi(WIFI_SSID, WIFI_PASSWORD)) {
-        // Save working credentials to NVS for future OTA updates
-        wifiPrefs.putString("ssid", WIFI_SSID);
-        wifiPrefs.putString("password", WIFI_PASSWORD);
-        Serial.println("✅ WiFi credentials saved to NVS for future OTA updates");
-        return;
+    if (attemptFast) {
+        Serial.printf("Connecting to %s (attempt %lu, cached BSSID on channel %u)\n", ssid.c_str(),
+                      (unsigned long)attempt, fastPath.channel);
+        WiFi.begin(ssid.c_str(), password.c_str(), fastPath.channel, fastPath.bssid);
+    } else {
+        Serial.printf("Connecting to %s (attempt %lu, full scan)\n", ssid.c_str(), (unsigned long)attempt);
+        WiFi.begin(ssid.c_str(), password.c_str());
     }
-    
-    Serial.println("❌ No WiFi connection possible with saved or hardcoded credentials");
 }
 
-bool connectToWiFi(const String& ssid, const String& password) {
-    // Set WiFi mode
-    WiFi.mode(WIFI_STA);
+static void abandonWiFiAttempt() {
     WiFi.disconnect();
-    delay(100);
+}
+
+static const WiFiLinkConfig wifiLinkConfig = {WIFI_CONNECT_TIMEOUT, WIFI_BACKOFF_MIN_MS, WIFI_BACKOFF_MAX_MS};
+WiFiLink wifiLink(wifiClock, startWiFiAttempt, abandonWiFiAttempt, wifiLinkConfig);
+
+// Runs on the WiFi event task
+static void onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
+    switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            wifiLink.postEvent(WIFI_LINK_EVENT_GOT_IP);
+            break;
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+        case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+            wifiLink.postEvent(WIFI_LINK_EVENT_DISCONNECTED);
+            break;
+        default:
+            break;
+    }
+}
+
+static void loadCandidates() {
+    candidateCount = 0;
+    String savedSSID = configStore.getString(CONFIG_WIFI_SSID);
+    if (savedSSID.length() > 0) {
+        Serial.printf("Found saved WiFi credentials for: %s\n", savedSSID.c_str());
+        candidateSSID[candidateCount] = savedSSID;
+        candidatePassword[candidateCount++] = configStore.getString(CONFIG_WIFI_PASSWORD);
+    }
+    if (candidateCount == 0 || candidateSSID[0] != WIFI_SSID ||
+        candidatePassword[0] != WIFI_PASSWORD) {
+        candidateSSID[candidateCount] = WIFI_SSID;
+        candidatePassword[candidateCount++] = WIFI_PASSWORD;
+    }
+}
+
+// Pick up settings changed through the config store (/api/config).
+// Credentials apply from the next connection attempt.
+static uint32_t appliedGeneration = 0;
+
+static void applyWiFiSettings() {
+    appliedGeneration = configStore.getGeneration();
+    WiFiLinkConfig config;
+    config.connectTimeoutMs = configStore.getUInt(CONFIG_WIFI_CONNECT_TIMEOUT);
+    config.backoffMinMs = configStore.getUInt(CONFIG_WIFI_BACKOFF_MIN);
+    config.backoffMaxMs = configStore.getUInt(CONFIG_WIFI_BACKOFF_MAX);
+    wifiLink.setConfig(config);
+    loadCandidates();
+}
+
+void initWiFi() {
+    Serial.println("\n=== WiFi Initialization with NVS Support ===");
+    
+    // Initialize NVS preferences
+    wifiPrefs.begin("wifi", false);
+    applyWiFiSettings();
+    loadFastPath();
     
     // Setup status LED if defined
     #ifdef WIFI_STATUS_LED
@@ -51,73 +184,76 @@ bool connectToWiFi(const String& ssid, const String& password) {
     digitalWrite(WIFI_STATUS_LED, WIFI_LED_OFF);
     #endif
     
-    wifiRetryCount = 0;
-    WiFi.begin(ssid.c_str(), password.c_str());
-    
-    Serial.printf("Connecting to %s", ssid.c_str());
-    unsigned long startTime = millis();
-    
-    while (WiFi.status() != WL_CONNECTED && 
-           millis() - startTime < WIFI_CONNECT_TIMEOUT &&
-           wifiRetryCount < WIFI_MAX_RETRIES) {
-        
-        delay(WIFI_RETRY_DELAY);
-        Serial.print(".");
-        wifiRetryCount++;
-        
-        // Blink status LED while connecting
-        #ifdef WIFI_STATUS_LED
-        digitalWrite(WIFI_STATUS_LED, (millis() / 250) % 2);
-        #endif
-    }
-    
-    if (WiFi.status() == WL_CONNECTED) {
-        wifiConnected = true;
-        Serial.println(" Connected!");
-        Serial.printf("📶 IP address: %s\n", WiFi.localIP().toString().c_str());
-        Serial.printf("📡 Signal strength: %d dBm\n", WiFi.RSSI());
-        
-        #ifdef WIFI_STATUS_LED
-        digitalWrite(WIFI_STATUS_LED, WIFI_LED_ON);
-        #endif
-        
-        return true;
-    } else {
-        wifiConnected = false;
-        Serial.println(" Failed!");
-        Serial.printf("Connection status: %s\n", getWiFiStatusString().c_str());
-        
-        #ifdef WIFI_STATUS_LED
-        digitalWrite(WIFI_STATUS_LED, WIFI_LED_OFF);
-        #endif
-        
-        return false;
-    }
+    // Reconnecting is the state machine's job, not the driver's
+    WiFi.mode(WIFI_STA);
+    WiFi.setAutoReconnect(false);
+    WiFi.onEvent(onWiFiEvent);
+    wifiLink.start();
 }
 
+// Start over with the current credentials, e.g. after they were changed
 void connectToWiFi() {
-    String ssid = wifiPrefs.getString("ssid", WIFI_SSID);
-    String password = wifiPrefs.getString("password", WIFI_PASSWORD);
-    connectToWiFi(ssid, password);
+    wifiLink.stop();
+    loadCandidates();
+    wifiLink.start();
 }
 
+// Called by the main-loop scheduler every WIFI_POLL_INTERVAL. Only looks
+// at the state machine, so it never waits for the network.
 void checkWiFiConnection() {
-    if (millis() - lastWiFiCheck > 30000) { // Check every 30 seconds
-        lastWiFiCheck = millis();
-        
-        if (WiFi.status() != WL_CONNECTED) {
-            wifiConnected = false;
-            Serial.println("WiFi disconnected, attempting to reconnect...");
-            connectToWiFi();
-        } else if (!wifiConnected) {
-            wifiConnected = true;
-            Serial.println("WiFi reconnected successfully");
+    if (configStore.getGeneration() != appliedGeneration) {
+        applyWiFiSettings();
+    }
+    
+    WiFiLinkState previous = wifiLink.getState();
+    if (wifiLink.poll()) {
+        switch (wifiLink.getState()) {
+            case WIFI_LINK_CONNECTED:
+                wifiConnected = true;
+                Serial.printf("📶 WiFi connected! IP: %s, signal: %d dBm\n",
+                              WiFi.localIP().toString().c_str(), WiFi.RSSI());
+                addLogEntryf(LOG_INFO, "WiFi connected to %s in %lu ms (%s)", candidateSSID[candidateIndex].c_str(),
+                             (unsigned long)(millis() - attemptStartMs), attemptFast ? "fast path" : "full scan");
+                fastPathFailed = false;
+                saveFastPath(candidateSSID[candidateIndex]);
+                // Save working credentials to NVS for future OTA updates
+                // (no flash write if they are saved already)
+                saveWiFiCredentials(candidateSSID[candidateIndex], candidatePassword[candidateIndex]);
+                break;
+            case WIFI_LINK_ASSOCIATING:
+                if (previous == WIFI_LINK_CONNECTED) {
+                    wifiConnected = false;
+                    LOGW("WiFi connection lost, reconnecting");
+                }
+                if (wifiLink.getStats().connects > 0) {
+                    wifiReconnectsMetric.increment();
+                }
+                break;
+            case WIFI_LINK_BACKOFF:
+                wifiConnected = false;
+                addLogEntryf(LOG_WARN, "WiFi connection failed after %lu ms (%s, %s), retrying in %lu ms",
+                             (unsigned long)(millis() - attemptStartMs), attemptFast ? "fast path" : "full scan",
+                             getWiFiStatusString().c_str(), (unsigned long)wifiLink.getBackoffRemainingMs());
+                if (attemptFast) {
+                    fastPathFailed = true;  // The AP may have moved; scan from now on
+                }
+                break;
+            default:
+                wifiConnected = false;
+                break;
         }
     }
+    
+    #ifdef WIFI_STATUS_LED
+    // On when connected, blinking while connecting
+    WiFiLinkState state = wifiLink.getState();
+    digitalWrite(WIFI_STATUS_LED, state == WIFI_LINK_CONNECTED ? WIFI_LED_ON :
+                 state == WIFI_LINK_ASSOCIATING ? (millis() / 250) % 2 : WIFI_LED_OFF);
+    #endif
 }
 
 bool isWiFiConnected() {
-    return wifiConnected && (WiFi.status() == WL_CONNECTED);
+    return wifiLink.isConnected();
 }
 
 String getWiFiStatusString() {
@@ -166,19 +302,29 @@ void printWiFiInfo() {
 
 // NVS management functions for WiFi credentials
 void saveWiFiCredentials(const String& ssid, const String& password) {
-    wifiPrefs.putString("ssid", ssid);
-    wifiPrefs.putString("password", password);
-    Serial.printf("📱 WiFi credentials saved to NVS: %s\n", ssid.c_str());
+    configStore.set(CONFIG_WIFI_SSID, ssid);
+    configStore.set(CONFIG_WIFI_PASSWORD, password);
+    if (configStore.commit() > 0) {
+        Serial.printf("📱 WiFi credentials saved to NVS: %s\n", ssid.c_str());
+    }
 }
 
 bool loadWiFiCredentials(String& ssid, String& password) {
-    ssid = wifiPrefs.getString("ssid", "");
-    password = wifiPrefs.getString("password", "");
+    ssid = configStore.getString(CONFIG_WIFI_SSID);
+    password = configStore.getString(CONFIG_WIFI_PASSWORD);
     return (ssid.length() > 0);
 }
 
+// Forgets the last access point too; other WiFi settings stay
 void clearWiFiCredentials() {
-    wifiPrefs.clear();
+    configStore.set(CONFIG_WIFI_SSID, String());
+    configStore.set(CONFIG_WIFI_PASSWORD, String());
+    configStore.commit();
+    static const char* fastPathKeys[] = {"fast_ssid", "bssid", "channel", "ip", "gateway", "subnet", "dns"};
+    for (size_t i = 0; i < sizeof(fastPathKeys) / sizeof(fastPathKeys[0]); i++) {
+        wifiPrefs.remove(fastPathKeys[i]);
+    }
+    fastPathValid = false;
     Serial.println("🗑️ WiFi credentials cleared from NVS");
 }
 
@@ -186,7 +332,6 @@ void clearWiFiCredentials() {
 // WiFi disabled stubs
 void initWiFi() { /* WiFi disabled */ }
 void connectToWiFi() { /* WiFi disabled */ }
-bool connectToWiFi(const String& ssid, const String& password) { return false; }
 void checkWiFiConnection() { /* WiFi disabled */ }
 bool isWiFiConnected() { return false; }
 String getWiFiStatusString() { return "WiFi disabled"; }
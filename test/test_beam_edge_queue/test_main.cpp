@@ -0,0 +1,196 @@
+#include <unity.h>
+#include <thread>
+#include <vector>
+#include "beam_edge_queue.h"
+#include "beam_filter.h"
+
+// Sizes from config.h (which pulls in Arduino headers)
+#define EDGE_QUEUE_SIZE 64
+#define DRAIN_INTERVAL_US 1000
+
+struct Transition {
+    bool beamBroken;
+    uint32_t timestampUs;
+};
+
+static std::vector<Transition> transitions;
+
+static void recordTransition(bool beamBroken, uint32_t timestampUs) {
+    transitions.push_back({beamBroken, timestampUs});
+}
+
+static BeamEdgeQueue<EDGE_QUEUE_SIZE>* queue;
+static BeamFilter* filter;
+
+void setUp() {
+    transitions.clear();
+    queue = new BeamEdgeQueue<EDGE_QUEUE_SIZE>();
+    filter = new BeamFilter(recordTransition);
+}
+
+void tearDown() {
+    delete filter;
+    delete queue;
+}
+
+// What readE3JKRR11() does on every scheduler pass
+static void drain(uint32_t nowUs) {
+    BeamEdge edge;
+    while (queue->pop(edge)) {
+        filter->processEdge(edge.timestampUs, edge.beamBroken);
+    }
+    filter->advance(nowUs);
+}
+
+static void useLockout(uint32_t lockoutUs) {
+    BeamFilterConfig config = {BEAM_FILTER_LOCKOUT, lockoutUs, 0, 0, 0, 0};
+    filter->configure(config, false, 0);
+}
+
+void test_fifo_order_across_index_wrap() {
+    BeamEdge edge;
+    for (uint32_t i = 0; i < 10 * EDGE_QUEUE_SIZE; i++) {
+        TEST_ASSERT_TRUE(queue->push(i, i & 1));
+        TEST_ASSERT_TRUE(queue->pop(edge));
+        TEST_ASSERT_EQUAL_UINT32(i, edge.timestampUs);
+        TEST_ASSERT_EQUAL(i & 1, edge.beamBroken);
+    }
+    TEST_ASSERT_FALSE(queue->pop(edge));
+    TEST_ASSERT_EQUAL_UINT32(1, queue->highWater());
+}
+
+void test_overflow_keeps_oldest_and_counts() {
+    for (uint32_t i = 0; i < EDGE_QUEUE_SIZE + 5; i++) {
+        queue->push(i, i & 1);
+    }
+    TEST_ASSERT_EQUAL_UINT32(EDGE_QUEUE_SIZE, queue->size());
+    TEST_ASSERT_EQUAL_UINT32(EDGE_QUEUE_SIZE, queue->pushCount());
+    TEST_ASSERT_EQUAL_UINT32(5, queue->overflowCount());
+    TEST_ASSERT_EQUAL_UINT32(EDGE_QUEUE_SIZE, queue->highWater());
+
+    BeamEdge edge;
+    TEST_ASSERT_TRUE(queue->pop(edge));
+    TEST_ASSERT_EQUAL_UINT32(0, edge.timestampUs);
+}
+
+// Bursts of edges at 1, 5 and 20 kHz between idle gaps, with the ISR and the
+// 1 ms drain interleaved on a virtual clock. A 0 us lockout passes every
+// edge, so every transition must come out with its ISR timestamp.
+void test_khz_bursts_lose_no_transitions() {
+    useLockout(0);
+    const uint32_t spacingsUs[] = {1000, 200, 50};
+    std::vector<Transition> expected;
+    uint32_t t = 10000;
+    bool level = false;
+
+    for (uint32_t spacing : spacingsUs) {
+        for (int burst = 0; burst < 20; burst++) {
+            for (int i = 0; i < 40; i++) {
+                level = !level;
+                queue->push(t, level);
+                expected.push_back({level, t});
+                t += spacing;
+                if (t / DRAIN_INTERVAL_US != (t - spacing) / DRAIN_INTERVAL_US) {
+                    drain(t / DRAIN_INTERVAL_US * DRAIN_INTERVAL_US);
+                }
+            }
+            t += 30000;
+            drain(t);
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, queue->overflowCount());
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), transitions.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        TEST_ASSERT_EQUAL(expected[i].beamBroken, transitions[i].beamBroken);
+        TEST_ASSERT_EQUAL_UINT32(expected[i].timestampUs, transitions[i].timestampUs);
+    }
+}
+
+// A late drain (a slow job holding the loop) only loses edges once more
+// than a queue's worth arrived in the gap
+void test_late_drain_within_capacity_loses_nothing() {
+    useLockout(0);
+    uint32_t t = 1000;
+    for (int i = 0; i < EDGE_QUEUE_SIZE; i++) {
+        queue->push(t, (i & 1) == 0);
+        t += 50;  // 20 kHz for 3.2 ms without a drain
+    }
+    drain(t);
+    TEST_ASSERT_EQUAL_UINT32(0, queue->overflowCount());
+    TEST_ASSERT_EQUAL_UINT32(EDGE_QUEUE_SIZE, transitions.size());
+}
+
+// Regression: broken -> clear -> broken inside the debounce window must not
+// apply a stale "clear" when the window expires
+void test_glitch_inside_lockout_is_not_applied_late() {
+    useLockout(50000);
+    queue->push(1000, true);
+    queue->push(2000, false);
+    queue->push(3000, true);
+    drain(4000);
+    drain(100000);
+
+    TEST_ASSERT_EQUAL_UINT32(1, transitions.size());
+    TEST_ASSERT_TRUE(transitions[0].beamBroken);
+    TEST_ASSERT_EQUAL_UINT32(1000, transitions[0].timestampUs);
+    TEST_ASSERT_TRUE(filter->getState());
+    TEST_ASSERT_EQUAL_UINT32(1, filter->getStats().rejectedGlitches);
+}
+
+// The edge that ends a glitch is applied once the window expires
+void test_edge_inside_lockout_is_applied_at_expiry() {
+    useLockout(50000);
+    queue->push(1000, true);
+    queue->push(2000, false);
+    drain(4000);
+    TEST_ASSERT_EQUAL_UINT32(1, transitions.size());
+    drain(60000);
+
+    TEST_ASSERT_EQUAL_UINT32(2, transitions.size());
+    TEST_ASSERT_FALSE(transitions[1].beamBroken);
+    TEST_ASSERT_EQUAL_UINT32(2000, transitions[1].timestampUs);
+}
+
+// Real producer and consumer threads: everything pushed arrives once, in
+// order and intact
+void test_concurrent_producer_and_consumer() {
+    const uint32_t total = 1000000;
+    std::thread producer([] {
+        for (uint32_t i = 0; i < total; i++) {
+            while (!queue->push(i, i & 1)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t received = 0;
+    bool inOrder = true;
+    BeamEdge edge;
+    while (received < total) {
+        if (!queue->pop(edge)) {
+            continue;
+        }
+        if (edge.timestampUs != received || edge.beamBroken != (bool)(received & 1)) {
+            inOrder = false;
+        }
+        received++;
+    }
+    producer.join();
+
+    TEST_ASSERT_TRUE(inOrder);
+    TEST_ASSERT_EQUAL_UINT32(total, queue->pushCount());
+    TEST_ASSERT_FALSE(queue->pop(edge));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_fifo_order_across_index_wrap);
+    RUN_TEST(test_overflow_keeps_oldest_and_counts);
+    RUN_TEST(test_khz_bursts_lose_no_transitions);
+    RUN_TEST(test_late_drain_within_capacity_loses_nothing);
+    RUN_TEST(test_glitch_inside_lockout_is_not_applied_late);
+    RUN_TEST(test_edge_inside_lockout_is_applied_at_expiry);
+    RUN_TEST(test_concurrent_producer_and_consumer);
+    return UNITY_END();
+}
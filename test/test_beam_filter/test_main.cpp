@@ -0,0 +1,282 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include "beam_filter.h"
+
+// Filter modes with the config.h defaults
+static const BeamFilterConfig lockoutConfig = {BEAM_FILTER_LOCKOUT, 50000, 0, 0, 0, 0};
+static const BeamFilterConfig integratorConfig = {BEAM_FILTER_INTEGRATOR, 0, 20000, 0, 0, 0};
+static const BeamFilterConfig majorityConfig = {BEAM_FILTER_MAJORITY, 0, 0, 5000, 4, 5};
+
+struct Edge {
+    uint32_t timestampUs;
+    bool beamBroken;
+};
+
+struct Transition {
+    bool beamBroken;
+    uint32_t timestampUs;
+};
+
+static std::vector<Transition> transitions;
+
+static void recordTransition(bool beamBroken, uint32_t timestampUs) {
+    transitions.push_back({beamBroken, timestampUs});
+}
+
+// A noisy trace: real passes (the truth) plus the edges the sensor shows
+struct Trace {
+    std::vector<Transition> truth;
+    std::vector<Edge> edges;
+    uint32_t endUs;
+};
+
+struct NoiseProfile {
+    const char* name;
+    uint32_t bounceEdges;       // Extra edges around each real transition
+    uint32_t bounceSpanUs;
+    uint32_t glitchesPerMinute; // Spikes to the opposite level in steady state
+    uint32_t glitchMaxUs;
+};
+
+static uint32_t randomBetween(uint32_t low, uint32_t high) {
+    return low + (uint32_t)(((uint64_t)rand() * (high - low + 1)) / ((uint64_t)RAND_MAX + 1));
+}
+
+static void addEdge(Trace& trace, uint32_t timestampUs, bool level) {
+    if (!trace.edges.empty() && trace.edges.back().beamBroken == level) {
+        return;
+    }
+    trace.edges.push_back({timestampUs, level});
+}
+
+// Passes of 30 ms (a fast car bumper) to 3 s, 0.5-20 s apart, for durationUs
+static Trace buildTrace(const NoiseProfile& noise, uint32_t durationUs, unsigned seed) {
+    srand(seed);
+    Trace trace;
+    bool level = false;
+    uint32_t t = 100000;
+    trace.edges.push_back({0, false});
+
+    while (t < durationUs) {
+        uint32_t steadyUs = level ? randomBetween(30000, 3000000) : randomBetween(500000, 20000000);
+        uint32_t steadyEnd = t + steadyUs;
+
+        // Glitches inside the steady period, clear of the bounce
+        uint32_t glitches = (uint32_t)((uint64_t)noise.glitchesPerMinute * steadyUs / 60000000);
+        std::vector<uint32_t> starts;
+        for (uint32_t i = 0; i < glitches; i++) {
+            starts.push_back(randomBetween(t + noise.bounceSpanUs + 1, steadyEnd - noise.glitchMaxUs - 1));
+        }
+        std::sort(starts.begin(), starts.end());
+
+        // Bounce: the new level, then a few flips back within bounceSpanUs
+        addEdge(trace, t, level);
+        uint32_t bounceT = t;
+        for (uint32_t i = 0; i < noise.bounceEdges && !trace.truth.empty(); i++) {
+            bounceT += randomBetween(1, noise.bounceSpanUs / (noise.bounceEdges + 1));
+            addEdge(trace, bounceT, (i & 1) ? level : !level);
+        }
+        addEdge(trace, bounceT + 1, level);
+
+        uint32_t lastGlitchEnd = bounceT + 1;
+        for (uint32_t start : starts) {
+            if (start <= lastGlitchEnd) {
+                continue;
+            }
+            uint32_t width = randomBetween(10, noise.glitchMaxUs);
+            addEdge(trace, start, !level);
+            addEdge(trace, start + width, level);
+            lastGlitchEnd = start + width;
+        }
+
+        if (steadyEnd >= durationUs) {
+            break;
+        }
+        t = steadyEnd;
+        level = !level;
+        trace.truth.push_back({level, t});
+    }
+    // The last glitch can end after durationUs
+    trace.endUs = trace.edges.back().timestampUs > durationUs ? trace.edges.back().timestampUs : durationUs;
+    // The first entry only seeds the level
+    trace.edges.erase(trace.edges.begin());
+    return trace;
+}
+
+// Feed the trace with a drain every 1 ms, as readE3JKRR11() does
+static void runFilter(const BeamFilterConfig& config, const Trace& trace) {
+    transitions.clear();
+    BeamFilter filter(recordTransition);
+    filter.configure(config, false, 0);
+    size_t next = 0;
+    for (uint32_t now = 1000; now <= trace.endUs + 1000000; now += 1000) {
+        while (next < trace.edges.size() && trace.edges[next].timestampUs <= now) {
+            filter.processEdge(trace.edges[next].timestampUs, trace.edges[next].beamBroken);
+            next++;
+        }
+        filter.advance(now);
+    }
+}
+
+struct Score {
+    uint32_t trueChanges;
+    uint32_t falseRejects;  // Real changes never reported
+    uint32_t falseAccepts;  // Reported changes with no real change behind them
+    uint32_t maxSkewUs;     // Reported edge time minus the real change time
+};
+
+// A reported change matches a real change in the same direction if its
+// edge time falls within matchUs after it
+static Score score(const Trace& trace) {
+    const uint32_t matchUs = 20000;
+    Score result = {(uint32_t)trace.truth.size(), 0, 0, 0};
+    std::vector<bool> used(transitions.size(), false);
+    size_t searchFrom = 0;
+
+    for (const Transition& real : trace.truth) {
+        bool found = false;
+        for (size_t i = searchFrom; i < transitions.size(); i++) {
+            uint32_t t = transitions[i].timestampUs;
+            if (t + matchUs < real.timestampUs) {
+                searchFrom = i + 1;
+                continue;
+            }
+            if (t > real.timestampUs + matchUs) {
+                break;
+            }
+            if (!used[i] && transitions[i].beamBroken == real.beamBroken && t >= real.timestampUs) {
+                used[i] = true;
+                found = true;
+                if (t - real.timestampUs > result.maxSkewUs) {
+                    result.maxSkewUs = t - real.timestampUs;
+                }
+                break;
+            }
+        }
+        if (!found) {
+            result.falseRejects++;
+        }
+    }
+    for (size_t i = 0; i < used.size(); i++) {
+        if (!used[i]) {
+            result.falseAccepts++;
+        }
+    }
+    return result;
+}
+
+static const NoiseProfile cleanNoise = {"clean", 0, 0, 0, 0};
+static const NoiseProfile bounceNoise = {"bounce", 6, 3000, 0, 0};
+static const NoiseProfile emiNoise = {"bounce+emi", 6, 3000, 6, 2000};
+static const NoiseProfile heavyNoise = {"heavy", 12, 8000, 60, 8000};
+
+static const uint32_t traceUs = 3600UL * 1000000UL;  // One hour
+
+void setUp() {
+    transitions.clear();
+}
+
+void tearDown() {}
+
+void test_lockout_passes_clean_and_bouncy_edges() {
+    Trace trace = buildTrace(bounceNoise, traceUs, 1);
+    runFilter(lockoutConfig, trace);
+    Score result = score(trace);
+    TEST_ASSERT_EQUAL_UINT32(0, result.falseRejects);
+    TEST_ASSERT_EQUAL_UINT32(0, result.falseAccepts);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(bounceNoise.bounceSpanUs, result.maxSkewUs);
+}
+
+void test_integrator_and_majority_ignore_short_glitches() {
+    Trace trace = buildTrace(emiNoise, traceUs, 2);
+    runFilter(integratorConfig, trace);
+    TEST_ASSERT_EQUAL_UINT32(0, score(trace).falseAccepts);
+    runFilter(majorityConfig, trace);
+    TEST_ASSERT_EQUAL_UINT32(0, score(trace).falseAccepts);
+}
+
+// The glitch that ends within the lockout is applied at expiry, so the
+// output always settles on the raw level
+void test_every_mode_settles_on_the_raw_level() {
+    Trace trace = buildTrace(heavyNoise, traceUs, 3);
+    const BeamFilterConfig* configs[] = {&lockoutConfig, &integratorConfig, &majorityConfig};
+    for (const BeamFilterConfig* config : configs) {
+        runFilter(*config, trace);
+        TEST_ASSERT_FALSE(transitions.empty());
+        TEST_ASSERT_EQUAL(trace.edges.back().beamBroken, transitions.back().beamBroken);
+    }
+}
+
+void test_configure_clamps_majority_to_a_strict_majority() {
+    BeamFilter filter(nullptr);
+    BeamFilterConfig config = {BEAM_FILTER_MAJORITY, 0, 0, 0, 1, 200};
+    BeamFilterConfig applied = filter.configure(config, false, 0);
+    TEST_ASSERT_EQUAL_UINT32(BEAM_FILTER_MAX_WINDOW, applied.majorityM);
+    TEST_ASSERT_EQUAL_UINT32(BEAM_FILTER_MAX_WINDOW / 2 + 1, applied.majorityN);
+    TEST_ASSERT_EQUAL_UINT32(1, applied.sampleUs);
+}
+
+// Benchmark: false-accept/false-reject counts for each mode on an hour of
+// traffic per noise profile, and host cost per edge
+void test_bench_rates_and_cost() {
+    const NoiseProfile* profiles[] = {&cleanNoise, &bounceNoise, &emiNoise, &heavyNoise};
+    const BeamFilterConfig* configs[] = {&lockoutConfig, &integratorConfig, &majorityConfig};
+
+    printf("\n%-11s %-10s %7s %7s %6s %6s %9s\n", "noise", "mode", "edges", "changes", "FR", "FA",
+           "max skew");
+    for (const NoiseProfile* noise : profiles) {
+        Trace trace = buildTrace(*noise, traceUs, 42);
+        for (const BeamFilterConfig* config : configs) {
+            runFilter(*config, trace);
+            Score result = score(trace);
+            printf("%-11s %-10s %7lu %7lu %6lu %6lu %6.1fms\n", noise->name, BeamFilter::modeName(config->mode),
+                   (unsigned long)trace.edges.size(), (unsigned long)result.trueChanges,
+                   (unsigned long)result.falseRejects, (unsigned long)result.falseAccepts,
+                   result.maxSkewUs / 1000.0);
+        }
+    }
+
+    // Cost: one processEdge() per edge, advance() once per drain as on the
+    // device, over the heavy trace repeated until ~1M edges
+    Trace trace = buildTrace(heavyNoise, traceUs, 7);
+    printf("\n%-10s %12s %12s\n", "mode", "ns/edge", "ns/advance");
+    for (const BeamFilterConfig* config : configs) {
+        BeamFilter filter(nullptr);
+        filter.configure(*config, false, 0);
+        uint32_t rounds = 1000000 / trace.edges.size() + 1;
+        uint64_t edges = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t round = 0; round < rounds; round++) {
+            filter.configure(*config, false, 0);
+            for (const Edge& edge : trace.edges) {
+                filter.processEdge(edge.timestampUs, edge.beamBroken);
+            }
+            edges += trace.edges.size();
+        }
+        double edgeNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        uint32_t advances = 1000000;
+        start = std::chrono::steady_clock::now();
+        filter.configure(*config, false, 0);
+        for (uint32_t i = 1; i <= advances; i++) {
+            filter.advance(i * 1000);
+        }
+        double advanceNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        printf("%-10s %12.1f %12.1f\n", BeamFilter::modeName(config->mode), edgeNs / edges, advanceNs / advances);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_lockout_passes_clean_and_bouncy_edges);
+    RUN_TEST(test_integrator_and_majority_ignore_short_glitches);
+    RUN_TEST(test_every_mode_settles_on_the_raw_level);
+    RUN_TEST(test_configure_clamps_majority_to_a_strict_majority);
+    RUN_TEST(test_bench_rates_and_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,174 @@
+#include <unity.h>
+#include <stdlib.h>
+#include "dht22_decoder.h"
+
+// Pulse trains in the DHT22Driver capture format: micros() at each edge and
+// the line level after it, starting when the host releases the line.
+// Timings follow the AM2302 datasheet; jitter stands in for ISR latency.
+struct PulseTrain {
+    uint32_t times[DHT22_MAX_EDGES];
+    bool levels[DHT22_MAX_EDGES];
+    size_t count;
+    uint32_t nowUs;
+};
+
+static uint32_t jitterUs;   // Up to this much latency added per edge
+
+static void addEdge(PulseTrain& train, uint32_t afterUs, bool level) {
+    train.nowUs += afterUs;
+    if (train.count < DHT22_MAX_EDGES) {
+        uint32_t latency = jitterUs ? (uint32_t)(rand() % (jitterUs + 1)) : 0;
+        train.times[train.count] = train.nowUs + latency;
+        train.levels[train.count] = level;
+        train.count++;
+    }
+}
+
+// zeroHighUs/oneHighUs/lowUs let a test move the bit timings to the limits
+static void buildTrain(PulseTrain& train, const uint8_t bytes[5], uint32_t startUs, bool captureRelease,
+                       uint32_t zeroHighUs = 26, uint32_t oneHighUs = 70, uint32_t lowUs = 50) {
+    train.count = 0;
+    train.nowUs = startUs;
+    if (captureRelease) {
+        addEdge(train, 0, true);        // Pull-up takes the line high
+    }
+    addEdge(train, 30, false);          // Sensor response: 80us low
+    addEdge(train, 80, true);           // 80us high
+    addEdge(train, 80, false);
+    for (int bit = 0; bit < DHT22_FRAME_BITS; bit++) {
+        bool one = bytes[bit / 8] & (0x80 >> (bit % 8));
+        addEdge(train, lowUs, true);
+        addEdge(train, one ? oneHighUs : zeroHighUs, false);
+    }
+    addEdge(train, 50, true);           // Trailer, then the line is released
+}
+
+static Dht22DecodeResult decode(const PulseTrain& train, Dht22Reading& reading) {
+    return dht22DecodeEdges(train.times, train.levels, train.count, reading);
+}
+
+// Datasheet examples: 65.2 %RH / 35.1 C and -10.1 C
+static const uint8_t examplePositive[5] = {0x02, 0x8C, 0x01, 0x5F, 0xEE};
+static const uint8_t exampleNegative[5] = {0x02, 0x8C, 0x80, 0x65, 0x73};
+
+void setUp() {
+    jitterUs = 0;
+    srand(1);
+}
+
+void tearDown() {}
+
+void test_decode_bytes_datasheet_examples() {
+    Dht22Reading reading;
+    TEST_ASSERT_TRUE(dht22DecodeBytes(examplePositive, reading));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 65.2, reading.humidity);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 35.1, reading.temperature);
+
+    TEST_ASSERT_TRUE(dht22DecodeBytes(exampleNegative, reading));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, -10.1, reading.temperature);
+}
+
+void test_decode_train_with_and_without_release_edge() {
+    PulseTrain train;
+    Dht22Reading reading;
+    buildTrain(train, examplePositive, 1000, true);
+    TEST_ASSERT_EQUAL(DHT22_DECODE_OK, decode(train, reading));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 35.1, reading.temperature);
+
+    buildTrain(train, exampleNegative, 1000, false);
+    TEST_ASSERT_EQUAL(DHT22_DECODE_OK, decode(train, reading));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, -10.1, reading.temperature);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 65.2, reading.humidity);
+}
+
+// micros() wraps every ~71.6 minutes; a frame can straddle the wrap
+void test_decode_train_across_micros_wrap() {
+    PulseTrain train;
+    Dht22Reading reading;
+    buildTrain(train, examplePositive, 0xFFFFFFFFUL - 2000, true);
+    TEST_ASSERT_TRUE(train.times[train.count - 1] < train.times[0]);
+    TEST_ASSERT_EQUAL(DHT22_DECODE_OK, decode(train, reading));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 65.2, reading.humidity);
+}
+
+// Datasheet limits: '0' high 22-30us, '1' high 68-75us, bit low 48-55us
+void test_decode_train_at_timing_limits() {
+    PulseTrain train;
+    Dht22Reading reading;
+    buildTrain(train, examplePositive, 0, true, 22, 68, 48);
+    TEST_ASSERT_EQUAL(DHT22_DECODE_OK, decode(train, reading));
+    buildTrain(train, examplePositive, 0, true, 30, 75, 55);
+    TEST_ASSERT_EQUAL(DHT22_DECODE_OK, decode(train, reading));
+}
+
+// Random frames with up to 10us of latency on every edge all decode
+void test_decode_random_frames_with_isr_jitter() {
+    jitterUs = 10;
+    PulseTrain train;
+    Dht22Reading reading;
+    for (int i = 0; i < 10000; i++) {
+        uint8_t bytes[5];
+        for (int b = 0; b < 4; b++) {
+            bytes[b] = (uint8_t)rand();
+        }
+        bytes[4] = (uint8_t)(bytes[0] + bytes[1] + bytes[2] + bytes[3]);
+        buildTrain(train, bytes, (uint32_t)rand(), (i & 1) != 0);
+        TEST_ASSERT_EQUAL(DHT22_DECODE_OK, decode(train, reading));
+    }
+}
+
+void test_no_response_is_too_few_edges() {
+    PulseTrain train;
+    Dht22Reading reading;
+    buildTrain(train, examplePositive, 0, true);
+    train.count = 40;   // Capture window closed mid-frame
+    TEST_ASSERT_EQUAL(DHT22_DECODE_TOO_FEW_EDGES, decode(train, reading));
+    train.count = 0;
+    TEST_ASSERT_EQUAL(DHT22_DECODE_TOO_FEW_EDGES, decode(train, reading));
+}
+
+void test_corrupted_bit_fails_checksum() {
+    PulseTrain train;
+    Dht22Reading reading;
+    buildTrain(train, examplePositive, 0, true);
+    // Stretch the high pulse of the first data bit from '0' to '1'
+    size_t firstBitFall = 5;  // After release, response and bit 0 rise
+    TEST_ASSERT_FALSE(train.levels[firstBitFall]);
+    train.times[firstBitFall] += 44;
+    TEST_ASSERT_EQUAL(DHT22_DECODE_CHECKSUM, decode(train, reading));
+}
+
+void test_missed_edge_is_rejected() {
+    PulseTrain train;
+    Dht22Reading reading;
+    buildTrain(train, examplePositive, 0, true);
+    // Drop one falling and the next rising edge: two bits merge into one
+    // long pulse and the frame is a bit short
+    for (size_t i = 21; i + 2 < train.count; i++) {
+        train.times[i] = train.times[i + 2];
+        train.levels[i] = train.levels[i + 2];
+    }
+    train.count -= 2;
+    TEST_ASSERT_NOT_EQUAL(DHT22_DECODE_OK, decode(train, reading));
+}
+
+void test_stuck_high_line_is_bad_pulse() {
+    PulseTrain train;
+    Dht22Reading reading;
+    buildTrain(train, examplePositive, 0, true, 26, 150);
+    TEST_ASSERT_EQUAL(DHT22_DECODE_BAD_PULSE, decode(train, reading));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_decode_bytes_datasheet_examples);
+    RUN_TEST(test_decode_train_with_and_without_release_edge);
+    RUN_TEST(test_decode_train_across_micros_wrap);
+    RUN_TEST(test_decode_train_at_timing_limits);
+    RUN_TEST(test_decode_random_frames_with_isr_jitter);
+    RUN_TEST(test_no_response_is_too_few_edges);
+    RUN_TEST(test_corrupted_bit_fails_checksum);
+    RUN_TEST(test_missed_edge_is_rejected);
+    RUN_TEST(test_stuck_high_line_is_bad_pulse);
+    return UNITY_END();
+}
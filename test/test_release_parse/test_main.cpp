@@ -0,0 +1,237 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <ArduinoJson.h>
+
+// The releases/latest body as tools/ota_release_fixture.py serves it with
+// its defaults: 32 KB of release notes and nine assets with full uploader
+// metadata, about 43 KB in all
+#define NOTES_KB 32
+#define BASE_URL "http://example.invalid"
+#define TAG "v9.9.9"
+
+static const char* const assetNames[] = {
+    "firmware.bin", "firmware.bin.sha256", "firmware.bin.gz", "firmware.bin.gz.sha256", "firmware.elf",
+    "bootloader.bin", "partitions.bin", "spiffs.bin", "Source code (zip)",
+};
+static const size_t ASSET_COUNT = sizeof(assetNames) / sizeof(assetNames[0]);
+
+// Counts the heap a document holds, as the device logs it from
+// ESP.getFreeHeap() around the parse
+class CountingAllocator : public ArduinoJson::Allocator {
+public:
+    size_t current = 0;
+    size_t peak = 0;
+
+    void* allocate(size_t size) override {
+        size_t* block = static_cast<size_t*>(malloc(size + sizeof(size_t)));
+        if (block == nullptr) {
+            return nullptr;
+        }
+        *block = size;
+        add(size);
+        return block + 1;
+    }
+
+    void deallocate(void* pointer) override {
+        if (pointer != nullptr) {
+            size_t* block = static_cast<size_t*>(pointer) - 1;
+            current -= *block;
+            free(block);
+        }
+    }
+
+    void* reallocate(void* pointer, size_t size) override {
+        size_t* block = static_cast<size_t*>(pointer) - 1;
+        current -= *block;
+        block = static_cast<size_t*>(realloc(block, size + sizeof(size_t)));
+        if (block == nullptr) {
+            return nullptr;
+        }
+        *block = size;
+        add(size);
+        return block + 1;
+    }
+
+private:
+    void add(size_t size) {
+        current += size;
+        if (current > peak) {
+            peak = current;
+        }
+    }
+};
+
+static void addUser(JsonObject user, const char* login) {
+    std::string url = std::string("https://api.github.com/users/") + login;
+    user["login"] = login;
+    user["id"] = 1234567;
+    user["node_id"] = "MDQ6VXNlcjEyMzQ1Njc=";
+    user["avatar_url"] = "https://avatars.githubusercontent.com/u/1234567?v=4";
+    user["gravatar_id"] = "";
+    user["url"] = url;
+    user["html_url"] = std::string("https://github.com/") + login;
+    user["followers_url"] = url + "/followers";
+    user["repos_url"] = url + "/repos";
+    user["type"] = "User";
+    user["site_admin"] = false;
+}
+
+static std::string releaseJson;
+
+static void buildRelease() {
+    JsonDocument release;
+    release["url"] = "https://api.github.com/repos/example/releases/1";
+    release["html_url"] = "https://github.com/example/releases/tag/" TAG;
+    release["id"] = 1;
+    addUser(release["author"].to<JsonObject>(), "maintainer");
+    release["tag_name"] = TAG;
+    release["target_commitish"] = "main";
+    release["name"] = TAG;
+    release["draft"] = false;
+    release["prerelease"] = false;
+    release["created_at"] = "2025-01-01T00:00:00Z";
+    release["published_at"] = "2025-01-01T00:00:00Z";
+
+    JsonArray assets = release["assets"].to<JsonArray>();
+    for (size_t i = 0; i < ASSET_COUNT; i++) {
+        JsonObject asset = assets.add<JsonObject>();
+        asset["url"] = "https://api.github.com/repos/example/releases/assets/" + std::to_string(1000 + i);
+        asset["id"] = 1000 + i;
+        char nodeId[24];
+        snprintf(nodeId, sizeof(nodeId), "RA_kwDOJ%08u", (unsigned)i);
+        asset["node_id"] = nodeId;
+        asset["name"] = assetNames[i];
+        asset["label"] = "";
+        addUser(asset["uploader"].to<JsonObject>(), "release-bot");
+        asset["content_type"] = "application/octet-stream";
+        asset["state"] = "uploaded";
+        asset["size"] = 1048576 + i;
+        asset["download_count"] = 42;
+        asset["created_at"] = "2025-01-01T00:00:00Z";
+        asset["updated_at"] = "2025-01-01T00:00:00Z";
+        asset["browser_download_url"] = std::string(BASE_URL "/download/" TAG "/") + assetNames[i];
+    }
+
+    std::string line = "- Fixed an issue where the beam sensor reported a stale state after reconnecting\n";
+    std::string notes = "## Changes\n";
+    for (size_t i = 0; i < NOTES_KB * 1024 / line.size(); i++) {
+        notes += line;
+    }
+    release["body"] = notes;
+
+    releaseJson.clear();
+    serializeJson(release, releaseJson);
+}
+
+// Keep in step with the filter in OTAManager::checkForUpdate()
+static void buildFilter(JsonDocument& filter) {
+    filter["tag_name"] = true;
+    filter["assets"][0]["name"] = true;
+    filter["assets"][0]["browser_download_url"] = true;
+}
+
+// The device parses straight from the HTTP stream, so the host does too
+static DeserializationError parse(JsonDocument& doc, bool filtered) {
+    std::istringstream stream(releaseJson);
+    if (!filtered) {
+        return deserializeJson(doc, stream);
+    }
+    JsonDocument filter;
+    buildFilter(filter);
+    return deserializeJson(doc, stream, DeserializationOption::Filter(filter));
+}
+
+void setUp() {
+    if (releaseJson.empty()) {
+        buildRelease();
+    }
+}
+
+void tearDown() {}
+
+void test_release_is_fixture_sized() {
+    TEST_ASSERT_GREATER_THAN(40 * 1024, releaseJson.size());
+    TEST_ASSERT_LESS_THAN(48 * 1024, releaseJson.size());
+}
+
+// Only the tag and each asset's name and URL survive, in asset order
+void test_filter_keeps_only_the_fields_used() {
+    JsonDocument doc;
+    TEST_ASSERT_EQUAL(DeserializationError::Ok, parse(doc, true).code());
+    TEST_ASSERT_EQUAL_STRING(TAG, doc["tag_name"].as<const char*>());
+    TEST_ASSERT_TRUE(doc["body"].isNull());
+    TEST_ASSERT_TRUE(doc["author"].isNull());
+
+    JsonArray assets = doc["assets"];
+    TEST_ASSERT_EQUAL(ASSET_COUNT, assets.size());
+    for (size_t i = 0; i < ASSET_COUNT; i++) {
+        JsonObject asset = assets[i];
+        TEST_ASSERT_EQUAL(2, asset.size());
+        TEST_ASSERT_EQUAL_STRING(assetNames[i], asset["name"].as<const char*>());
+        std::string url = std::string(BASE_URL "/download/" TAG "/") + assetNames[i];
+        TEST_ASSERT_EQUAL_STRING(url.c_str(), asset["browser_download_url"].as<const char*>());
+    }
+}
+
+// What the document retains after the parse, filtered and not. The
+// filtered document has to stay a small fraction of the body on the
+// device's heap.
+void test_filtered_document_retains_a_fraction_of_the_body() {
+    CountingAllocator filteredHeap;
+    CountingAllocator fullHeap;
+    {
+        JsonDocument filtered(&filteredHeap);
+        JsonDocument full(&fullHeap);
+        TEST_ASSERT_EQUAL(DeserializationError::Ok, parse(filtered, true).code());
+        TEST_ASSERT_EQUAL(DeserializationError::Ok, parse(full, false).code());
+        size_t filteredBytes = filteredHeap.current;
+        size_t fullBytes = fullHeap.current;
+
+        printf("\n%-10s %10s %12s %12s\n", "parse", "body", "retained", "peak");
+        printf("%-10s %10lu %12lu %12lu\n", "filtered", (unsigned long)releaseJson.size(),
+               (unsigned long)filteredBytes, (unsigned long)filteredHeap.peak);
+        printf("%-10s %10lu %12lu %12lu\n", "full", (unsigned long)releaseJson.size(),
+               (unsigned long)fullBytes, (unsigned long)fullHeap.peak);
+
+        TEST_ASSERT_LESS_THAN(4096, filteredBytes);
+        TEST_ASSERT_LESS_THAN(releaseJson.size() / 10, filteredBytes);
+        TEST_ASSERT_GREATER_THAN(filteredBytes * 10, fullBytes);
+    }
+    TEST_ASSERT_EQUAL(0, filteredHeap.current);
+    TEST_ASSERT_EQUAL(0, fullHeap.current);
+}
+
+// Benchmark: best of RUNS parses each way. On the device the stream is
+// read as the bytes arrive, so this is the CPU share of a release check.
+void test_bench_parse_time() {
+    const int RUNS = 200;
+    double best[2] = {1e30, 1e30};
+    for (int run = 0; run < RUNS; run++) {
+        for (int filtered = 0; filtered < 2; filtered++) {
+            JsonDocument doc;
+            auto start = std::chrono::steady_clock::now();
+            DeserializationError error = parse(doc, filtered == 1);
+            double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            TEST_ASSERT_EQUAL(DeserializationError::Ok, error.code());
+            if (us < best[filtered]) {
+                best[filtered] = us;
+            }
+        }
+    }
+    printf("\n%-10s %10s %10s\n", "parse", "best us", "MB/s");
+    printf("%-10s %10.1f %10.1f\n", "filtered", best[1], releaseJson.size() / best[1]);
+    printf("%-10s %10.1f %10.1f\n", "full", best[0], releaseJson.size() / best[0]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_release_is_fixture_sized);
+    RUN_TEST(test_filter_keeps_only_the_fields_used);
+    RUN_TEST(test_filtered_document_retains_a_fraction_of_the_body);
+    RUN_TEST(test_bench_parse_time);
+    return UNITY_END();
+}
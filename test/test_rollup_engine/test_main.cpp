@@ -0,0 +1,130 @@
+#include <unity.h>
+#include <vector>
+#include "rollup_engine.h"
+#include "history_batches.h"
+
+static uint8_t* memory;
+static RollupEngine* rollups;
+
+void setUp() {
+    memory = new uint8_t[RollupEngine::requiredBytes()];
+    rollups = new RollupEngine();
+    TEST_ASSERT_TRUE(rollups->begin(memory, RollupEngine::requiredBytes()));
+}
+
+void tearDown() {
+    delete rollups;
+    delete[] memory;
+}
+
+// One temperature reading every 10 s from startTime for 'count' readings
+static void addReadings(uint32_t startTime, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        rollups->addSample(ROLLUP_TEMPERATURE, startTime + i * 10, 20.0f + (i % 7));
+    }
+}
+
+static bool collectBucket(const RollupBucket& bucket, void* context) {
+    static_cast<std::vector<RollupBucket>*>(context)->push_back(bucket);
+    return true;
+}
+
+// Page through [from, to] the way streamRollupJSON() does
+static std::vector<RollupBucket> pagedQuery(RollupResolution resolution, uint32_t from, uint32_t to) {
+    std::vector<RollupBucket> buckets;
+    forEachHistoryBatch<RollupBucket>(from, RollupEngine::widthSeconds(resolution),
+                                      [resolution, to](uint32_t start, RollupVisitor visitor, void* batch) {
+        rollups->query(resolution, start, to, visitor, batch);
+    }, collectBucket, &buckets);
+    return buckets;
+}
+
+void test_buckets_aggregate_min_max_mean() {
+    addReadings(600, 6);  // 20..25 C in one minute
+    std::vector<RollupBucket> buckets;
+    TEST_ASSERT_EQUAL_UINT32(1, rollups->query(ROLLUP_MINUTE, 600, 659, collectBucket, &buckets));
+    const RollupAggregate& temperature = buckets[0].series[ROLLUP_TEMPERATURE];
+    TEST_ASSERT_EQUAL_UINT32(6, temperature.count);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 20.0, temperature.min);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 25.0, temperature.max);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 22.5, temperature.mean());
+    TEST_ASSERT_EQUAL_UINT32(0, buckets[0].series[ROLLUP_HUMIDITY].count);
+}
+
+// 'from' inside a bucket still returns that bucket
+void test_query_rounds_from_down_to_its_bucket() {
+    addReadings(600, 12);
+    std::vector<RollupBucket> buckets;
+    TEST_ASSERT_EQUAL_UINT32(2, rollups->query(ROLLUP_MINUTE, 630, 700, collectBucket, &buckets));
+    TEST_ASSERT_EQUAL_UINT32(600, buckets[0].start);
+    TEST_ASSERT_EQUAL_UINT32(660, buckets[1].start);
+}
+
+// Regression: resuming each batch at the last start + 1 s returned the
+// boundary bucket again, so 100 buckets came out as 103
+void test_paged_query_returns_each_bucket_once() {
+    const uint32_t start = 3600;
+    addReadings(start, 100 * 6);  // 100 minutes
+    std::vector<RollupBucket> buckets = pagedQuery(ROLLUP_MINUTE, start, start + 100 * 60 - 1);
+
+    TEST_ASSERT_EQUAL_UINT32(100, buckets.size());
+    for (size_t i = 0; i < buckets.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(start + i * 60, buckets[i].start);
+        TEST_ASSERT_EQUAL_UINT32(6, buckets[i].series[ROLLUP_TEMPERATURE].count);
+    }
+}
+
+// Exactly a whole number of batches, with 'from' mid-bucket
+void test_paged_query_on_batch_boundary() {
+    addReadings(0, 2 * HISTORY_BATCH_ITEMS * 6);
+    std::vector<RollupBucket> buckets = pagedQuery(ROLLUP_MINUTE, 30, rollups->getNewestTimestamp());
+    TEST_ASSERT_EQUAL_UINT32(2 * HISTORY_BATCH_ITEMS, buckets.size());
+    TEST_ASSERT_EQUAL_UINT32(0, buckets.front().start);
+    TEST_ASSERT_EQUAL_UINT32((2 * HISTORY_BATCH_ITEMS - 1) * 60, buckets.back().start);
+}
+
+// Raw samples page by one second and are not rounded
+void test_paged_samples_resume_after_the_last_timestamp() {
+    uint8_t* storeMemory = new uint8_t[8192];
+    TimeSeriesStore store;
+    TEST_ASSERT_TRUE(store.begin(storeMemory, 8192));
+    TimeSeriesSample sample = {0, {21.0f, 45.0f}};
+    for (uint32_t i = 0; i < 100; i++) {
+        sample.timestamp = 1000 + i * 10;
+        TEST_ASSERT_TRUE(store.append(sample));
+    }
+
+    std::vector<uint32_t> times;
+    uint32_t total = forEachHistoryBatch<TimeSeriesSample>(0, 1, [&store](uint32_t start, TimeSeriesVisitor visitor,
+                                                                        void* batch) {
+        store.query(start, 0xFFFFFFFFUL, visitor, batch);
+    }, [](const TimeSeriesSample& item, void* context) {
+        static_cast<std::vector<uint32_t>*>(context)->push_back(item.timestamp);
+        return true;
+    }, &times);
+
+    TEST_ASSERT_EQUAL_UINT32(100, total);
+    for (uint32_t i = 0; i < times.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(1000 + i * 10, times[i]);
+    }
+    delete[] storeMemory;
+}
+
+void test_old_periods_are_evicted_from_the_ring() {
+    addReadings(0, (ROLLUP_MINUTE_SLOTS + 10) * 6);
+    std::vector<RollupBucket> buckets;
+    rollups->query(ROLLUP_MINUTE, 0, rollups->getNewestTimestamp(), collectBucket, &buckets);
+    TEST_ASSERT_EQUAL_UINT32(ROLLUP_MINUTE_SLOTS, buckets.size());
+    TEST_ASSERT_EQUAL_UINT32(10 * 60, buckets.front().start);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_buckets_aggregate_min_max_mean);
+    RUN_TEST(test_query_rounds_from_down_to_its_bucket);
+    RUN_TEST(test_paged_query_returns_each_bucket_once);
+    RUN_TEST(test_paged_query_on_batch_boundary);
+    RUN_TEST(test_paged_samples_resume_after_the_last_timestamp);
+    RUN_TEST(test_old_periods_are_evicted_from_the_ring);
+    return UNITY_END();
+}
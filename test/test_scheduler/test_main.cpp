@@ -0,0 +1,177 @@
+#include <unity.h>
+#include <stdio.h>
+#include "scheduler.h"
+
+// Virtual clock: time only moves when a job "works" or the scheduler sleeps,
+// so every run of the same schedule gives the same numbers
+static uint32_t virtualNowUs;
+static bool tickSleep;      // delay() in whole 1 ms FreeRTOS ticks, like main.cpp
+
+static uint32_t virtualClock() {
+    return virtualNowUs;
+}
+
+// vTaskDelay(n) wakes on the n-th tick interrupt from now
+static void virtualSleep(uint32_t us) {
+    if (tickSleep) {
+        virtualNowUs = (virtualNowUs / 1000 + (us + 999) / 1000) * 1000;
+    } else {
+        virtualNowUs += us;
+    }
+}
+
+// Job costs for the device schedule, roughly what the jobs take on the ESP32
+static uint32_t slowJobUs;
+static void beamJob() { virtualNowUs += 15; }
+static void dhtJob() { virtualNowUs += 5; }
+static void historyJob() { virtualNowUs += 400; }
+static void wifiJob() { virtualNowUs += 10; }
+static void slowJob() { virtualNowUs += slowJobUs; }
+static void idleJob() {}
+
+static Scheduler* scheduler;
+
+void setUp() {
+    virtualNowUs = 0;
+    tickSleep = false;
+    slowJobUs = 0;
+    scheduler = new Scheduler(virtualClock, virtualSleep);
+}
+
+void tearDown() {
+    delete scheduler;
+}
+
+static void runFor(uint32_t durationUs) {
+    uint32_t endUs = virtualNowUs + durationUs;
+    while ((int32_t)(virtualNowUs - endUs) <= 0) {
+        scheduler->runOnce();
+    }
+}
+
+// The jobs main.cpp registers, at their config.h periods
+static void addDeviceJobs() {
+    scheduler->addJob("beam", beamJob, 1000);
+    scheduler->addJob("dht22", dhtJob, 1000);
+    scheduler->addJob("history", historyJob, 10000000);
+    scheduler->addJob("wifi", wifiJob, 100000);
+}
+
+static void printStats(const char* title, uint32_t durationUs) {
+    printf("\n%s (%lu s virtual)\n", title, (unsigned long)(durationUs / 1000000));
+    printf("  %-8s %8s %9s %11s %11s %8s\n", "job", "runs", "overruns", "jitter avg", "jitter max", "run max");
+    for (int i = 0; i < scheduler->getJobCount(); i++) {
+        const SchedulerJob* job = scheduler->getJob(i);
+        const SchedulerJobStats& stats = job->stats;
+        printf("  %-8s %8lu %9lu %9.1fus %9luus %6luus\n", job->name, (unsigned long)stats.runs,
+               (unsigned long)stats.overruns, stats.runs ? (double)stats.totalJitterUs / stats.runs : 0.0,
+               (unsigned long)stats.maxJitterUs, (unsigned long)stats.maxRunUs);
+    }
+    printf("  passes %lu, asleep %.1f%%\n", (unsigned long)scheduler->getPassCount(),
+           100.0 * scheduler->getTotalSleepUs() / durationUs);
+}
+
+void test_jobs_first_run_one_period_after_registration() {
+    virtualNowUs = 5000;
+    scheduler->addJob("a", idleJob, 1000);
+    TEST_ASSERT_EQUAL_UINT32(1000, scheduler->timeUntilNextDeadline());
+    scheduler->runOnce();
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler->getJob(0)->stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(6000, virtualNowUs);
+    scheduler->runOnce();
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler->getJob(0)->stats.runs);
+}
+
+void test_free_jobs_run_on_grid_without_jitter() {
+    scheduler->addJob("fast", idleJob, 1000);
+    scheduler->addJob("slow", idleJob, 30000);
+    runFor(3000000);
+    TEST_ASSERT_EQUAL_UINT32(3000, scheduler->getJob(0)->stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(100, scheduler->getJob(1)->stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler->getJob(0)->stats.maxJitterUs);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler->getJob(0)->stats.overruns);
+    TEST_ASSERT_EQUAL_UINT64(virtualNowUs, scheduler->getTotalSleepUs());
+}
+
+void test_continuous_job_runs_every_pass() {
+    scheduler->addJob("web", idleJob, 0);
+    scheduler->addJob("beam", idleJob, 1000);
+    runFor(100000);
+    TEST_ASSERT_EQUAL_UINT32(scheduler->getPassCount(), scheduler->getJob(0)->stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(100, scheduler->getJob(1)->stats.runs);
+}
+
+// A 3.5 ms job every 100 ms holds up the 1 ms job across three deadlines:
+// it runs once, late, the two deadlines it missed entirely count as
+// overruns, and the grid does not drift
+void test_slow_job_counts_overruns_without_drift() {
+    slowJobUs = 3500;
+    scheduler->addJob("beam", idleJob, 1000);
+    scheduler->addJob("slow", slowJob, 100000);
+    runFor(1050000);
+
+    const SchedulerJob* beam = scheduler->getJob(0);
+    TEST_ASSERT_EQUAL_UINT32(10, scheduler->getJob(1)->stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(20, beam->stats.overruns);
+    TEST_ASSERT_EQUAL_UINT32(1050 - 20, beam->stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(2500, beam->stats.maxJitterUs);
+    TEST_ASSERT_EQUAL_UINT32(0, beam->nextDueUs % 1000);
+}
+
+void test_deadline_wraps_with_the_32_bit_clock() {
+    virtualNowUs = 0xFFFFFFFFUL - 2500;
+    scheduler->addJob("beam", idleJob, 1000);
+    runFor(10000);
+    TEST_ASSERT_EQUAL_UINT32(10, scheduler->getJob(0)->stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler->getJob(0)->stats.overruns);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler->getJob(0)->stats.maxJitterUs);
+}
+
+// Benchmark: the device schedule for one virtual minute, with sleeps
+// rounded to whole ticks as on the ESP32
+void test_bench_device_schedule() {
+    const uint32_t durationUs = 60000000;
+    tickSleep = true;
+    addDeviceJobs();
+    runFor(durationUs);
+    printStats("Device schedule, tick-rounded sleep", durationUs);
+
+    const SchedulerJob* beam = scheduler->getJob(0);
+    TEST_ASSERT_EQUAL_UINT32(0, beam->stats.overruns);
+    TEST_ASSERT_LESS_THAN_UINT32(1000, beam->stats.maxJitterUs);
+    TEST_ASSERT_EQUAL_UINT32(6, scheduler->getJob(2)->stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(600, scheduler->getJob(3)->stats.runs);
+}
+
+// Same schedule twice gives identical statistics
+void test_bench_is_deterministic() {
+    addDeviceJobs();
+    runFor(10000000);
+    SchedulerJobStats first = scheduler->getJob(0)->stats;
+    uint32_t firstPasses = scheduler->getPassCount();
+
+    delete scheduler;
+    virtualNowUs = 0;
+    scheduler = new Scheduler(virtualClock, virtualSleep);
+    addDeviceJobs();
+    runFor(10000000);
+    const SchedulerJobStats& second = scheduler->getJob(0)->stats;
+
+    TEST_ASSERT_EQUAL_UINT32(firstPasses, scheduler->getPassCount());
+    TEST_ASSERT_EQUAL_UINT32(first.runs, second.runs);
+    TEST_ASSERT_EQUAL_UINT64(first.totalJitterUs, second.totalJitterUs);
+    TEST_ASSERT_EQUAL_UINT32(first.maxJitterUs, second.maxJitterUs);
+    printStats("Device schedule, exact sleep", 10000000);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_jobs_first_run_one_period_after_registration);
+    RUN_TEST(test_free_jobs_run_on_grid_without_jitter);
+    RUN_TEST(test_continuous_job_runs_every_pass);
+    RUN_TEST(test_slow_job_counts_overruns_without_drift);
+    RUN_TEST(test_deadline_wraps_with_the_32_bit_clock);
+    RUN_TEST(test_bench_device_schedule);
+    RUN_TEST(test_bench_is_deterministic);
+    return UNITY_END();
+}
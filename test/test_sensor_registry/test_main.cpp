@@ -0,0 +1,283 @@
+#include <unity.h>
+#include <stdio.h>
+#include <time.h>
+#include <string>
+#include "sensor_registry.h"
+#include "beam_filter.h"
+#include "dht22_decoder.h"
+
+// config.h is Arduino-only; keep in step
+#define BEAM_DRAIN_INTERVAL_US 1000
+#define DHT22_POLL_INTERVAL_US 1000
+#define ENV_SENSOR_READ_INTERVAL 2000
+
+// Mock sensor types with the same shape as those in sensors.cpp. Their
+// sample() does the host-side part of the real work: the beam drains
+// scripted edges through a BeamFilter, the DHT22 decodes a captured frame
+// every ENV_SENSOR_READ_INTERVAL, the analog input averages readings.
+static uint32_t virtualNowUs;
+static std::string callLog;
+
+static void logCall(const char* name, const char* what) {
+    callLog += name;
+    callLog += ':';
+    callLog += what;
+    callLog += ' ';
+}
+
+static bool logging;
+
+// A car every 5 s that bounces for 2 ms on the way in and out
+static uint32_t beamTransitions;
+static void onBeamChange(bool, uint32_t) {
+    beamTransitions++;
+}
+static BeamFilter beamFilter(onBeamChange);
+static const BeamFilterConfig beamConfig = {BEAM_FILTER_LOCKOUT, 50000, 0, 0, 0, 0};
+
+struct MockBeam {
+    static const char* name() { return "beam"; }
+    static constexpr uint32_t periodUs() { return BEAM_DRAIN_INTERVAL_US; }
+    static void init() {
+        if (logging) logCall(name(), "init");
+        beamFilter.configure(beamConfig, false, virtualNowUs);
+    }
+    static void sample() {
+        if (logging) logCall(name(), "sample");
+        uint32_t phaseUs = virtualNowUs % 5000000;
+        if (phaseUs < 2000 || (phaseUs >= 2500000 && phaseUs < 2502000)) {
+            // Edge queue drain: each bounce is an edge
+            bool broken = phaseUs < 2500000;
+            beamFilter.processEdge(virtualNowUs, broken);
+            beamFilter.processEdge(virtualNowUs + 300, !broken);
+            beamFilter.processEdge(virtualNowUs + 600, broken);
+        }
+        beamFilter.advance(virtualNowUs);
+    }
+};
+
+// A DHT22 frame captured at 23.4 C / 41.5 %RH (see test_dht22_decoder)
+static uint32_t frameTimes[DHT22_MAX_EDGES];
+static bool frameLevels[DHT22_MAX_EDGES];
+static size_t frameEdges;
+static uint32_t dhtReadings;
+static uint32_t dhtNextReadUs;
+static float lastTemperature;
+
+static void captureFrame(const uint8_t bytes[5]) {
+    uint32_t t = 0;
+    frameEdges = 0;
+    const uint32_t response[] = {30, 80, 80};
+    for (int i = 0; i < 3; i++) {
+        t += response[i];
+        frameTimes[frameEdges] = t;
+        frameLevels[frameEdges++] = i % 2 == 1;
+    }
+    for (int bit = 0; bit < DHT22_FRAME_BITS; bit++) {
+        bool one = bytes[bit / 8] & (0x80 >> (bit % 8));
+        t += 50;
+        frameTimes[frameEdges] = t;
+        frameLevels[frameEdges++] = true;
+        t += one ? 70 : 26;
+        frameTimes[frameEdges] = t;
+        frameLevels[frameEdges++] = false;
+    }
+    frameTimes[frameEdges] = t + 50;
+    frameLevels[frameEdges++] = true;
+}
+
+struct MockDht22 {
+    static const char* name() { return "dht22"; }
+    static constexpr uint32_t periodUs() { return DHT22_POLL_INTERVAL_US; }
+    static void init() {
+        if (logging) logCall(name(), "init");
+        dhtNextReadUs = virtualNowUs;
+    }
+    static void sample() {
+        if (logging) logCall(name(), "sample");
+        if ((int32_t)(virtualNowUs - dhtNextReadUs) < 0) {
+            return;
+        }
+        dhtNextReadUs += ENV_SENSOR_READ_INTERVAL * 1000UL;
+        Dht22Reading reading;
+        if (dht22DecodeEdges(frameTimes, frameLevels, frameEdges, reading) == DHT22_DECODE_OK) {
+            lastTemperature = reading.temperature;
+            dhtReadings++;
+        }
+    }
+};
+
+static uint32_t analogSum;
+static uint32_t analogReadings;
+
+struct MockAnalog {
+    static const char* name() { return "analog"; }
+    static constexpr uint32_t periodUs() { return ENV_SENSOR_READ_INTERVAL * 1000UL; }
+    static void init() {
+        if (logging) logCall(name(), "init");
+    }
+    static void sample() {
+        if (logging) logCall(name(), "sample");
+        analogSum += (virtualNowUs >> 10) & 0x0FFF;     // 12-bit ADC stand-in
+        analogReadings++;
+    }
+};
+
+// The device list with two sensors compiled out
+typedef SensorRegistry<MockBeam, DisabledSensor, MockDht22, DisabledSensor, MockAnalog> MockSensors;
+
+// The runtime-dispatch design the registry replaced, for comparison
+struct SensorBase {
+    virtual ~SensorBase() {}
+    virtual void sample() = 0;
+};
+
+template <typename Sensor>
+struct VirtualSensor : SensorBase {
+    void sample() override { Sensor::sample(); }
+};
+
+static uint32_t virtualClock() {
+    return virtualNowUs;
+}
+
+static void virtualSleep(uint32_t us) {
+    virtualNowUs += us;
+}
+
+static void resetMocks() {
+    virtualNowUs = 0;
+    callLog.clear();
+    logging = false;
+    beamTransitions = 0;
+    beamFilter.resetStats();
+    dhtReadings = 0;
+    lastTemperature = 0;
+    analogSum = 0;
+    analogReadings = 0;
+}
+
+static double threadCpuNs() {
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+void setUp() {
+    static const uint8_t frame[5] = {0x01, 0x9F, 0x00, 0xEA, 0x8A};
+    captureFrame(frame);
+    resetMocks();
+}
+
+void tearDown() {}
+
+void test_disabled_sensors_are_dropped() {
+    static_assert(MockSensors::count() == 3, "DisabledSensor entries must not count");
+    static_assert(SensorRegistry<DisabledSensor, DisabledSensor>::count() == 0, "all disabled");
+    TEST_ASSERT_EQUAL_UINT32(3, MockSensors::count());
+}
+
+void test_init_and_sample_run_in_list_order() {
+    logging = true;
+    MockSensors::initAll();
+    MockSensors::sampleAll();
+    TEST_ASSERT_EQUAL_STRING("beam:init dht22:init analog:init beam:sample dht22:sample analog:sample ",
+                             callLog.c_str());
+}
+
+// One scheduler job per sensor, at the sensor's own period
+void test_register_jobs_uses_each_period() {
+    Scheduler scheduler(virtualClock, virtualSleep);
+    MockSensors::registerJobs(scheduler);
+    TEST_ASSERT_EQUAL(3, scheduler.getJobCount());
+    TEST_ASSERT_EQUAL_STRING("beam", scheduler.getJob(0)->name);
+    TEST_ASSERT_EQUAL_UINT32(BEAM_DRAIN_INTERVAL_US, scheduler.getJob(0)->periodUs);
+    TEST_ASSERT_EQUAL_STRING("dht22", scheduler.getJob(1)->name);
+    TEST_ASSERT_EQUAL_STRING("analog", scheduler.getJob(2)->name);
+    TEST_ASSERT_EQUAL_UINT32(ENV_SENSOR_READ_INTERVAL * 1000UL, scheduler.getJob(2)->periodUs);
+
+    MockSensors::initAll();
+    while (virtualNowUs <= 10000000) {
+        scheduler.runOnce();
+    }
+    TEST_ASSERT_EQUAL_UINT32(10000, scheduler.getJob(0)->stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(5, scheduler.getJob(2)->stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(6, dhtReadings);      // On the first poll, then every 2 s
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 23.4f, lastTemperature);
+    TEST_ASSERT_EQUAL_UINT32(5, beamTransitions);  // In at 0, 5 and 10 s, out at 2.5 and 7.5 s
+}
+
+struct PassTimes {
+    double totalNs;
+    double maxSecondNs;         // Slowest virtual second of passes
+};
+
+// 1 ms read passes, timed on the thread's CPU clock a virtual second at a
+// time: reading the clock costs about as much as a pass
+static const uint32_t PASSES_PER_SECOND = 1000000 / BEAM_DRAIN_INTERVAL_US;
+
+static PassTimes runPasses(void (*pass)(), uint32_t seconds) {
+    PassTimes times = {0, 0};
+    MockSensors::initAll();
+    for (uint32_t second = 0; second < seconds; second++) {
+        double start = threadCpuNs();
+        for (uint32_t i = 0; i < PASSES_PER_SECOND; i++, virtualNowUs += BEAM_DRAIN_INTERVAL_US) {
+            pass();
+        }
+        double ns = threadCpuNs() - start;
+        times.totalNs += ns;
+        if (ns > times.maxSecondNs) {
+            times.maxSecondNs = ns;
+        }
+    }
+    return times;
+}
+
+static SensorBase* virtualSensors[3];
+
+static void sampleVirtual() {
+    for (SensorBase* sensor : virtualSensors) {
+        sensor->sample();
+    }
+}
+
+// Benchmark: ten virtual minutes of registry read passes against the same
+// mocks behind virtual calls. Both must produce the same readings, and the
+// passes may take at most a tenth of the loop's time.
+void test_bench_read_pass() {
+    const uint32_t seconds = 600;
+    const uint32_t passes = seconds * PASSES_PER_SECOND;
+    PassTimes registry = runPasses(MockSensors::sampleAll, seconds);
+    uint32_t registryTransitions = beamTransitions, registryReadings = dhtReadings, registrySum = analogSum;
+
+    VirtualSensor<MockBeam> beam;
+    VirtualSensor<MockDht22> dht;
+    VirtualSensor<MockAnalog> analog;
+    virtualSensors[0] = &beam;
+    virtualSensors[1] = &dht;
+    virtualSensors[2] = &analog;
+    resetMocks();
+    PassTimes dispatched = runPasses(sampleVirtual, seconds);
+
+    printf("\n%-10s %8s %10s %12s %8s %8s\n", "dispatch", "passes", "ns/pass", "worst second", "changes", "frames");
+    printf("%-10s %8lu %10.1f %10.1fus %8lu %8lu\n", "registry", (unsigned long)passes, registry.totalNs / passes,
+           registry.maxSecondNs / 1000.0, (unsigned long)registryTransitions, (unsigned long)registryReadings);
+    printf("%-10s %8lu %10.1f %10.1fus %8lu %8lu\n", "virtual", (unsigned long)passes, dispatched.totalNs / passes,
+           dispatched.maxSecondNs / 1000.0, (unsigned long)beamTransitions, (unsigned long)dhtReadings);
+
+    TEST_ASSERT_EQUAL_UINT32(beamTransitions, registryTransitions);
+    TEST_ASSERT_EQUAL_UINT32(dhtReadings, registryReadings);
+    TEST_ASSERT_EQUAL_UINT32(analogSum, registrySum);
+    TEST_ASSERT_EQUAL_UINT32(240, registryTransitions);
+    TEST_ASSERT_EQUAL_UINT32(300, registryReadings);
+    TEST_ASSERT_LESS_THAN_UINT32(100000000, (uint32_t)registry.maxSecondNs);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_disabled_sensors_are_dropped);
+    RUN_TEST(test_init_and_sample_run_in_list_order);
+    RUN_TEST(test_register_jobs_uses_each_period);
+    RUN_TEST(test_bench_read_pass);
+    return UNITY_END();
+}
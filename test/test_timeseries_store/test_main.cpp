@@ -0,0 +1,190 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include "timeseries_store.h"
+
+// config.h is Arduino-only; keep in step with HISTORY_BUFFER_BYTES
+#define HISTORY_BUFFER_BYTES 98304
+#define SAMPLE_INTERVAL_S 10
+#define WEEK_SAMPLES (7 * 24 * 3600 / SAMPLE_INTERVAL_S)
+
+static uint8_t* memory;
+static TimeSeriesStore* store;
+
+void setUp() {
+    memory = new uint8_t[HISTORY_BUFFER_BYTES];
+    store = new TimeSeriesStore();
+    TEST_ASSERT_TRUE(store->begin(memory, HISTORY_BUFFER_BYTES));
+    srand(1);
+}
+
+void tearDown() {
+    delete store;
+    delete[] memory;
+}
+
+// Values in the DHT22's 0.1 resolution
+typedef void (*TraceFn)(uint32_t index, float* values);
+
+static void steadyTrace(uint32_t, float* values) {
+    values[0] = 21.5f;
+    values[1] = 45.0f;
+}
+
+// Indoor day: slow daily swing plus an occasional 0.1 flicker
+static void indoorTrace(uint32_t index, float* values) {
+    double day = index * SAMPLE_INTERVAL_S / 86400.0 * 2 * M_PI;
+    int flicker = rand() % 8 == 0 ? (rand() % 2 ? 1 : -1) : 0;
+    values[0] = (float)(lround(10 * (21.0 + 2.0 * sin(day)) + flicker) / 10.0);
+    values[1] = (float)(lround(10 * (48.0 - 6.0 * sin(day)) + flicker) / 10.0);
+}
+
+// Worst case: both series step +-0.1 on every sample
+static float walk[TS_SERIES_COUNT];
+static void randomWalkTrace(uint32_t index, float* values) {
+    if (index == 0) {
+        walk[0] = 21.0f;
+        walk[1] = 50.0f;
+    }
+    for (int i = 0; i < TS_SERIES_COUNT; i++) {
+        walk[i] = (float)(lround(walk[i] * 10 + (rand() % 2 ? 1 : -1)) / 10.0);
+        values[i] = walk[i];
+    }
+}
+
+static void appendTrace(TraceFn trace, uint32_t count, uint32_t startTime = 1000) {
+    TimeSeriesSample sample;
+    for (uint32_t i = 0; i < count; i++) {
+        sample.timestamp = startTime + i * SAMPLE_INTERVAL_S;
+        trace(i, sample.values);
+        TEST_ASSERT_TRUE(store->append(sample));
+    }
+}
+
+struct Collected {
+    std::vector<TimeSeriesSample> samples;
+};
+
+static bool collect(const TimeSeriesSample& sample, void* context) {
+    static_cast<Collected*>(context)->samples.push_back(sample);
+    return true;
+}
+
+static bool countOnly(const TimeSeriesSample&, void* context) {
+    (*static_cast<uint32_t*>(context))++;
+    return true;
+}
+
+void test_round_trip_is_exact_at_sensor_resolution() {
+    std::vector<TimeSeriesSample> written;
+    TimeSeriesSample sample;
+    uint32_t t = 50;
+    for (uint32_t i = 0; i < 5000; i++) {
+        // Irregular cadence: a missed reading now and then, one long gap
+        t += i == 2500 ? 86400 : (rand() % 10 == 0 ? 20 : 10);
+        sample.timestamp = t;
+        randomWalkTrace(i, sample.values);
+        if (i % 97 == 0) {
+            sample.values[0] = -40.0f;  // Sensor limits
+            sample.values[1] = 100.0f;
+        }
+        TEST_ASSERT_TRUE(store->append(sample));
+        written.push_back(sample);
+    }
+
+    Collected out;
+    TEST_ASSERT_EQUAL_UINT32(written.size(), store->query(0, 0xFFFFFFFFUL, collect, &out));
+    for (size_t i = 0; i < written.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(written[i].timestamp, out.samples[i].timestamp);
+        TEST_ASSERT_FLOAT_WITHIN(0.001, written[i].values[0], out.samples[i].values[0]);
+        TEST_ASSERT_FLOAT_WITHIN(0.001, written[i].values[1], out.samples[i].values[1]);
+    }
+}
+
+void test_query_range_is_inclusive() {
+    appendTrace(steadyTrace, 1000);
+    Collected out;
+    TEST_ASSERT_EQUAL_UINT32(11, store->query(2000, 2100, collect, &out));
+    TEST_ASSERT_EQUAL_UINT32(2000, out.samples.front().timestamp);
+    TEST_ASSERT_EQUAL_UINT32(2100, out.samples.back().timestamp);
+    TEST_ASSERT_EQUAL_UINT32(0, store->query(2100, 2000, collect, &out));
+}
+
+void test_timestamps_going_backwards_are_rejected() {
+    appendTrace(steadyTrace, 10);
+    TimeSeriesSample sample = {500, {20.0f, 40.0f}};
+    TEST_ASSERT_FALSE(store->append(sample));
+    TEST_ASSERT_EQUAL_UINT32(10, store->getStats().sampleCount);
+}
+
+void test_full_ring_evicts_oldest_blocks() {
+    appendTrace(randomWalkTrace, 3 * WEEK_SAMPLES);
+    TimeSeriesStats stats = store->getStats();
+    TEST_ASSERT_EQUAL_UINT32(stats.blockCount, stats.blocksInUse);
+    TEST_ASSERT_GREATER_THAN(0, stats.blocksEvicted);
+
+    uint32_t visited = 0;
+    store->query(0, 0xFFFFFFFFUL, countOnly, &visited);
+    TEST_ASSERT_EQUAL_UINT32(stats.sampleCount, visited);
+    TEST_ASSERT_EQUAL_UINT32(1000 + (3 * WEEK_SAMPLES - 1) * SAMPLE_INTERVAL_S, stats.newestTimestamp);
+}
+
+// The 96 KB PSRAM buffer must keep a week at 10 s even for the worst trace
+void test_week_of_worst_case_samples_is_retained() {
+    appendTrace(randomWalkTrace, WEEK_SAMPLES);
+    TimeSeriesStats stats = store->getStats();
+    TEST_ASSERT_EQUAL_UINT32(0, stats.blocksEvicted);
+    TEST_ASSERT_EQUAL_UINT32(WEEK_SAMPLES, stats.sampleCount);
+}
+
+// Benchmark: bytes per sample (two series + timestamp) and host
+// encode/decode throughput for each trace
+void test_bench_bytes_per_sample_and_throughput() {
+    struct {
+        const char* name;
+        TraceFn trace;
+    } traces[] = {
+        {"steady", steadyTrace},
+        {"indoor", indoorTrace},
+        {"random walk", randomWalkTrace},
+    };
+
+    printf("\n%-12s %10s %10s %12s %12s %10s\n", "trace", "bytes/smp", "smp/block", "encode/s", "decode/s",
+           "days@96KB");
+    for (auto& entry : traces) {
+        tearDown();
+        setUp();
+        auto start = std::chrono::steady_clock::now();
+        appendTrace(entry.trace, WEEK_SAMPLES);
+        double encodeS = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        uint32_t decoded = 0;
+        start = std::chrono::steady_clock::now();
+        const int rounds = 20;
+        for (int i = 0; i < rounds; i++) {
+            store->query(0, 0xFFFFFFFFUL, countOnly, &decoded);
+        }
+        double decodeS = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Whole blocks, headers included: what the buffer really costs
+        TimeSeriesStats stats = store->getStats();
+        double bytesPerSample = (double)stats.blocksInUse * TS_BLOCK_BYTES / stats.sampleCount;
+        double days = stats.blockCount * TS_BLOCK_BYTES / bytesPerSample * SAMPLE_INTERVAL_S / 86400.0;
+        printf("%-12s %10.2f %10.0f %12.0f %12.0f %10.1f\n", entry.name, bytesPerSample,
+               (double)stats.sampleCount / stats.blocksInUse, WEEK_SAMPLES / encodeS, decoded / decodeS, days);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip_is_exact_at_sensor_resolution);
+    RUN_TEST(test_query_range_is_inclusive);
+    RUN_TEST(test_timestamps_going_backwards_are_rejected);
+    RUN_TEST(test_full_ring_evicts_oldest_blocks);
+    RUN_TEST(test_week_of_worst_case_samples_is_retained);
+    RUN_TEST(test_bench_bytes_per_sample_and_throughput);
+    return UNITY_END();
+}
@@ -0,0 +1,233 @@
+#include <unity.h>
+#include <stdio.h>
+#include <time.h>
+#include <vector>
+#include "wifi_link.h"
+
+// wifi_config.h defaults; keep in step
+#define WIFI_CONNECT_TIMEOUT 10000
+#define WIFI_BACKOFF_MIN_MS 1000
+#define WIFI_BACKOFF_MAX_MS 60000
+
+// Scripted fake driver. The access point's behaviour changes over virtual
+// time; connect() and disconnect() return at once, as WiFi.begin() and
+// WiFi.disconnect() do, and the outcome arrives later as an event, as from
+// the WiFi event task.
+enum ApBehaviour {
+    AP_UP,          // Attempts get an IP after ASSOCIATE_MS
+    AP_REJECTS,     // Attempts fail with a disconnect after REJECT_MS
+    AP_SILENT       // Attempts hear nothing and time out
+};
+
+struct ScriptStep {
+    uint32_t untilMs;
+    ApBehaviour ap;
+};
+
+static const uint32_t ASSOCIATE_MS = 2500;
+static const uint32_t REJECT_MS = 1500;
+static const uint32_t ABANDON_EVENT_MS = 50;   // Disconnect event after WiFi.disconnect()
+
+static const ScriptStep* script;
+static size_t scriptLength;
+static uint32_t virtualNowMs;
+static WiFiLinkEvent dueEvent;
+static uint32_t dueMs;
+static bool linkUp;
+static uint32_t disconnectCalls;
+static std::vector<uint32_t> attemptStarts;
+static WiFiLink* wifiLink;
+
+static const WiFiLinkConfig linkConfig = {WIFI_CONNECT_TIMEOUT, WIFI_BACKOFF_MIN_MS, WIFI_BACKOFF_MAX_MS};
+
+static uint32_t virtualClock() {
+    return virtualNowMs;
+}
+
+static ApBehaviour apAt(uint32_t now) {
+    for (size_t i = 0; i < scriptLength; i++) {
+        if (now < script[i].untilMs) {
+            return script[i].ap;
+        }
+    }
+    return script[scriptLength - 1].ap;
+}
+
+static void schedule(WiFiLinkEvent event, uint32_t afterMs) {
+    dueEvent = event;
+    dueMs = virtualNowMs + afterMs;
+}
+
+static void fakeConnect(uint32_t) {
+    attemptStarts.push_back(virtualNowMs);
+    linkUp = false;
+    switch (apAt(virtualNowMs)) {
+        case AP_UP: schedule(WIFI_LINK_EVENT_GOT_IP, ASSOCIATE_MS); break;
+        case AP_REJECTS: schedule(WIFI_LINK_EVENT_DISCONNECTED, REJECT_MS); break;
+        case AP_SILENT: dueEvent = WIFI_LINK_EVENT_NONE; break;
+    }
+}
+
+static void fakeDisconnect() {
+    disconnectCalls++;
+    linkUp = false;
+    schedule(WIFI_LINK_EVENT_DISCONNECTED, ABANDON_EVENT_MS);
+}
+
+// The event task: deliver the scheduled outcome, and drop the link when
+// the access point goes away
+static void runDriver() {
+    if (dueEvent != WIFI_LINK_EVENT_NONE && (int32_t)(virtualNowMs - dueMs) >= 0) {
+        linkUp = dueEvent == WIFI_LINK_EVENT_GOT_IP;
+        wifiLink->postEvent(dueEvent);
+        dueEvent = WIFI_LINK_EVENT_NONE;
+    }
+    if (linkUp && apAt(virtualNowMs) != AP_UP) {
+        linkUp = false;
+        wifiLink->postEvent(WIFI_LINK_EVENT_DISCONNECTED);
+    }
+}
+
+struct PollTimes {
+    uint32_t polls;
+    double totalNs;
+    double maxNs;
+};
+
+static double threadCpuNs() {
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+// The WiFi job polls once per virtual millisecond. Each poll is timed on
+// the thread's CPU clock, so the host preempting the test does not count.
+static void runFor(uint32_t durationMs, PollTimes* times = nullptr) {
+    for (uint32_t end = virtualNowMs + durationMs; virtualNowMs != end; virtualNowMs++) {
+        runDriver();
+        double start = threadCpuNs();
+        wifiLink->poll();
+        double ns = threadCpuNs() - start;
+        if (times) {
+            times->polls++;
+            times->totalNs += ns;
+            if (ns > times->maxNs) {
+                times->maxNs = ns;
+            }
+        }
+    }
+}
+
+static void startScript(const ScriptStep* steps, size_t count) {
+    script = steps;
+    scriptLength = count;
+    wifiLink->start();
+}
+
+void setUp() {
+    virtualNowMs = 0;
+    dueEvent = WIFI_LINK_EVENT_NONE;
+    linkUp = false;
+    disconnectCalls = 0;
+    attemptStarts.clear();
+    wifiLink = new WiFiLink(virtualClock, fakeConnect, fakeDisconnect, linkConfig);
+}
+
+void tearDown() {
+    delete wifiLink;
+}
+
+void test_first_attempt_connects() {
+    static const ScriptStep steps[] = {{0, AP_UP}};
+    startScript(steps, 1);
+    TEST_ASSERT_EQUAL(WIFI_LINK_ASSOCIATING, wifiLink->getState());
+    runFor(ASSOCIATE_MS + 1);
+    TEST_ASSERT_TRUE(wifiLink->isConnected());
+    TEST_ASSERT_EQUAL_UINT32(1, wifiLink->getStats().attempts);
+    TEST_ASSERT_EQUAL_UINT32(1, wifiLink->getStats().connects);
+}
+
+// Silent AP: every attempt runs the full timeout, then the wait doubles
+// from backoffMinMs up to backoffMaxMs
+void test_silent_ap_times_out_with_doubling_backoff() {
+    static const ScriptStep steps[] = {{0, AP_SILENT}};
+    startScript(steps, 1);
+    runFor(10 * 60 * 1000);
+
+    uint32_t backoff = WIFI_BACKOFF_MIN_MS;
+    for (size_t i = 1; i < attemptStarts.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(WIFI_CONNECT_TIMEOUT + backoff, attemptStarts[i] - attemptStarts[i - 1]);
+        backoff = backoff * 2 > WIFI_BACKOFF_MAX_MS ? WIFI_BACKOFF_MAX_MS : backoff * 2;
+    }
+    WiFiLinkStats stats = wifiLink->getStats();
+    TEST_ASSERT_EQUAL_UINT32(attemptStarts.size(), stats.attempts);
+    TEST_ASSERT_EQUAL_UINT32(disconnectCalls, stats.timeouts);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.connects);
+}
+
+// The disconnect event that follows an abandoned attempt arrives during
+// the backoff and must not fail the next attempt
+void test_abandoned_attempt_event_does_not_fail_the_next() {
+    static const ScriptStep steps[] = {{WIFI_CONNECT_TIMEOUT, AP_SILENT}, {0, AP_UP}};
+    startScript(steps, 2);
+    runFor(WIFI_CONNECT_TIMEOUT + WIFI_BACKOFF_MIN_MS + ASSOCIATE_MS + 1);
+    TEST_ASSERT_TRUE(wifiLink->isConnected());
+    TEST_ASSERT_EQUAL_UINT32(2, wifiLink->getStats().attempts);
+    TEST_ASSERT_EQUAL_UINT32(1, wifiLink->getStats().timeouts);
+}
+
+// A lost link starts a new attempt at once, without a backoff
+void test_lost_link_reconnects_at_once() {
+    static const ScriptStep steps[] = {{20000, AP_UP}, {25000, AP_REJECTS}, {0, AP_UP}};
+    startScript(steps, 3);
+    runFor(20000);
+    TEST_ASSERT_TRUE(wifiLink->isConnected());
+    runFor(1);
+    TEST_ASSERT_EQUAL(WIFI_LINK_ASSOCIATING, wifiLink->getState());
+    TEST_ASSERT_EQUAL_UINT32(20000, attemptStarts.back());
+
+    runFor(30000);
+    WiFiLinkStats stats = wifiLink->getStats();
+    TEST_ASSERT_TRUE(wifiLink->isConnected());
+    TEST_ASSERT_EQUAL_UINT32(1, stats.disconnects);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.connects);
+    TEST_ASSERT_EQUAL_UINT8(0, stats.failures);
+}
+
+// Benchmark: an hour of virtual time with a flapping, silent and
+// rejecting AP. No poll may hold up the loop for a millisecond.
+void test_bench_outage_never_stalls_the_loop() {
+    static const ScriptStep steps[] = {
+        {5 * 60000, AP_UP},
+        {25 * 60000, AP_SILENT},
+        {26 * 60000, AP_UP},
+        {27 * 60000, AP_REJECTS},
+        {28 * 60000, AP_UP},
+        {40 * 60000, AP_REJECTS},
+        {0, AP_UP},
+    };
+    startScript(steps, sizeof(steps) / sizeof(steps[0]));
+    PollTimes times = {};
+    runFor(60 * 60000, &times);
+
+    WiFiLinkStats stats = wifiLink->getStats();
+    printf("\n%8s %8s %8s %8s %8s %10s %10s\n", "polls", "attempts", "connects", "drops", "timeouts", "ns/poll",
+           "max poll");
+    printf("%8lu %8lu %8lu %8lu %8lu %10.1f %8.1fus\n", (unsigned long)times.polls, (unsigned long)stats.attempts,
+           (unsigned long)stats.connects, (unsigned long)stats.disconnects, (unsigned long)stats.timeouts,
+           times.totalNs / times.polls, times.maxNs / 1000.0);
+
+    TEST_ASSERT_TRUE(wifiLink->isConnected());
+    TEST_ASSERT_GREATER_THAN(0, stats.timeouts);
+    TEST_ASSERT_LESS_THAN_UINT32(1000000, (uint32_t)times.maxNs);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_attempt_connects);
+    RUN_TEST(test_silent_ap_times_out_with_doubling_backoff);
+    RUN_TEST(test_abandoned_attempt_event_does_not_fail_the_next);
+    RUN_TEST(test_lost_link_reconnects_at_once);
+    RUN_TEST(test_bench_outage_never_stalls_the_loop);
+    return UNITY_END();
+}
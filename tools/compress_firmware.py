@@ -0,0 +1,49 @@
+"""Prepare compressed OTA release assets from a firmware image.
+
+Writes next to the input (or into --out):
+
+    firmware.bin.gz          gzip -9 of the image, as the device inflates it
+    firmware.bin.gz.sha256   SHA-256 of the decompressed image
+    firmware.bin.sha256      the same digest, so plain installs are verified too
+
+Upload all three with the release; the device prefers the .bin.gz asset.
+The digest is over the decompressed image because that is what ends up in
+flash. Standard library only, e.g.
+
+    python tools/compress_firmware.py .pio/build/esp32-s3-devkitc-1/firmware.bin
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("image")
+    parser.add_argument("--out", help="output directory (default: next to the image)")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as f:
+        image = f.read()
+    name = os.path.basename(args.image)
+    out = args.out or os.path.dirname(os.path.abspath(args.image))
+    os.makedirs(out, exist_ok=True)
+
+    # mtime=0 so the same image always gives the same asset
+    compressed = gzip.compress(image, compresslevel=9, mtime=0)
+    line = "%s  %s\n" % (hashlib.sha256(image).hexdigest(), name)
+
+    with open(os.path.join(out, name + ".gz"), "wb") as f:
+        f.write(compressed)
+    for sidecar in (name + ".gz.sha256", name + ".sha256"):
+        with open(os.path.join(out, sidecar), "w") as f:
+            f.write(line)
+
+    print("%s: %d bytes -> %s.gz: %d bytes (%.0f%%)" % (
+        name, len(image), name, len(compressed), 100.0 * len(compressed) / len(image)))
+
+
+if __name__ == "__main__":
+    main()
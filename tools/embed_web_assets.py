@@ -0,0 +1,69 @@
+"""Compress web/ assets into a C header served straight from flash.
+
+Runs as a PlatformIO pre-build script (extra_scripts in platformio.ini) and
+can also be run by hand: python tools/embed_web_assets.py
+
+For each asset the header gets the gzip bytes, their length and a strong
+ETag derived from the content hash. The header is only rewritten when its
+content changes, so unchanged assets do not trigger a rebuild.
+"""
+
+import gzip
+import hashlib
+import os
+
+ASSETS = [
+    # (source under web/, C identifier prefix)
+    ("dashboard.html", "DASHBOARD_HTML"),
+]
+OUTPUT = os.path.join("include", "web_assets.h")
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def render_asset(name, prefix):
+    with open(os.path.join(PROJECT_DIR, "web", name), "rb") as source:
+        raw = source.read()
+    # mtime=0 keeps the output (and so the ETag) reproducible
+    compressed = gzip.compress(raw, compresslevel=9, mtime=0)
+    etag = hashlib.sha256(raw).hexdigest()[:16]
+
+    lines = [
+        "// web/%s: %d bytes, %d gzipped" % (name, len(raw), len(compressed)),
+        '#define %s_ETAG "\\"%s\\""' % (prefix, etag),
+        "#define %s_GZ_LENGTH %d" % (prefix, len(compressed)),
+        "static const uint8_t %s_GZ[] PROGMEM = {" % prefix,
+    ]
+    for offset in range(0, len(compressed), 16):
+        chunk = compressed[offset:offset + 16]
+        lines.append("    " + ", ".join("0x%02x" % byte for byte in chunk) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def main():
+    body = "\n\n".join(render_asset(name, prefix) for name, prefix in ASSETS)
+    header = (
+        "// Generated by tools/embed_web_assets.py from web/ - do not edit\n"
+        "#ifndef WEB_ASSETS_H\n"
+        "#define WEB_ASSETS_H\n\n"
+        "#include <Arduino.h>\n\n"
+        + body +
+        "\n\n#endif // WEB_ASSETS_H\n"
+    )
+
+    path = os.path.join(PROJECT_DIR, OUTPUT)
+    if os.path.exists(path):
+        with open(path) as existing:
+            if existing.read() == header:
+                return
+    with open(path, "w") as output:
+        output.write(header)
+    print("Generated %s" % OUTPUT)
+
+
+main()
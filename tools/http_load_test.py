@@ -0,0 +1,96 @@
+"""Measure web server latency under concurrent keep-alive clients.
+
+Each client is a thread with one persistent HTTP/1.1 connection that sends
+requests back to back for the test duration. Reports per-request latency
+percentiles at each concurrency level, e.g.
+
+    python tools/http_load_test.py 192.168.1.50
+    python tools/http_load_test.py 192.168.1.50 --path /api/beam/stats --clients 1 10 50
+
+More clients than HTTP_MAX_CONNECTIONS wait in the listen backlog, and
+beyond that their connection attempts are retried by TCP, so the higher
+levels mostly show queueing in p99/max. Standard library only.
+"""
+
+import argparse
+import http.client
+import threading
+import time
+
+
+def run_client(host, port, path, deadline, latencies, errors, lock):
+    connection = None
+    local = []
+    failures = 0
+    while time.monotonic() < deadline:
+        try:
+            if connection is None:
+                connection = http.client.HTTPConnection(host, port, timeout=10)
+            start = time.monotonic()
+            connection.request("GET", path)
+            response = connection.getresponse()
+            response.read()
+            local.append(time.monotonic() - start)
+            if response.status >= 400:
+                failures += 1
+            if response.getheader("Connection", "").lower() == "close":
+                connection.close()
+                connection = None
+        except (OSError, http.client.HTTPException):
+            failures += 1
+            if connection is not None:
+                connection.close()
+            connection = None
+            time.sleep(0.05)
+    if connection is not None:
+        connection.close()
+    with lock:
+        latencies.extend(local)
+        errors[0] += failures
+
+
+def percentile(values, fraction):
+    if not values:
+        return float("nan")
+    index = min(len(values) - 1, int(round(fraction * (len(values) - 1))))
+    return values[index]
+
+
+def run_level(host, port, path, clients, duration):
+    latencies = []
+    errors = [0]
+    lock = threading.Lock()
+    deadline = time.monotonic() + duration
+    threads = [
+        threading.Thread(target=run_client, args=(host, port, path, deadline, latencies, errors, lock))
+        for _ in range(clients)
+    ]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    latencies.sort()
+    ms = lambda seconds: seconds * 1000.0  # noqa: E731
+    print("%4d clients  %6d req  %7.1f req/s  p50 %7.1f ms  p99 %7.1f ms  max %7.1f ms  errors %d" % (
+        clients, len(latencies), len(latencies) / duration,
+        ms(percentile(latencies, 0.50)), ms(percentile(latencies, 0.99)),
+        ms(latencies[-1]) if latencies else float("nan"), errors[0]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--path", default="/api/status")
+    parser.add_argument("--clients", type=int, nargs="+", default=[1, 10, 50])
+    parser.add_argument("--duration", type=float, default=10.0, help="seconds per level")
+    args = parser.parse_args()
+
+    print("GET http://%s:%d%s, %.0f s per level" % (args.host, args.port, args.path, args.duration))
+    for clients in args.clients:
+        run_level(args.host, args.port, args.path, clients, args.duration)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,186 @@
+"""Create and verify delta OTA images between two firmware releases.
+
+A delta image is a gzip-compressed, bsdiff-style patch that the device
+applies against its running firmware while it streams into the inactive
+OTA partition (format in include/ota_image.h). Only the exact source
+image can be patched; the device falls back to the full image otherwise.
+
+    # Patch from the previous release, with its .sha256 (of the new image)
+    python tools/ota_delta.py diff v1.0.0.bin firmware.bin --from-version v1.0.0
+
+    # Rebuild the new image from the old one and the patch, as the device does
+    python tools/ota_delta.py apply v1.0.0.bin firmware-v1.0.0.patch.gz -o rebuilt.bin
+
+`diff` writes firmware-<from-version>.patch.gz and its .sha256 next to the
+new image (or into --out), verifies the patch by applying it, and prints
+the transfer size of the full, compressed and delta images.
+Standard library only.
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import struct
+
+MAGIC = b"GDPATCH1"
+HEADER = struct.Struct("<8sI32sI")
+RECORD = struct.Struct("<IIi")
+
+BLOCK = 16          # Bytes that must match exactly to start a region
+INDEX_STEP = 4      # Index every 4th source position; matches are found within 3 bytes
+MIN_REGION = 32     # Shorter matches are cheaper as extra bytes
+LOOKAHEAD = 128     # Stop extending after this many bytes without improvement
+
+
+def build_index(old):
+    index = {}
+    for i in range(0, len(old) - BLOCK + 1, INDEX_STEP):
+        index.setdefault(old[i:i + BLOCK], i)
+    return index
+
+
+def extend(old, new, i, j):
+    """Length of the diff region from old[i] / new[j] that scores best.
+
+    Like bsdiff, mismatches are allowed inside a region (they become
+    non-zero diff bytes, typically shifted addresses), as long as at least
+    half the bytes still match.
+    """
+    best_length = 0
+    best_score = 0
+    score = 0
+    length = 0
+    limit = min(len(old) - i, len(new) - j)
+    while length < limit and length - best_length <= LOOKAHEAD:
+        score += 1 if old[i + length] == new[j + length] else -1
+        length += 1
+        if score > best_score:
+            best_score = score
+            best_length = length
+    return best_length
+
+
+def diff(old, new):
+    index = build_index(old)
+    records = []
+    # Current diff region: source start, target start, length
+    region_src, region_new, region_len = 0, 0, 0
+    j = 0
+    while j <= len(new) - BLOCK:
+        # Prefer continuing where the source left off, then any match
+        expected = region_src + (j - region_new)
+        i = None
+        if 0 <= expected <= len(old) - BLOCK and old[expected:expected + BLOCK] == new[j:j + BLOCK]:
+            i = expected
+        else:
+            i = index.get(new[j:j + BLOCK])
+        if i is None:
+            j += 1
+            continue
+        length = extend(old, new, i, j)
+        if length < MIN_REGION:
+            j += 1
+            continue
+        extra_start = region_new + region_len
+        records.append((region_src, region_new, region_len, new[extra_start:j], i - (region_src + region_len)))
+        region_src, region_new, region_len = i, j, length
+        j += length
+    records.append((region_src, region_new, region_len, new[region_new + region_len:], 0))
+
+    out = [HEADER.pack(MAGIC, len(old), hashlib.sha256(old).digest(), len(new))]
+    for src, start, length, extra, seek in records:
+        out.append(RECORD.pack(length, len(extra), seek))
+        out.append(bytes((n - o) & 0xFF for n, o in zip(new[start:start + length], old[src:src + length])))
+        out.append(extra)
+    return b"".join(out)
+
+
+def apply(old, patch):
+    """Rebuild the target exactly as OTAImageWriter does; raises on error."""
+    magic, source_size, source_sha, target_size = HEADER.unpack_from(patch, 0)
+    if magic != MAGIC:
+        raise ValueError("not a delta image")
+    if source_size > len(old) or hashlib.sha256(old[:source_size]).digest() != source_sha:
+        raise ValueError("delta image is for different firmware")
+    out = bytearray()
+    pos = HEADER.size
+    source_pos = 0
+    while len(out) < target_size:
+        diff_length, extra_length, seek = RECORD.unpack_from(patch, pos)
+        pos += RECORD.size
+        if len(out) + diff_length + extra_length > target_size:
+            raise ValueError("delta image is larger than its target")
+        if source_pos < 0 or source_pos + diff_length > source_size:
+            raise ValueError("delta image reads outside its source")
+        out += bytes((d + o) & 0xFF for d, o in zip(patch[pos:pos + diff_length],
+                                                     old[source_pos:source_pos + diff_length]))
+        pos += diff_length
+        source_pos += diff_length
+        out += patch[pos:pos + extra_length]
+        pos += extra_length
+        source_pos += seek
+    if pos != len(patch):
+        raise ValueError("unexpected data after delta image")
+    return bytes(out)
+
+
+def read(path):
+    with open(path, "rb") as f:
+        return f.read()
+
+
+def command_diff(args):
+    old = read(args.old)
+    new = read(args.new)
+    patch = diff(old, new)
+    if apply(old, patch) != new:
+        raise SystemExit("patch does not rebuild the new image")
+
+    name = "firmware-%s.patch.gz" % args.from_version
+    out = args.out or os.path.dirname(os.path.abspath(args.new))
+    os.makedirs(out, exist_ok=True)
+    compressed = gzip.compress(patch, compresslevel=9, mtime=0)
+    with open(os.path.join(out, name), "wb") as f:
+        f.write(compressed)
+    with open(os.path.join(out, name + ".sha256"), "w") as f:
+        f.write("%s  %s\n" % (hashlib.sha256(new).hexdigest(), os.path.basename(args.new)))
+
+    full_gz = len(gzip.compress(new, compresslevel=9, mtime=0))
+    print("full image     %8d bytes" % len(new))
+    print("full, gzip     %8d bytes (%.1f%%)" % (full_gz, 100.0 * full_gz / len(new)))
+    print("delta, gzip    %8d bytes (%.1f%%)  %s" % (len(compressed), 100.0 * len(compressed) / len(new), name))
+
+
+def command_apply(args):
+    old = read(args.old)
+    patch = gzip.decompress(read(args.patch))
+    new = apply(old, patch)
+    with open(args.output, "wb") as f:
+        f.write(new)
+    print("%s: %d bytes, sha256 %s" % (args.output, len(new), hashlib.sha256(new).hexdigest()))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    diff_parser = commands.add_parser("diff", help="create a delta image")
+    diff_parser.add_argument("old", help="image the devices are running")
+    diff_parser.add_argument("new", help="image to update them to")
+    diff_parser.add_argument("--from-version", required=True, help="FIRMWARE_VERSION of the old image, e.g. v1.0.0")
+    diff_parser.add_argument("--out", help="output directory (default: next to the new image)")
+    diff_parser.set_defaults(run=command_diff)
+
+    apply_parser = commands.add_parser("apply", help="apply a delta image")
+    apply_parser.add_argument("old")
+    apply_parser.add_argument("patch")
+    apply_parser.add_argument("-o", "--output", required=True)
+    apply_parser.set_defaults(run=command_apply)
+
+    args = parser.parse_args()
+    args.run(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,254 @@
+"""Serve a GitHub-style releases/latest response for testing the OTA check.
+
+The body mimics a real release: long markdown notes and several assets,
+each with full uploader metadata, so it is tens of KB like the real API.
+Build the firmware with the check pointed here, e.g.
+
+    python tools/ota_release_fixture.py --tag v9.9.9 --notes-kb 32
+    build_flags = -DOTA_UPDATE_URL=\\"http://192.168.1.10:8000/releases/latest\\"
+
+The device logs the read time and document heap of each check at debug
+level. On startup this prints the body size next to the size of the
+fields the filtered parse keeps, which is what the device has to hold.
+
+Like GitHub, responses carry an ETag and X-RateLimit-Remaining, a matching
+If-None-Match gets an empty 304 that does not use up the limit, and an
+exhausted limit gets a 403 with Retry-After. Compare the served counts
+printed per request with the device's /api/ota/status "checks" or
+/metrics.
+
+With --firmware-dir the assets themselves are served too, so a plain and
+a compressed install (tools/compress_firmware.py) can be timed end to
+end; point --base-url at this server. Asset downloads honour
+"Range: bytes=N-" with a 206, and --drop-rate cuts that share of them off
+at a random point, to check that an install resumes instead of starting
+over. The time from the first request for an asset to its last byte is
+printed once it completes. That is when the last byte was handed to the
+socket, so over loopback or a fast LAN, where the socket buffers can take
+the whole image at once, pace the assets with --rate-kbps; the device log
+has the time to the verified image. Standard library only.
+"""
+
+import argparse
+import hashlib
+import http.server
+import json
+import os
+import random
+import re
+import threading
+import time
+
+ASSET_NAMES = [
+    "firmware.bin",
+    "firmware.bin.sha256",
+    "firmware.bin.gz",
+    "firmware.bin.gz.sha256",
+    "firmware.elf",
+    "bootloader.bin",
+    "partitions.bin",
+    "spiffs.bin",
+    "Source code (zip)",
+]
+
+
+def user(login):
+    return {
+        "login": login,
+        "id": 1234567,
+        "node_id": "MDQ6VXNlcjEyMzQ1Njc=",
+        "avatar_url": "https://avatars.githubusercontent.com/u/1234567?v=4",
+        "gravatar_id": "",
+        "url": "https://api.github.com/users/" + login,
+        "html_url": "https://github.com/" + login,
+        "followers_url": "https://api.github.com/users/%s/followers" % login,
+        "repos_url": "https://api.github.com/users/%s/repos" % login,
+        "type": "User",
+        "site_admin": False,
+    }
+
+
+def build_release(tag, notes_kb, base_url):
+    line = "- Fixed an issue where the beam sensor reported a stale state after reconnecting\n"
+    notes = "## Changes\n" + line * max(1, notes_kb * 1024 // len(line))
+    assets = []
+    for index, name in enumerate(ASSET_NAMES):
+        assets.append({
+            "url": "https://api.github.com/repos/example/releases/assets/%d" % (1000 + index),
+            "id": 1000 + index,
+            "node_id": "RA_kwDOJ%08d" % index,
+            "name": name,
+            "label": "",
+            "uploader": user("release-bot"),
+            "content_type": "application/octet-stream",
+            "state": "uploaded",
+            "size": 1048576 + index,
+            "download_count": 42,
+            "created_at": "2025-01-01T00:00:00Z",
+            "updated_at": "2025-01-01T00:00:00Z",
+            "browser_download_url": "%s/download/%s/%s" % (base_url, tag, name),
+        })
+    return {
+        "url": "https://api.github.com/repos/example/releases/1",
+        "html_url": "https://github.com/example/releases/tag/" + tag,
+        "id": 1,
+        "author": user("maintainer"),
+        "tag_name": tag,
+        "target_commitish": "main",
+        "name": tag,
+        "draft": False,
+        "prerelease": False,
+        "created_at": "2025-01-01T00:00:00Z",
+        "published_at": "2025-01-01T00:00:00Z",
+        "assets": assets,
+        "body": notes,
+    }
+
+
+def filtered(release):
+    # Same fields as the filter in OTAManager::checkForUpdate()
+    return {
+        "tag_name": release["tag_name"],
+        "assets": [{"name": a["name"], "browser_download_url": a["browser_download_url"]}
+                   for a in release["assets"]],
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", type=int, default=8000)
+    parser.add_argument("--tag", default="v9.9.9")
+    parser.add_argument("--notes-kb", type=int, default=32, help="size of the release notes")
+    parser.add_argument("--base-url", default="http://example.invalid",
+                        help="prefix for asset download URLs")
+    parser.add_argument("--rate-limit", type=int, default=60,
+                        help="full responses allowed per --rate-window, like unauthenticated GitHub")
+    parser.add_argument("--rate-window", type=float, default=3600.0, help="seconds")
+    parser.add_argument("--firmware-dir", help="serve release assets from this directory")
+    parser.add_argument("--drop-rate", type=float, default=0.0,
+                        help="share of asset downloads to cut off part way (0-1)")
+    parser.add_argument("--rate-kbps", type=float, default=0.0,
+                        help="pace asset downloads to this many KB/s (0: as fast as the client reads)")
+    args = parser.parse_args()
+
+    release = build_release(args.tag, args.notes_kb, args.base_url)
+    body = json.dumps(release, indent=2).encode()
+    kept = len(json.dumps(filtered(release), separators=(",", ":")))
+    print("release body %d bytes, filtered fields %d bytes (%.0fx smaller)" % (
+        len(body), kept, len(body) / kept))
+
+    etag = '"%s"' % hashlib.sha1(body).hexdigest()
+    lock = threading.Lock()
+    counts = {"ok": 0, "not_modified": 0, "limited": 0}
+    window = {"start": time.monotonic(), "used": 0}
+    downloads = {}  # Asset name -> [first request time, requests]
+
+    class Handler(http.server.BaseHTTPRequestHandler):
+        def do_GET(self):
+            if self.path.startswith("/download/") and args.firmware_dir:
+                self.send_asset(os.path.basename(self.path))
+                return
+            if not self.path.startswith("/releases/latest"):
+                self.send_error(404)
+                return
+            start = time.monotonic()
+            with lock:
+                if start - window["start"] >= args.rate_window:
+                    window["start"] = start
+                    window["used"] = 0
+                remaining = args.rate_limit - window["used"]
+                reset_in = int(window["start"] + args.rate_window - start) + 1
+                if self.headers.get("If-None-Match") == etag:
+                    outcome = "not_modified"
+                elif remaining <= 0:
+                    outcome = "limited"
+                else:
+                    outcome = "ok"
+                    window["used"] += 1
+                    remaining -= 1
+                counts[outcome] += 1
+
+            if outcome == "not_modified":
+                self.send_response(304)
+            elif outcome == "limited":
+                self.send_response(403)
+                self.send_header("Retry-After", str(reset_in))
+                self.send_header("Content-Length", "0")
+            else:
+                self.send_response(200)
+                self.send_header("Content-Type", "application/json; charset=utf-8")
+                self.send_header("Content-Length", str(len(body)))
+            self.send_header("ETag", etag)
+            self.send_header("X-RateLimit-Limit", str(args.rate_limit))
+            self.send_header("X-RateLimit-Remaining", str(max(0, remaining)))
+            self.end_headers()
+            if outcome == "ok":
+                self.wfile.write(body)
+            self.log_message("%s in %.1f ms (200: %d, 304: %d, 403: %d)", outcome,
+                             (time.monotonic() - start) * 1000,
+                             counts["ok"], counts["not_modified"], counts["limited"])
+
+        def send_asset(self, name):
+            path = os.path.join(args.firmware_dir, name)
+            if not os.path.isfile(path):
+                self.send_error(404)
+                return
+            with open(path, "rb") as f:
+                data = f.read()
+            start = time.monotonic()
+            with lock:
+                download = downloads.setdefault(name, [start, 0])
+                download[1] += 1
+
+            offset = 0
+            match = re.fullmatch(r"bytes=(\d+)-", self.headers.get("Range", ""))
+            if match:
+                offset = int(match.group(1))
+                if offset >= len(data):
+                    self.send_response(416)
+                    self.send_header("Content-Range", "bytes */%d" % len(data))
+                    self.send_header("Content-Length", "0")
+                    self.end_headers()
+                    return
+                self.send_response(206)
+                self.send_header("Content-Range", "bytes %d-%d/%d" % (offset, len(data) - 1, len(data)))
+            else:
+                self.send_response(200)
+            self.send_header("Content-Type", "application/octet-stream")
+            self.send_header("Content-Length", str(len(data) - offset))
+            self.send_header("Accept-Ranges", "bytes")
+            self.end_headers()
+
+            end = len(data)
+            if random.random() < args.drop_rate:
+                end = random.randint(offset, len(data) - 1)
+            self.send_paced(data[offset:end])
+            if end < len(data):
+                self.close_connection = True
+                self.log_message("%s: dropped at %d/%d bytes", name, end, len(data))
+                return
+
+            self.log_message("%s: bytes %d-%d in %.1f s", name, offset, end - 1, time.monotonic() - start)
+            with lock:
+                first, requests = downloads.pop(name)
+            self.log_message("%s: complete %.1f s after the first request, %d requests",
+                             name, time.monotonic() - first, requests)
+
+        def send_paced(self, data):
+            if args.rate_kbps <= 0:
+                self.wfile.write(data)
+                return
+            step = 4096
+            start = time.monotonic()
+            for sent in range(0, len(data), step):
+                self.wfile.write(data[sent:sent + step])
+                delay = start + (sent + step) / (args.rate_kbps * 1024) - time.monotonic()
+                if delay > 0:
+                    time.sleep(delay)
+
+    print("serving http://0.0.0.0:%d/releases/latest" % args.port)
+    http.server.ThreadingHTTPServer(("", args.port), Handler).serve_forever()
+
+
+if __name__ == "__main__":
+    main()